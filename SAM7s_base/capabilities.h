@@ -12,6 +12,16 @@
 #define MAX_TRACKS				40
 #define MAX_SECTORS				20
 #define SCRIPT_MEMORY_LENGTH	10240
+#define PREDICTIVE_TIMER_SAMPLES	384
+//size of the REFLAP region in AT91SAM7S256-ROM.ld
+#define REFERENCE_LAP_FLASH_SIZE	2048
+//largest Lua arena, and the heap kept back from it for buffers allocated later
+#define LUA_ARENA_SIZE			24576
+#define LUA_HEAP_RESERVE		4096
+//no flash to spare for a compiled script
+#define SCRIPT_BYTECODE_LENGTH	0
+//most sample buffers the logger shares with its consumers; each holds every enabled channel
+#define LOGGER_MESSAGE_BUFFER_LIMIT	12
 #define MAX_VIRTUAL_CHANNELS	10
 
 //Input / output Channels
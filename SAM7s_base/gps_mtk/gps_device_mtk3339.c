@@ -1,6 +1,13 @@
 #include "gps_device.h"
+#include "loggerConfig.h"
 
-int GPS_device_provision(Serial *serial){
+int GPS_device_provision(Serial *serial, unsigned char *navFormat){
 	//nothing to provision, factory defaults are good
+	*navFormat = GPS_NAV_FORMAT_NMEA;
 	return 1;
 }
+
+int GPS_device_read_nav_data(Serial *serial, GpsNavData *nav){
+	//module only outputs NMEA
+	return 0;
+}
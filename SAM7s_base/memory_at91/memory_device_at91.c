@@ -52,9 +52,8 @@ int RAMFUNC flash_write(void * vAddress, void * vData){
 }
 
 int memory_device_flash_region(const void *address, const void *data, unsigned int length){
-	if (length < MEMORY_PAGE_SIZE) length = length + (MEMORY_PAGE_SIZE - length);
-
-	unsigned int pages = length / AT91C_IFLASH_PAGE_SIZE;
+	//a partly used last page is still written
+	unsigned int pages = (length + AT91C_IFLASH_PAGE_SIZE - 1) / AT91C_IFLASH_PAGE_SIZE;
 	for (unsigned int i = 0; i < pages; i++){
 		unsigned int offset = (i * AT91C_IFLASH_PAGE_SIZE);
 		if (flash_write((void *)((unsigned int)address + offset),(void *)((unsigned int)data + offset)) != 0 ){
@@ -157,6 +157,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id){
 			serial->get_line_wait = &usart0_readLineWait;
 			serial->put_c = &usart0_putchar;
 			serial->put_s = &usart0_puts;
+			serial->put_buf = &usart0_put_buf;
 			break;
 		case UART_GPS:
 			serial->init = &usart_device_init_1;
@@ -167,6 +168,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id){
 			serial->get_line_wait = &usart1_readLineWait;
 			serial->put_c = &usart1_putchar;
 			serial->put_s = &usart1_puts;
+			serial->put_buf = &usart1_put_buf;
 			break;
 		default:
 			rc = 0;
@@ -316,6 +318,16 @@ void usart1_puts (const char* s )
 	while ( *s ) usart1_putchar(*s++ );
 }
 
+void usart0_put_buf(const char *data, size_t length)
+{
+	while ( length-- ) usart0_putchar(*data++ );
+}
+
+void usart1_put_buf(const char *data, size_t length)
+{
+	while ( length-- ) usart1_putchar(*data++ );
+}
+
 int usart0_readLineWait(char *s, int len, size_t delay)
 {
 	int count = 0;
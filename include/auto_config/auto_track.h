@@ -29,6 +29,14 @@
  */
 #define MAX_DIST_FROM_SF 1000
 
+/**
+ * Finds the track with the closest start point by scanning every track.
+ * Auto configuration uses the track index instead; this is the reference
+ * it is checked against.
+ * @return The closest track within MAX_DIST_FROM_SF, or NULL if none.
+ */
+const Track* findClosestTrack(const Tracks *tracks, const GeoPoint location);
+
 /**
  * Automatically picks the best track (if available) and updates the config to use this
  * track.
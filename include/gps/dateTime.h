@@ -33,6 +33,7 @@ typedef struct _DateTime {
 bool isLeapYear(const int year);
 unsigned int getDaysInMonth(const int month, bool leapYear);
 millis_t getMillisecondsSinceUnixEpoch(DateTime dt);
+DateTime getDateTimeFromMillisecondsSinceUnixEpoch(millis_t millis);
 millis_t getTimeDeltaInMillis(DateTime a, DateTime b);
 tiny_millis_t getTimeDeltaInTinyMillis(DateTime a, DateTime b);
 bool isValidDateTime(const DateTime dt);
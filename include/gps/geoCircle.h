@@ -28,6 +28,9 @@
 struct GeoCircle {
    GeoPoint point;
    float radius;
+   /* worked out once so testing a fix needs no cos or sqrt */
+   GeoProjection projection;
+   float radiusSquared;
 };
 
 /**
@@ -46,6 +49,36 @@ struct GeoCircle gc_createGeoCircle(const GeoPoint gp, const float radius);
  */
 bool gc_isPointInGeoCircle(const GeoPoint point, const struct GeoCircle gc);
 
+/**
+ * State of one pass through a GeoCircle, used to find when the center was
+ * crossed.  The crossing line goes through the center, perpendicular to the
+ * direction of travel since the path entered the circle; that direction
+ * spans several fixes so it is steady even when single fixes jitter.
+ */
+struct GeoCirclePass {
+   bool active;
+   bool crossed;
+   GeoPoint entry;
+};
+
+/**
+ * Starts over, forgetting any pass in progress.
+ */
+void gc_resetPass(struct GeoCirclePass *pass);
+
+/**
+ * Feeds the path between two consecutive fixes.  The center is crossed at
+ * most once per pass through the circle.
+ * @param pass The pass state for this GeoCircle
+ * @param gc The GeoCircle object
+ * @param from The earlier fix, or an invalid point if there is none
+ * @param to The later fix
+ * @return The fraction of the path from the earlier fix, in [0, 1], at which
+ * the center was crossed, or a negative value if it was not crossed.
+ */
+float gc_updatePass(struct GeoCirclePass *pass, const struct GeoCircle gc,
+                    const GeoPoint from, const GeoPoint to);
+
 /**
  * @return true if its a valid geoCircle, false otherwise.
  */
@@ -31,6 +31,17 @@ typedef struct _GeoPoint {
 // Make into Enum?
 #define GP_EARTH_RADIUS_KM	6371
 #define GP_EARTH_RADIUS_M	6371000
+#define GP_METERS_PER_DEGREE	(GP_EARTH_RADIUS_M * 0.0174532925f)
+
+/**
+ * A flat (equirectangular) projection around an origin, with the cosine of
+ * its latitude worked out once.  Within a few km of the origin it measures
+ * like distPythag, and comparing squared distances needs no cos or sqrt.
+ */
+typedef struct _GeoProjection {
+	GeoPoint origin;
+	float metersPerDegreeLongitude;
+} GeoProjection;
 
 /**
  * Finds the distance between the two geopoints using the
@@ -43,6 +54,22 @@ typedef struct _GeoPoint {
  */
 float distPythag(const GeoPoint *a, const GeoPoint *b);
 
+/**
+ * Creates the projection around the given origin.
+ */
+GeoProjection createGeoProjection(const GeoPoint *origin);
+
+/**
+ * Projects a point to meters east (x) and north (y) of the origin.
+ */
+void projectGeoPoint(const GeoProjection *proj, const GeoPoint *p, float *x, float *y);
+
+/**
+ * @return The squared distance between the two points in square meters, as
+ * measured in the given projection.  Use on points near its origin.
+ */
+float distSquaredProjected(const GeoProjection *proj, const GeoPoint *a, const GeoPoint *b);
+
 /**
  * @return true if the given point is valid, false otherwise.
  */
@@ -25,6 +25,7 @@
 #include "geopoint.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #define KMS_TO_MILES_CONSTANT (.621371)
 #define KNOTS_TO_KPH (1.852)
@@ -52,14 +53,31 @@ typedef struct _TimeLoc {
 	millis_t time;
 } TimeLoc;
 
+/**
+ * A navigation solution decoded from a binary GPS message; the fixed point
+ * fields are taken as the module reports them.
+ */
+typedef struct _GpsNavData {
+   enum GpsSignalQuality quality;
+   int satellites;
+   int32_t latitude; /* 1e-7 degrees */
+   int32_t longitude; /* 1e-7 degrees */
+   int32_t ecefVelocity[3]; /* earth centered X, Y, Z velocity in cm/s */
+   millis_t utcMillis;
+} GpsNavData;
+
 void gpsConfigChanged(void);
 
 void initGPS();
 
-int checksumValid(const char *gpsData, size_t len);
-
 void processGPSData(char *gpsData, size_t len);
 
+/**
+ * Updates the fix from a binary navigation message, in place of the GGA and
+ * RMC sentences used with NMEA output.
+ */
+void processGPSNavData(const GpsNavData *nav);
+
 void resetGpsDistance();
 
 void setGpsDistanceKms(float dist);
@@ -150,4 +168,14 @@ tiny_millis_t getUptimeAtSample();
 
 float getGpsSpeedInMph();
 
+/**
+ * Position, speed and distance estimated for the current uptime from the line through the last
+ * two fixes, for logging faster than the GPS updates.  The estimate goes at most one fix interval
+ * past the latest fix.
+ */
+float getExtrapolatedLatitude();
+float getExtrapolatedLongitude();
+float getExtrapolatedGpsSpeedInMph();
+float getExtrapolatedGpsDistanceMiles();
+
 #endif /*GPS_H_*/
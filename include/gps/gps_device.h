@@ -7,9 +7,21 @@
 
 #ifndef GPS_DEVICE_H_
 #define GPS_DEVICE_H_
+#include "gps.h"
 #include "serial.h"
 
-int GPS_device_provision(Serial *serial);
+/**
+ * Provisions the module for the requested navigation output format
+ * (GPS_NAV_FORMAT_NMEA or GPS_NAV_FORMAT_BINARY); navFormat is updated to
+ * the format actually configured.
+ */
+int GPS_device_provision(Serial *serial, unsigned char *navFormat);
+
+/**
+ * Reads the next binary navigation message.
+ * @return 1 if nav was filled in, 0 on timeout or if unsupported
+ */
+int GPS_device_read_nav_data(Serial *serial, GpsNavData *nav);
 
 
 #endif /* GPS_DEVICE_H_ */
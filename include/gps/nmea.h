@@ -0,0 +1,54 @@
+/*
+ * nmea.h
+ *
+ * Single pass tokenizer for NMEA 0183 sentences.
+ *
+ *   $ttsss,field0,field1,...,fieldN*hh
+ *
+ * One scan over the sentence accumulates the checksum and records where
+ * each field starts; the fields are terminated in place only once the
+ * checksum matched, so a rejected sentence is left intact for logging.
+ */
+
+#ifndef NMEA_H_
+#define NMEA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NMEA_MAX_FIELDS				20
+
+/* coordinates are parsed to fixed point 1e-7 degrees */
+#define NMEA_COORDINATE_SCALE		10000000
+#define NMEA_COORDINATE_DIGITS		7
+
+#define NMEA_TYPE(a, b, c) (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+typedef struct _NmeaSentence {
+	char talker[2];
+	/* the three sentence type characters, see NMEA_TYPE */
+	uint32_t type;
+	size_t fieldCount;
+	/* data fields following the address field, NUL terminated */
+	char *fields[NMEA_MAX_FIELDS];
+} NmeaSentence;
+
+/**
+ * Validates the checksum and splits a sentence into its fields.
+ * @return 1 if the sentence was well formed, 0 otherwise
+ */
+int nmea_tokenize(char *sentence, size_t len, NmeaSentence *nmea);
+
+/**
+ * @return the field at index, or an empty string if the sentence was shorter
+ */
+const char * nmea_field(const NmeaSentence *nmea, size_t index);
+
+/**
+ * Parses a ddmm.mmmm (degreeDigits = 2) or dddmm.mmmm (degreeDigits = 3)
+ * coordinate field into 1e-7 degrees.
+ * @return the unsigned coordinate; 0 for an empty or malformed field
+ */
+int32_t nmea_parse_coordinate(const char *field, size_t degreeDigits);
+
+#endif /* NMEA_H_ */
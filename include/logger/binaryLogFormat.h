@@ -0,0 +1,114 @@
+/*
+ * binaryLogFormat.h
+ *
+ * Compact binary alternative to the CSV log file.
+ *
+ * Layout (all multi-byte values little endian):
+ *
+ * File header, written once before the first record:
+ *   magic          4 bytes  "RCPB"
+ *   version        uint8    BINARY_LOG_VERSION
+ *   channel count  uint16
+ *   file id        uint32, different for every log file; seeds the record CRCs
+ *   channel meta   channel count entries of BINARY_LOG_CHANNEL_META_SIZE bytes:
+ *       label        DEFAULT_LABEL_LENGTH bytes, NUL padded
+ *       units        DEFAULT_UNITS_LENGTH bytes, NUL padded
+ *       min          float32
+ *       max          float32
+ *       sample rate  uint16, in Hz
+ *       precision    uint8
+ *       value type   uint8, one of enum BinaryLogValueType, with
+ *                    BINARY_LOG_FIX_TIMESTAMPED set for channels read from the GPS
+ *
+ * Sample record, one per logged LoggerMessage:
+ *   sync           2 bytes  BINARY_LOG_RECORD_SYNC0, BINARY_LOG_RECORD_SYNC1
+ *   length         uint16, bytes of mask and values
+ *   populated mask (channel count + 7) / 8 bytes; bit n set if channel n has a value
+ *   values         one value per populated channel, in channel order, with the
+ *                  fixed width of the channel's value type
+ *   fix time       int32, uptime in ms of the GPS fix the GPS values came from;
+ *                  only present if a GPS channel is populated
+ *   crc            uint16, CRC-CCITT of length, mask and values, starting from
+ *                  the file's CRC seed
+ *
+ * A torn record, or data past the end of the log such as the stale contents of
+ * a pre-allocated file, fails the CRC check; a reader skips to the next sync.
+ * Seeding the CRC with the file id keeps records left over from an older log
+ * from passing as part of this one.
+ */
+
+#ifndef BINARYLOGFORMAT_H_
+#define BINARYLOGFORMAT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "loggerConfig.h"
+#include "sampleRecord.h"
+
+#define BINARY_LOG_MAGIC					"RCPB"
+#define BINARY_LOG_MAGIC_LENGTH				4
+#define BINARY_LOG_VERSION					3
+#define BINARY_LOG_PREAMBLE_SIZE			(BINARY_LOG_MAGIC_LENGTH + 7)
+#define BINARY_LOG_RECORD_SYNC0				0xa5
+#define BINARY_LOG_RECORD_SYNC1				0x5a
+#define BINARY_LOG_RECORD_HEADER_SIZE		4
+#define BINARY_LOG_RECORD_CRC_SIZE			2
+#define BINARY_LOG_CHANNEL_META_SIZE		(DEFAULT_LABEL_LENGTH + DEFAULT_UNITS_LENGTH + 12)
+
+enum BinaryLogValueType {
+	BinaryLogValueType_Int32 = 0,
+	BinaryLogValueType_Int64,
+	BinaryLogValueType_Float32,
+	BinaryLogValueType_Float64,
+};
+
+#define BINARY_LOG_FIX_TIMESTAMPED			0x80
+#define BINARY_LOG_FIX_TIME_SIZE			4
+
+#define BINARY_LOG_MASK_SIZE(CHANNEL_COUNT)	(((CHANNEL_COUNT) + 7) / 8)
+#define BINARY_LOG_VALUE_SIZE(TYPE)			(((TYPE) == BinaryLogValueType_Int64 || (TYPE) == BinaryLogValueType_Float64) ? 8 : 4)
+#define BINARY_LOG_CRC_SEED(FILE_ID)		((uint16_t)((FILE_ID) ^ ((FILE_ID) >> 16)))
+
+/**
+ * Receives each encoded fragment of the binary log stream.
+ */
+typedef void (*binary_log_write_func)(const void *data, size_t length);
+
+enum BinaryLogValueType binary_log_value_type(enum SampleData sampleData);
+
+/**
+ * Encodes the BINARY_LOG_CHANNEL_META_SIZE byte description of a channel.
+ */
+void binary_log_encode_channel_meta(uint8_t *meta, const ChannelSample *sample);
+
+/**
+ * Encodes the populated mask byte for up to 8 channels starting at samples.
+ */
+uint8_t binary_log_encode_mask(const ChannelSample *samples, size_t channelCount);
+
+/**
+ * Encodes the value of a populated channel into value (at least 8 bytes).
+ * @return the number of bytes encoded
+ */
+size_t binary_log_encode_value(uint8_t *value, const ChannelSample *sample);
+
+/**
+ * @return the bytes of mask, values and fix time a record of the sample buffer carries
+ */
+size_t binary_log_record_length(const ChannelSample *samples, size_t channelCount);
+
+/**
+ * Writes the file header describing every channel in the sample buffer.
+ */
+void binary_log_write_header(binary_log_write_func write, const ChannelSample *samples,
+		size_t channelCount, uint32_t fileId);
+
+/**
+ * Writes a single sample buffer as one framed record.
+ * @param fileId the id written in the file header
+ * @return the number of bytes written
+ */
+size_t binary_log_write_record(binary_log_write_func write, const ChannelSample *samples,
+		size_t channelCount, uint32_t fileId);
+
+#endif /* BINARYLOGFORMAT_H_ */
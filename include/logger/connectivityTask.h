@@ -9,6 +9,9 @@
 #include "devices_common.h"
 #include "serial.h"
 
+//samples a connection may have queued; a lagging link skips samples rather than holding pooled buffers
+#define SAMPLE_RECORD_PENDING_LIMIT		3
+
 typedef struct _ConnParams{
 	uint8_t isPrimary;
 	char * connectionName;
@@ -5,9 +5,24 @@
 #include "ff.h"
 #include "sampleRecord.h"
 
+//samples queued for the file writer; with the one it is writing, the most it holds at once
+#define FILE_WRITER_QUEUE_SIZE		20
+
+typedef struct _FileWriterStats{
+	unsigned int bytesWritten;
+	unsigned int bytesPerSecond;
+	unsigned int maxWriteLatencyMs;
+	/* longest time spent reserving one step of the pre-allocated file */
+	unsigned int maxPreallocationMs;
+} FileWriterStats;
 
 void startFileWriterTask( int priority );
 void fileWriterTask(void *params);
 portBASE_TYPE queue_logfile_record(LoggerMessage * sr);
 
+/**
+ * Write statistics for the current (or most recent) logging session.
+ */
+void get_file_writer_stats(FileWriterStats *stats);
+
 #endif /* FILEWRITER_H_ */
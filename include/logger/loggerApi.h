@@ -26,6 +26,9 @@
 {"setImuCfg", api_setImuConfig}, \
 {"setConnCfg", api_setConnectivityConfig}, \
 {"getConnCfg", api_getConnectivityConfig}, \
+{"setSdLogCfg", api_setSdLoggingConfig}, \
+{"getSdLogCfg", api_getSdLoggingConfig}, \
+{"setTelemFmt", api_setTelemetryFormat}, \
 {"getPwmCfg", api_getPwmConfig}, \
 {"setPwmCfg", api_setPwmConfig}, \
 {"getGpioCfg", api_getGpioConfig}, \
@@ -46,6 +49,8 @@
 {"getScriptCfg", api_getScript}, \
 {"setScriptCfg", api_setScript}, \
 {"runScript", api_runScript}, \
+{"storeScriptBc", api_storeScriptBytecode}, \
+{"getLuaStats", api_getLuaStats}, \
 {"addTrackDb", api_addTrackDb}, \
 {"getTrackDb", api_getTrackDb}, \
 {"getVer", api_getVersion}, \
@@ -64,6 +69,9 @@ int api_log(Serial *serial, const jsmntok_t *json);
 int api_getMeta(Serial *serial, const jsmntok_t *json);
 int api_getConnectivityConfig(Serial *serial, const jsmntok_t *json);
 int api_setConnectivityConfig(Serial *serial, const jsmntok_t *json);
+int api_getSdLoggingConfig(Serial *serial, const jsmntok_t *json);
+int api_setTelemetryFormat(Serial *serial, const jsmntok_t *json);
+int api_setSdLoggingConfig(Serial *serial, const jsmntok_t *json);
 int api_getAnalogConfig(Serial *serial, const jsmntok_t *json);
 int api_setAnalogConfig(Serial *serial, const jsmntok_t *json);
 int api_getGpsConfig(Serial *serial, const jsmntok_t *json);
@@ -93,6 +101,8 @@ int api_setCanConfig(Serial *serial, const jsmntok_t *json);
 int api_getScript(Serial *serial, const jsmntok_t *json);
 int api_setScript(Serial *serial, const jsmntok_t *json);
 int api_runScript(Serial *serial, const jsmntok_t *json);
+int api_storeScriptBytecode(Serial *serial, const jsmntok_t *json);
+int api_getLuaStats(Serial *serial, const jsmntok_t *json);
 
 //messages
 void api_sendLogStart(Serial *serial);
@@ -13,6 +13,7 @@
 #define LOGGER_COMMANDS \
 {"resetConfig", "Resets All configuration Data to factory default", "", ResetConfig}, \
 {"testSD", "Test Write to SD card.","<lineWrites> <periodicFlush> <quietMode>", TestSD}, \
+{"testSerial", "Test transmit throughput and CPU load on a serial port.","<port> <baud> <0=put_c|1=put_buf> [seconds]", TestSerial}, \
 \
 {"startTerminal", "Starts a debugging terminal session on the specified port.","<port> <baud> [echo 1|0]", StartTerminal },\
 {"viewLog", "Prints out logging messages to the terminal as they happen", "", ViewLog },\
@@ -21,6 +22,7 @@
 
 void ResetConfig(Serial *serial, unsigned int argc, char **argv);
 void TestSD(Serial *serial, unsigned int argc, char **argv);
+void TestSerial(Serial *serial, unsigned int argc, char **argv);
 
 void StartTerminal(Serial *serial, unsigned int argc, char **argv);
 void ViewLog(Serial *serial, unsigned int argc, char **argv);
@@ -341,12 +341,22 @@ typedef struct _CANConfig{
 
 #define DEFAULT_CAN_BAUD_RATE 500000
 
+//how the GPS module reports fixes; binary navigation data skips NMEA text parsing on modules that support it
+#define GPS_NAV_FORMAT_NMEA			0
+#define GPS_NAV_FORMAT_BINARY		1
+#define DEFAULT_GPS_NAV_FORMAT		GPS_NAV_FORMAT_NMEA
+
+//log GPS channels as estimated at each logger tick from the last two fixes, rather than as the last fix
+#define DEFAULT_GPS_EXTRAPOLATE		0
+
 typedef struct _GPSConfig{
    ChannelConfig latitude;
    ChannelConfig longitude;
    ChannelConfig speed;
    ChannelConfig distance;
    ChannelConfig satellites;
+   unsigned char navFormat;
+   unsigned char extrapolate;
 } GPSConfig;
 
 //HACK: FIX ME for MARK3
@@ -367,7 +377,9 @@ typedef struct _GPSConfig{
          DEFAULT_GPS_LONGITUDE_CONFIG,          \
          DEFAULT_GPS_SPEED_CONFIG,              \
          DEFAULT_GPS_DISTANCE_CONFIG,           \
-         DEFAULT_GPS_SATELLITE_CONFIG           \
+         DEFAULT_GPS_SATELLITE_CONFIG,          \
+         DEFAULT_GPS_NAV_FORMAT,                \
+         DEFAULT_GPS_EXTRAPOLATE                \
          }
 
 typedef struct _LapConfig{
@@ -446,10 +458,17 @@ typedef struct _CellularConfig{
 #define BACKGROUND_STREAMING_ENABLED				1
 #define BACKGROUND_STREAMING_DISABLED				0
 
+//send only channels that moved beyond their deadband, with periodic full keyframes
+#define TELEMETRY_DELTA_ENABLED						1
+#define TELEMETRY_DELTA_DISABLED					0
+#define DEFAULT_TELEMETRY_DELTA						TELEMETRY_DELTA_DISABLED
+
 typedef struct _TelemetryConfig {
 	unsigned char backgroundStreaming;
 	char telemetryDeviceId[DEVICE_ID_LENGTH + 1];
 	char telemetryServerHost[TELEMETRY_SERVER_HOST_LENGTH + 1];
+	//sits in what was ConnectivityConfig's tail padding, so saved configs keep their layout and read it as disabled
+	unsigned char deltaEncoding;
 } TelemetryConfig;
 
 
@@ -459,8 +478,21 @@ typedef struct _ConnectivityConfig {
 	TelemetryConfig telemetryConfig;
 } ConnectivityConfig;
 
-#define SD_LOGGING_MODE_DISABLED					0
-#define SD_LOGGING_MODE_CSV							1
+//CSV is 0 so configs saved before the mode existed, with zeros here, keep logging CSV
+#define SD_LOGGING_MODE_CSV							0
+#define SD_LOGGING_MODE_BINARY						1
+#define SD_LOGGING_MODE_DISABLED					2
+
+#define DEFAULT_SD_LOGGING_MODE						SD_LOGGING_MODE_CSV
+
+//most of the log file to reserve as contiguous clusters, a step at a time ahead of the data; 0 disables pre-allocation
+#define DEFAULT_SD_LOGGING_PREALLOCATION_MB			0
+#define MAX_SD_LOGGING_PREALLOCATION_MB				4095
+
+typedef struct _SdLoggingConfig {
+	unsigned char loggingMode;
+	unsigned short preallocationMb;
+} SdLoggingConfig;
 
 
 typedef struct _LoggerConfig {
@@ -504,6 +536,9 @@ typedef struct _LoggerConfig {
    //Connectivity Configuration
    ConnectivityConfig ConnectivityConfigs;
 
+   //SD card logging configuration
+   SdLoggingConfig SdLoggingConfigs;
+
    //Padding data to accommodate flash routine
    char padding_data[FLASH_PAGE_SIZE];
 } LoggerConfig;
@@ -520,7 +555,11 @@ int decodeSampleRate(int sampleRateCode);
 
 unsigned char filterAnalogScalingMode(unsigned char mode);
 unsigned char filterBgStreamingMode(unsigned char mode);
+unsigned char filterTelemetryDeltaMode(unsigned char mode);
+unsigned char filterGpsNavFormat(unsigned char format);
+unsigned char filterGpsExtrapolate(unsigned char extrapolate);
 unsigned char filterSdLoggingMode(unsigned char mode);
+unsigned short filterSdLoggingPreallocation(int sizeMb);
 char filterGpioMode(int config);
 char filterPwmOutputMode(int config);
 char filterPwmLoggingMode(int config);
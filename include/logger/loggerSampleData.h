@@ -13,6 +13,30 @@
 #include "loggerConfig.h"
 #include "sampleRecord.h"
 
+/*
+ * Channels of a sample buffer that share a sample rate.
+ */
+typedef struct _SampleRateGroup {
+   unsigned short sampleRate;
+   /* position of the group's first entry in SampleSchedule.channels */
+   unsigned short first;
+   unsigned short count;
+} SampleRateGroup;
+
+/*
+ * Precomputed sampling order for a sample buffer layout, so each tick only
+ * visits the channels that are due rather than testing every channel.
+ */
+typedef struct _SampleSchedule {
+   size_t channelCount;
+   /* rate groups, fastest rate first */
+   size_t groupCount;
+   SampleRateGroup *groups;
+   /* ALWAYS_SAMPLED channels follow the rate groups in channels */
+   size_t alwaysSampledCount;
+   unsigned short *channels;
+} SampleSchedule;
+
 /**
  * Checks that the interval time in the LoggerMessage struct matches that within the ChannelSample
  * buffer.
@@ -22,6 +46,24 @@
 int checkSampleTimestamp(LoggerMessage *lm);
 
 int populate_sample_buffer(LoggerMessage *lm,  size_t count, size_t currentTicks);
+
+/**
+ * Builds the schedule for sample buffers laid out like samples.
+ * @return the number of channels scheduled; 0 if the schedule could not be allocated
+ */
+size_t init_sample_schedule(SampleSchedule *schedule, const ChannelSample *samples, size_t channelCount);
+void free_sample_schedule(SampleSchedule *schedule);
+
+/**
+ * @return whether any channel is due at logTick
+ */
+int sample_schedule_is_due(const SampleSchedule *schedule, size_t logTick);
+
+/**
+ * Scheduled equivalent of populate_sample_buffer.
+ * @return the highest sample rate sampled this tick, or SAMPLE_DISABLED
+ */
+int populate_scheduled_sample_buffer(LoggerMessage *lm, const SampleSchedule *schedule, size_t logTick);
 void init_channel_sample_buffer(LoggerConfig *loggerConfig, ChannelSample * samples, size_t channelCount);
 
 float get_mapped_value(float value, ScalingMap *scalingMap);
@@ -8,12 +8,24 @@
 #ifndef LOGGERTASKEX_H_
 #define LOGGERTASKEX_H_
 
+#include <stddef.h>
 #include "loggerNotifications.h"
 
 int isLogging();
 void startLogging();
 void stopLogging();
 
+/**
+ * Number of samples dropped because every sample buffer was still held by a consumer.
+ */
+size_t getDroppedSampleCount();
+
+/**
+ * Whether the sample buffers have been allocated for the config the logger
+ * started with, so later startup allocations can be sized from what is left.
+ */
+int areSampleBuffersAllocated();
+
 void startLoggerTaskEx( int priority);
 void loggerTaskEx(void *params);
 
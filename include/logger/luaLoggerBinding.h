@@ -71,6 +71,7 @@ int Lua_FlashLoggerConfig(lua_State *L);
 
 int Lua_AddVirtualChannel(lua_State *L);
 int Lua_SetVirtualChannelValue(lua_State *L);
+int Lua_SetVirtualChannelValues(lua_State *L);
 
 
 #endif /*LUALOGGERBINDING_H_*/
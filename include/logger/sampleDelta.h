@@ -0,0 +1,61 @@
+/*
+ * sampleDelta.h
+ *
+ * Change-only filtering of telemetry sample records. Channels whose value
+ * stayed within their deadband since it was last sent are dropped from the
+ * record's populated set; a keyframe resends every channel.
+ */
+
+#ifndef SAMPLEDELTA_H_
+#define SAMPLEDELTA_H_
+
+#include <stddef.h>
+#include "loggerConfig.h"
+#include "sampleRecord.h"
+
+typedef struct _SampleDeltaChannel {
+	/* config of the channel last sent in this slot; NULL until sent after a keyframe */
+	const ChannelConfig *cfg;
+	/* sample_delta_deadband of cfg, worked out when the slot is first sent */
+	float deadband;
+	/* the value last sent, in the channel's own type */
+	union {
+		int valueInt;
+		long long valueLongLong;
+		float valueFloat;
+		double valueDouble;
+	};
+} SampleDeltaChannel;
+
+/*
+ * Per connection state; holds the filtered copy of the last record sent.
+ */
+typedef struct _SampleDelta {
+	size_t channelCount;
+	ChannelSample *samples;
+	SampleDeltaChannel *channels;
+} SampleDelta;
+
+void sample_delta_init(SampleDelta *delta);
+
+void sample_delta_free(SampleDelta *delta);
+
+/**
+ * Smallest change visible at the channel's configured precision.
+ */
+float sample_delta_deadband(const ChannelConfig *cfg);
+
+/**
+ * Requests that every channel be sent again the next time it is populated.
+ */
+void sample_delta_keyframe(SampleDelta *delta);
+
+/**
+ * Copies a sample buffer, keeping only the populated channels that moved
+ * beyond their deadband or were not sent since the last keyframe.
+ * The source buffer is left untouched as it is shared with other consumers.
+ * @return the filtered copy, or samples unfiltered if the copy could not be allocated
+ */
+ChannelSample * sample_delta_filter(SampleDelta *delta, ChannelSample *samples, size_t channelCount);
+
+#endif /* SAMPLEDELTA_H_ */
@@ -35,8 +35,23 @@ enum SampleData {
    SampleData_Float,
    SampleData_Double_Noarg,
    SampleData_Double,
+   SampleData_Float_Planned,
 };
 
+/*
+ * Channel settings resolved from the config when the sample buffer is built,
+ * so planned getters need neither config lookups nor mode switches.
+ */
+typedef union _SamplePlan {
+   float scaling;
+   unsigned int pulsePerRevolution;
+   ScalingMap *scalingMap;
+   ImuConfig *imuConfig;
+} SamplePlan;
+
+struct _ChannelSample;
+typedef float (*planned_float_sample_func)(const struct _ChannelSample *sample);
+
 typedef struct _ChannelSample {
    ChannelConfig *cfg;
    size_t channelIndex;
@@ -52,7 +67,13 @@ typedef struct _ChannelSample {
       long long (*get_longlong_sample_noarg)();
       float (*get_float_sample_noarg)();
       double (*get_double_sample_noarg)();
+      planned_float_sample_func get_float_sample_planned;
    };
+   SamplePlan plan;
+
+   /* set for channels read from the GPS; fixUptime is the uptime of the fix the value came from */
+   bool fixTimestamped;
+   tiny_millis_t fixUptime;
 
    union {
       int valueInt;
@@ -68,10 +89,73 @@ typedef struct _LoggerMessage
 	size_t sampleCount;
     size_t ticks;
 	ChannelSample *channelSamples;
+	/* number of holders; a pooled message is only reused once this drops to zero */
+	volatile size_t refCount;
+	/* pool generation the channel samples were built for */
+	size_t generation;
 } LoggerMessage;
 
+/*
+ * Fixed set of sample messages shared between the logger task and its consumers.
+ */
+typedef struct _LoggerMessagePool
+{
+	LoggerMessage *messages;
+	size_t size;
+	size_t next;
+	size_t generation;
+	size_t dropped;
+} LoggerMessagePool;
+
 ChannelSample* create_channel_sample_buffer(LoggerConfig *loggerConfig, size_t channelCount);
 
+/* CSV log column holding the uptime of the GPS fix */
+#define FIX_TIME_LABEL	"GPSFix"
+#define FIX_TIME_UNITS	"ms"
+
+/**
+ * Every GPS channel in a sample is read from the same fix, so one of them
+ * carries the fix time for the whole sample.
+ * @return a populated GPS channel of the sample, or NULL if there is none.
+ */
+const ChannelSample * get_fix_sample(const ChannelSample *samples, size_t channelCount);
+
+void logger_message_retain(LoggerMessage *msg);
+
+/**
+ * Drops a reference taken by logger_message_retain or logger_message_pool_acquire.
+ * Releasing a message that holds no references is a no-op.
+ */
+void logger_message_release(LoggerMessage *msg);
+
+void logger_message_pool_init(LoggerMessagePool *pool, LoggerMessage *messages, size_t size);
+
+/**
+ * Marks every message in the pool as stale; each is rebuilt for the
+ * current channel configuration the next time it is acquired.
+ */
+void logger_message_pool_invalidate(LoggerMessagePool *pool);
+
+/**
+ * Builds the buffer of every message no consumer holds for the current
+ * channel layout, so a lack of memory shows when the config is applied.
+ * Messages still held are rebuilt when they are next acquired.
+ * @return the number of buffers that could not be allocated
+ */
+size_t logger_message_pool_allocate(LoggerMessagePool *pool, LoggerConfig *loggerConfig, size_t channelCount);
+
+/**
+ * Claims an unreferenced message from the pool, holding one reference to it.
+ * @return the message, or NULL if every message is still referenced or its
+ * buffer could not be allocated.
+ */
+LoggerMessage * logger_message_pool_acquire(LoggerMessagePool *pool, LoggerConfig *loggerConfig, size_t channelCount);
+
+/**
+ * Counts a sample that was due but could not be taken for lack of a free message.
+ */
+void logger_message_pool_drop(LoggerMessagePool *pool);
+
 /**
  * Checks to ensure that the LoggerMessage object is not older than 10 milliseconds.  If it is then
  * we may read an old buffer and send bad data.  There is a special case where if ticks are zero
@@ -0,0 +1,67 @@
+/*
+ * telemetryFrame.h
+ *
+ * Compact binary alternative to the JSON telemetry stream, negotiated per
+ * connection with the setTelemFmt API command.
+ *
+ * Each frame is sent as
+ *   0x00, COBS(payload, crc16), 0x00
+ * COBS encoding removes every zero byte from the frame body, so the zero
+ * delimiters separate frames from the JSON command responses sharing the link.
+ * The crc16 (CCITT, initial value 0xffff, little endian) covers the payload.
+ *
+ * Payload (multi-byte values little endian):
+ *   type           uint8, one of enum TelemetryFrameType
+ *   Meta:   channel count uint16, then one binary log channel meta entry per channel
+ *   Sample: tick uint32, then the populated mask and values of a binary log sample record
+ *   Start / End: no body
+ *
+ * The meta and record layouts are described in binaryLogFormat.h.
+ *
+ * A connection starts in JSON each time it is established, and keeps the
+ * format its client negotiates until it is re-established or the client
+ * sends setTelemFmt again; a client that only listens is never switched.
+ */
+
+#ifndef TELEMETRYFRAME_H_
+#define TELEMETRYFRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "serial.h"
+#include "sampleRecord.h"
+
+#define TELEMETRY_FRAME_DELIMITER		0x00
+#define TELEMETRY_FRAME_COBS_BLOCK		254
+#define TELEMETRY_FRAME_CRC_INIT		0xffff
+
+enum TelemetryFormat {
+	TelemetryFormat_Json = 0,
+	TelemetryFormat_Binary,
+};
+
+#define TELEMETRY_FORMAT_DEFAULT		TelemetryFormat_Json
+
+enum TelemetryFrameType {
+	TelemetryFrameType_Meta = 1,
+	TelemetryFrameType_Sample,
+	TelemetryFrameType_Start,
+	TelemetryFrameType_End,
+};
+
+int filterTelemetryFormat(int format);
+
+/**
+ * Selects the telemetry format streamed over a connection's serial port.
+ */
+void set_telemetry_format(Serial *serial, enum TelemetryFormat format);
+
+enum TelemetryFormat get_telemetry_format(Serial *serial);
+
+void telemetry_send_meta_frame(Serial *serial, const ChannelSample *samples, size_t channelCount);
+
+void telemetry_send_sample_frame(Serial *serial, const ChannelSample *samples, size_t channelCount, unsigned int tick);
+
+void telemetry_send_event_frame(Serial *serial, enum TelemetryFrameType type);
+
+#endif /* TELEMETRYFRAME_H_ */
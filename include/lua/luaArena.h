@@ -0,0 +1,85 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LUAARENA_H_
+#define _LUAARENA_H_
+
+#include <stddef.h>
+
+/**
+ * Sizes are rounded up to LUA_ARENA_ALIGN.  Blocks of up to LUA_ARENA_SMALL_MAX
+ * bytes are kept in a free list per size once released, so the strings, table
+ * nodes and closures that make up most of a script are reused without a search.
+ */
+#define LUA_ARENA_ALIGN		8
+#define LUA_ARENA_SMALL_MAX	64
+#define LUA_ARENA_SIZE_CLASSES	(LUA_ARENA_SMALL_MAX / LUA_ARENA_ALIGN)
+
+typedef struct _LuaArenaBlock {
+   struct _LuaArenaBlock *next;
+   /* only kept for large blocks */
+   size_t size;
+} LuaArenaBlock;
+
+/**
+ * A fixed block of memory given over to Lua.  Lua passes the size of a block
+ * back when releasing it, so blocks carry no header.
+ */
+typedef struct _LuaArena {
+   unsigned char *base;
+   size_t size;
+   /* the offset of the first byte never handed out */
+   size_t top;
+   LuaArenaBlock *small[LUA_ARENA_SIZE_CLASSES];
+   /* free large blocks in address order */
+   LuaArenaBlock *large;
+   size_t used;
+   size_t highWater;
+   unsigned int allocations;
+   unsigned int failures;
+} LuaArena;
+
+typedef struct _LuaArenaStats {
+   size_t size;
+   size_t used;
+   size_t highWater;
+   /* the largest block that could be handed out now */
+   size_t largestFree;
+   unsigned int allocations;
+   unsigned int failures;
+} LuaArenaStats;
+
+/**
+ * Sets up an empty arena over memory, which must be aligned to LUA_ARENA_ALIGN.
+ */
+void lua_arena_init(LuaArena *arena, void *memory, size_t size);
+
+/**
+ * Releases everything at once, as when the Lua state is closed.
+ */
+void lua_arena_reset(LuaArena *arena);
+
+/**
+ * Allocates, resizes and releases blocks as a lua_Alloc does.
+ * @return NULL if nsize is 0 or there is no room, in which case ptr is left as it was.
+ */
+void * lua_arena_realloc(LuaArena *arena, void *ptr, size_t osize, size_t nsize);
+
+void lua_arena_get_stats(const LuaArena *arena, LuaArenaStats *stats);
+
+#endif /* _LUAARENA_H_ */
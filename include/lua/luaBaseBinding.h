@@ -19,6 +19,10 @@ int Lua_Println(lua_State *L);
 int Lua_GetStackSize(lua_State *L);
 int Lua_SetTickRate(lua_State *L);
 int Lua_GetTickRate(lua_State *L);
+int Lua_AddTickHandler(lua_State *L);
+int Lua_RemoveTickHandler(lua_State *L);
+int Lua_SetGcSteps(lua_State *L);
+int Lua_GetGcSteps(lua_State *L);
 int Lua_PrintLog(lua_State *L);
 int Lua_PrintLogLn(lua_State *L);
 int Lua_SetLogLevel(lua_State *L);
@@ -0,0 +1,127 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LUASCHEDULER_H_
+#define _LUASCHEDULER_H_
+
+#include <stddef.h>
+
+#define LUA_MAX_CALLBACKS	4
+#define LUA_DEFAULT_GC_STEPS	4
+/* a budget for a callback that is never stopped or penalised for running long */
+#define LUA_BUDGET_NONE	((size_t) -1)
+
+typedef struct _LuaCallbackStats {
+   unsigned int runs;
+   /* runs stopped for going over budget */
+   unsigned int overruns;
+   /* runs missed, either as a penalty for an overrun or because the task fell behind */
+   unsigned int skips;
+   size_t lastTicks;
+   size_t maxTicks;
+} LuaCallbackStats;
+
+/**
+ * A Lua function run every interval ticks.  All times are in ticks.
+ */
+typedef struct _LuaCallback {
+   int active;
+   /* identifies the function to the Lua task */
+   int ref;
+   size_t interval;
+   /* how long one run may take before it is stopped */
+   size_t budget;
+   size_t nextRun;
+   LuaCallbackStats stats;
+} LuaCallback;
+
+/**
+ * Garbage collection done between callbacks.
+ */
+typedef struct _LuaGcStats {
+   /* the most steps run after one callback; 0 leaves collection to Lua */
+   unsigned int stepBudget;
+   unsigned int steps;
+   unsigned int cycles;
+   size_t maxStepTicks;
+} LuaGcStats;
+
+/**
+ * Clears all callbacks and statistics.  The GC step budget is kept.
+ */
+void lua_scheduler_init(void);
+
+/**
+ * Schedules a callback, first due one interval after now.
+ * @param budget 0 for half the interval, LUA_BUDGET_NONE for no limit.
+ * @return the id of the callback, or -1 if there is no room for it.
+ */
+int lua_scheduler_add(int ref, size_t interval, size_t budget, size_t now);
+
+/**
+ * @return the callback, or NULL if id is not scheduled.
+ */
+const LuaCallback * lua_scheduler_get(int id);
+
+void lua_scheduler_remove(int id);
+
+/**
+ * Changes how often a callback runs.  A callback with a budget is given half
+ * the new interval; one without stays unlimited.
+ */
+void lua_scheduler_set_interval(int id, size_t interval);
+
+/**
+ * @param budget 0 for half the interval, LUA_BUDGET_NONE for no limit.
+ */
+void lua_scheduler_set_budget(int id, size_t budget);
+
+/**
+ * @return the id of the most overdue callback, or -1 if none are due.
+ */
+int lua_scheduler_next_due(size_t now);
+
+/**
+ * @return ticks until the next callback is due, or maxTicks if that is sooner.
+ */
+size_t lua_scheduler_ticks_until_due(size_t now, size_t maxTicks);
+
+/**
+ * Records a run of a callback and schedules its next one.  A run over budget
+ * costs the callback its next run, and runs missed while the task was busy are
+ * dropped rather than made up.
+ */
+void lua_scheduler_ran(int id, size_t start, size_t end);
+
+/**
+ * Moves a callback on to its next run without recording anything, as when
+ * there is nothing to call.
+ */
+void lua_scheduler_postpone(int id, size_t now);
+
+void lua_scheduler_set_gc_steps(unsigned int steps);
+
+const LuaGcStats * lua_scheduler_get_gc_stats(void);
+
+/**
+ * Records one GC step.
+ * @param cycleDone Whether the step finished a collection cycle.
+ */
+void lua_scheduler_gc_stepped(size_t start, size_t end, int cycleDone);
+
+#endif /* _LUASCHEDULER_H_ */
@@ -1,6 +1,7 @@
 #ifndef LUASCRIPT_H_
 #define LUASCRIPT_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include "memory.h"
 #include "capabilities.h"
@@ -12,6 +13,9 @@
 #define SCRIPT_ADD_MODE_COMPLETE 	2
 
 #define MAGIC_NUMBER_SCRIPT_INIT 0xDECAFBAD
+#define MAGIC_NUMBER_BYTECODE_INIT 0xB17EC0DE
+
+#define SCRIPT_BYTECODE_FIRMWARE ((MAJOR_REV << 16) | (MINOR_REV << 8) | BUGFIX_REV)
 
 #define SCRIPT_PAGE_SIZE 256
 #define MAX_SCRIPT_PAGES SCRIPT_MEMORY_LENGTH / SCRIPT_PAGE_SIZE
@@ -21,6 +25,19 @@ typedef struct _ScriptConfig{
 	uint32_t magicInit;
 } ScriptConfig;
 
+/**
+ * The script compiled by lua_dump, kept so it need not be compiled again at
+ * every start.  It is only used with the script and firmware it came from.
+ */
+typedef struct _ScriptBytecode{
+	uint32_t magicInit;
+	uint32_t firmware;
+	uint32_t scriptChecksum;
+	uint32_t codeChecksum;
+	uint32_t length;
+	unsigned char code[SCRIPT_BYTECODE_LENGTH];
+} ScriptBytecode;
+
 void initialize_script();
 
 int flash_default_script();
@@ -31,6 +48,24 @@ int flashScriptPage(unsigned int page, const char *data, int mode);
 
 void unescapeScript(char *data);
 
+/**
+ * @return the compiled form of the current script, or NULL if there is none
+ * from this firmware or it does not check out.
+ */
+const unsigned char * get_script_bytecode(size_t *length);
+
+/**
+ * Allocates a buffer for length bytes of code, compiled from the current script.
+ * @return NULL if it would not fit in flash or there is no memory for it.
+ */
+ScriptBytecode * create_script_bytecode(size_t length);
+
+/**
+ * Flashes code written into a buffer from create_script_bytecode, then frees it.
+ * @return 0 on success
+ */
+int flash_script_bytecode(ScriptBytecode *bytecode);
+
 #define DEFAULT_SCRIPT "function onTick() end"
 	
 #endif /*LUASCRIPT_H_*/
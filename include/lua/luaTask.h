@@ -1,6 +1,9 @@
 #ifndef LUATASK_H_
 #define LUATASK_H_
 #include <stddef.h>
+#include "luaArena.h"
+
+#define MAX_ONTICK_HZ 200
 
 void lockLua(void);
 void unlockLua(void);
@@ -14,13 +17,46 @@ void * getLua(void);
 
 unsigned int getLastPointer();
 
+/**
+ * Gets the use of the Lua arena, all zero if Lua is using the heap.
+ */
+void get_lua_arena_stats(LuaArenaStats *stats);
+
 void setAllocDebug(int enableDebug);
 int getAllocDebug();
 
 int getShouldReloadScript(void);
 void setShouldReloadScript(int reload);
 
+/**
+ * Asks the Lua task to compile the script and keep the bytecode in flash, so
+ * later starts load it instead of compiling.  Flashing stalls every task, so it
+ * waits until logging has stopped.
+ */
+void requestStoreScriptBytecode(void);
+
 void set_ontick_freq(size_t freq);
 size_t get_ontick_freq();
 
+/**
+ * Stops any onTick run that takes longer than budgetMs.  onTick has no
+ * budget until a script asks for one, and loses it again on reload.
+ * @param budgetMs 0 for half the time between runs.
+ */
+void set_ontick_budget(size_t budgetMs);
+
+/**
+ * Runs the Lua function held at ref in the registry freq times a second, stopping
+ * any run that takes longer than budgetMs.
+ * @param budgetMs 0 for half the time between runs.
+ * @return an id for remove_tick_handler, or -1 if it could not be added.
+ */
+int add_tick_handler(int ref, size_t freq, size_t budgetMs);
+
+/**
+ * @return the registry ref of the removed function, for the caller to release,
+ * or LUA_NOREF if there was none.
+ */
+int remove_tick_handler(int id);
+
 #endif /*LUATASK_H_*/
@@ -0,0 +1,120 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LAPTRACE_H_
+#define _LAPTRACE_H_
+
+#include "dateTime.h"
+#include "geopoint.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Positions in a trace are kept in a GeoProjection around its first point,
+ * in steps of 1 / LAP_TRACE_UNITS_PER_METER meters.
+ */
+#define LAP_TRACE_UNITS_PER_METER	4
+#define LAP_TRACE_MAX_STEP		INT8_MAX
+#define LAP_TRACE_MAX_TIME_STEP		UINT16_MAX
+
+/**
+ * One point of a trace, stored as the change from the point before it.  A
+ * move too large to fit is stored as several samples along a straight line.
+ */
+typedef struct _LapTraceSample {
+   int8_t dx;
+   int8_t dy;
+   uint16_t dt;
+} LapTraceSample;
+
+/**
+ * A path with the time at each point, such as one lap.  Points can only be
+ * read in order, forwards or backwards, through a LapTraceCursor.
+ */
+typedef struct _LapTrace {
+   LapTraceSample *samples;
+   size_t capacity;
+   size_t count;
+   GeoProjection projection;
+   /* the position and time of the last sample */
+   int32_t x;
+   int32_t y;
+   tiny_millis_t time;
+} LapTrace;
+
+typedef struct _LapTraceCursor {
+   size_t index;
+   int32_t x;
+   int32_t y;
+   tiny_millis_t time;
+} LapTraceCursor;
+
+/**
+ * Starts a trace at origin at time 0.  The origin takes up the first sample.
+ * @param samples Storage for the trace; must have room for capacity samples.
+ */
+void lap_trace_init(LapTrace *trace, LapTraceSample *samples, size_t capacity,
+                    const GeoPoint *origin);
+
+/**
+ * Starts a trace from count samples saved from a trace that began at origin.
+ * @param count Must be between 1 and capacity.
+ */
+void lap_trace_load(LapTrace *trace, LapTraceSample *samples, size_t capacity,
+                    const GeoPoint *origin, const LapTraceSample *source, size_t count);
+
+/**
+ * Adds point at time to the end of the trace.
+ * @param time Must not be before the last sample.
+ * @return false if there is not room for it, in which case the trace is
+ * left as it was.
+ */
+bool lap_trace_append(LapTrace *trace, const GeoPoint *point, tiny_millis_t time);
+
+/**
+ * Removes the last sample, if there is more than the origin.
+ */
+void lap_trace_drop_last(LapTrace *trace);
+
+/**
+ * Gets the position of point in the projection of the trace, in meters.
+ */
+void lap_trace_project(const LapTrace *trace, const GeoPoint *point, float *x, float *y);
+
+/**
+ * Gets the squared distance in meters between the last sample and point.
+ */
+float lap_trace_dist_squared_to_last(const LapTrace *trace, const GeoPoint *point);
+
+void lap_trace_first(const LapTrace *trace, LapTraceCursor *cursor);
+
+/**
+ * Moves the cursor to the next or previous sample.
+ * @return false, leaving the cursor where it was, at either end of the trace.
+ */
+bool lap_trace_next(const LapTrace *trace, LapTraceCursor *cursor);
+bool lap_trace_prev(const LapTrace *trace, LapTraceCursor *cursor);
+
+/**
+ * Gets the position of the cursor in the projection of the trace, in meters.
+ */
+void lap_trace_position(const LapTraceCursor *cursor, float *x, float *y);
+
+#endif /* _LAPTRACE_H_ */
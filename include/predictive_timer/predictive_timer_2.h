@@ -10,6 +10,7 @@
 
 #include "dateTime.h"
 #include "geopoint.h"
+#include "tracks.h"
 
 #include <stdbool.h>
 
@@ -64,4 +65,24 @@ bool isPredictiveTimeAvailable();
  */
 void resetPredictiveTimer();
 
+/**
+ * Makes the reference lap saved for track the fast lap, if there is one.  Call after
+ * #resetPredictiveTimer, before the first start/finish crossing.
+ * @return True if a reference lap was loaded, false otherwise.
+ */
+bool loadFastLap(const Track *track);
+
+/**
+ * Saves the fast lap as the reference lap for track, replacing any other.  Flashing stalls the
+ * CPU for a while, so only call this when timing is not critical.
+ * @return 0 on success, non zero otherwise.
+ */
+int saveFastLap(const Track *track);
+
+/**
+ * Tells the caller if the fast lap has been saved (or tried to be) since it was set.
+ * @return False if there is a new fast lap to save, true otherwise.
+ */
+bool isFastLapSaved();
+
 #endif /* PREDICTIVE_TIMER_2_H_ */
@@ -0,0 +1,61 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _REFERENCELAP_H_
+#define _REFERENCELAP_H_
+
+#include "capabilities.h"
+#include "dateTime.h"
+#include "geopoint.h"
+#include "lapTrace.h"
+#include "tracks.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAGIC_NUMBER_REFERENCE_LAP_INIT	0xFA57C0DE
+/* bump whenever ReferenceLap, Track or LapTraceSample change layout */
+#define REFERENCE_LAP_FORMAT_VERSION	1
+
+/**
+ * The fastest lap the predictive timer has seen, kept in flash so predicted
+ * times are available from the first lap after a power cycle.  Only used
+ * again on a track identical to the one it was driven on.
+ */
+typedef struct _ReferenceLap {
+   uint32_t magicInit;
+   uint32_t version;
+   Track track;
+   tiny_millis_t lapTime;
+   float sampleDistance;
+   GeoPoint origin;
+   uint32_t count;
+   LapTraceSample samples[PREDICTIVE_TIMER_SAMPLES];
+} ReferenceLap;
+
+const ReferenceLap * get_reference_lap();
+
+int flash_reference_lap(const ReferenceLap *source, size_t rawSize);
+
+/**
+ * @return The saved reference lap if it was driven on track and written in
+ * the current format, NULL otherwise.
+ */
+const ReferenceLap * find_reference_lap(const Track *track);
+
+#endif /* _REFERENCELAP_H_ */
@@ -32,6 +32,7 @@ typedef struct _Serial{
 
 	void (*put_c)(char c);
 	void (*put_s)(const char *);
+	void (*put_buf)(const char *data, size_t length);
 
 	void (*flush)(void);
 
@@ -0,0 +1,72 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TRACKINDEX_H_
+#define _TRACKINDEX_H_
+
+#include "geopoint.h"
+#include "tracks.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Grid cells are this many degrees on a side.  A cell of latitude is about
+ * 1.1km, so a lookup within 1km only has to visit the neighboring rows.
+ */
+#define TRACK_INDEX_CELL_DEGREES	0.01f
+#define TRACK_INDEX_LAT_CELLS		18000
+#define TRACK_INDEX_LON_CELLS		36000
+
+/**
+ * One start point in the index.  Left unpacked so the cell compares in the
+ * binary search stay aligned; with padding each entry takes 8 bytes.
+ */
+typedef struct _TrackIndexEntry {
+   /* row major grid cell of the start point */
+   uint32_t cell;
+   uint16_t track;
+} TrackIndexEntry;
+
+/**
+ * Start points of a set of tracks bucketed by grid cell, sorted by cell so
+ * the tracks near a location are found with a few binary searches.
+ */
+typedef struct _TrackIndex {
+   const Track *tracks;
+   size_t count;
+   TrackIndexEntry *entries;
+} TrackIndex;
+
+/**
+ * Builds the index over tracks; entries must have room for count entries.
+ * Tracks without a valid start point are left out.
+ */
+void track_index_build(TrackIndex *index, const Track *tracks, size_t count,
+                       TrackIndexEntry *entries);
+
+/**
+ * Finds the track whose start point is closest to location, as measured in
+ * a GeoProjection around location.  Ties go to the track that comes first.
+ * @param maxDistance Only tracks closer than this many meters are considered.
+ * @return The closest track, or NULL if none was in range.
+ */
+const Track* track_index_find_closest(const TrackIndex *index, const GeoPoint location,
+                                      const float maxDistance);
+
+#endif /* _TRACKINDEX_H_ */
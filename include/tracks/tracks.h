@@ -59,6 +59,14 @@ int add_track(const Track *track, size_t index, int mode);
 int flash_default_tracks(void);
 const Tracks * get_tracks();
 
+struct _TrackIndex;
+
+/**
+ * @return The spatial index over the start points of the flashed tracks,
+ * rebuilt whenever the tracks are flashed.
+ */
+const struct _TrackIndex * get_track_index();
+
 /**
  * Returns the finish point of the track, regardless if its a stage or a circuit.
  * @return The GeoPoint representing the finish line.
@@ -29,6 +29,8 @@ void usart0_putchar(char c);
 
 void usart0_puts (const char* s );
 
+void usart0_put_buf(const char *data, size_t length);
+
 int usart0_readLine(char *s, int len);
 
 int usart0_readLineWait(char *s, int len, size_t delay);
@@ -44,6 +46,8 @@ void usart1_putchar(char c);
 
 void usart1_puts (const char* s );
 
+void usart1_put_buf(const char *data, size_t length);
+
 int usart1_readLine(char *s, int len);
 
 int usart1_readLineWait(char *s, int len, size_t delay);
@@ -59,6 +63,8 @@ void usart2_putchar(char c);
 
 void usart2_puts (const char* s );
 
+void usart2_put_buf(const char *data, size_t length);
+
 int usart2_readLine(char *s, int len);
 
 int usart2_readLineWait(char *s, int len, size_t delay);
@@ -74,6 +80,8 @@ void usart3_putchar(char c);
 
 void usart3_puts (const char* s );
 
+void usart3_put_buf(const char *data, size_t length);
+
 int usart3_readLine(char *s, int len);
 
 int usart3_readLineWait(char *s, int len, size_t delay);
@@ -25,4 +25,6 @@ void usb_putchar(char c);
 
 void usb_puts(const char* s );
 
+void usb_put_buf(const char *data, size_t length);
+
 #endif /*USB_COMM_H_*/
@@ -0,0 +1,21 @@
+/*
+ * crc16.h
+ *
+ * CRC-CCITT (polynomial 0x1021), shared by the binary telemetry frames and
+ * the binary log records.
+ */
+
+#ifndef CRC16_H_
+#define CRC16_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC16_CCITT_INIT	0xffff
+
+/**
+ * Continues crc over data; start with CRC16_CCITT_INIT.
+ */
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, size_t length);
+
+#endif /* CRC16_H_ */
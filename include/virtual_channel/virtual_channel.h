@@ -19,6 +19,9 @@ typedef struct _VirtualChannel{
 
 #define INVALID_VIRTUAL_CHANNEL -1
 
+/* slots in the name index; a power of two at least twice MAX_VIRTUAL_CHANNELS keeps probes short */
+#define VIRTUAL_CHANNEL_INDEX_SIZE 64
+
 int find_virtual_channel(const char * channel_name);
 int create_virtual_channel(const ChannelConfig chCfg);
 VirtualChannel * get_virtual_channel(size_t id);
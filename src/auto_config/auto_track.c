@@ -20,10 +20,12 @@
 #include "geopoint.h"
 #include "loggerConfig.h"
 #include "printk.h"
+#include "trackIndex.h"
 #include "tracks.h"
 
 const Track* findClosestTrack(const Tracks *tracks, const GeoPoint location) {
-    float dist = MAX_DIST_FROM_SF;
+    const GeoProjection proj = createGeoProjection(&location);
+    float dist = MAX_DIST_FROM_SF * MAX_DIST_FROM_SF;
     const Track *best = NULL;
 
     for (unsigned i = 0; i < tracks->count; ++i) {
@@ -31,7 +33,7 @@ const Track* findClosestTrack(const Tracks *tracks, const GeoPoint location) {
 
         // XXX: inaccurate but fast.  Good enough for now.
         GeoPoint startPoint = getStartPoint(track);
-        float track_distance = distPythag(&startPoint, &location);
+        float track_distance = distSquaredProjected(&proj, &startPoint, &location);
 
         if (track_distance >= dist)
             continue;
@@ -60,7 +62,7 @@ const Track* auto_configure_track(Track *defaultCfg, GeoPoint gp) {
         return defaultCfg;
     }
 
-    const Track *foundTrack = findClosestTrack(tracks, gp);
+    const Track *foundTrack = track_index_find_closest(get_track_index(), gp, MAX_DIST_FROM_SF);
     if (!foundTrack) {
         pr_info("no ");
         foundTrack = defaultCfg;
@@ -25,6 +25,8 @@
 #include "luaTask.h"
 #include "memory.h"
 #include "loggerConfig.h"
+#include "fileWriter.h"
+#include "loggerTaskEx.h"
 #include "cpu.h"
 
 extern unsigned int _CONFIG_HEAP_SIZE;
@@ -69,6 +71,65 @@ void ShowStats(Serial *serial, unsigned int argc, char **argv) {
     put_int(serial, lua_gc(L, LUA_GCCOUNT, 0));
     put_crlf(serial);
 
+    LuaArenaStats arenaStats;
+    get_lua_arena_stats(&arenaStats);
+
+    putDataRowHeader(serial, "Lua Arena Size");
+    put_uint(serial, arenaStats.size);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Lua Arena Used");
+    put_uint(serial, arenaStats.used);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Lua Arena High Water");
+    put_uint(serial, arenaStats.highWater);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Lua Arena Largest Free");
+    put_uint(serial, arenaStats.largestFree);
+    put_crlf(serial);
+
+    // free space that cannot be handed out as one block
+    const size_t arenaFree = arenaStats.size - arenaStats.used;
+    putDataRowHeader(serial, "Lua Arena Fragmentation (%)");
+    put_uint(serial, arenaFree ? 100 - arenaStats.largestFree * 100 / arenaFree : 0);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Lua Allocations");
+    put_uint(serial, arenaStats.allocations);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Lua Failed Allocations");
+    put_uint(serial, arenaStats.failures);
+    put_crlf(serial);
+
+    // Logfile Info
+    putHeader(serial, "Logfile Info");
+
+    FileWriterStats writerStats;
+    get_file_writer_stats(&writerStats);
+
+    putDataRowHeader(serial, "Bytes Written");
+    put_uint(serial, writerStats.bytesWritten);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Bytes/Sec");
+    put_uint(serial, writerStats.bytesPerSecond);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Max Write Latency (ms)");
+    put_uint(serial, writerStats.maxWriteLatencyMs);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Max Preallocation Step (ms)");
+    put_uint(serial, writerStats.maxPreallocationMs);
+    put_crlf(serial);
+
+    putDataRowHeader(serial, "Dropped Samples");
+    put_uint(serial, getDroppedSampleCount());
+    put_crlf(serial);
+
     // Misc Info
     putHeader(serial, "Misc");
 
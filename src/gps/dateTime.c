@@ -81,6 +81,33 @@ millis_t getMillisecondsSinceUnixEpoch(DateTime dt) {
    return seconds * MILLIS_PER_SECOND + dt.millisecond;
 }
 
+DateTime getDateTimeFromMillisecondsSinceUnixEpoch(millis_t millis) {
+   DateTime dt = { 0 };
+   if (millis < 0)
+      return dt;
+
+   dt.millisecond = (int16_t) (millis % MILLIS_PER_SECOND);
+   const millis_t seconds = millis / MILLIS_PER_SECOND;
+   dt.second = (int8_t) (seconds % SECONDS_PER_MINUTE);
+   dt.minute = (int8_t) (seconds / SECONDS_PER_MINUTE % 60);
+   dt.hour = (int8_t) (seconds / SECONDS_PER_HOUR % 24);
+
+   unsigned int days = (unsigned int) (seconds / SECONDS_PER_DAY);
+   int year = 1970;
+   while (days >= getDaysInYear(isLeapYear(year)))
+      days -= getDaysInYear(isLeapYear(year++));
+
+   const bool ly = isLeapYear(year);
+   int month = 1;
+   while (days >= getDaysInMonth(month, ly))
+      days -= getDaysInMonth(month++, ly);
+
+   dt.year = (int16_t) year;
+   dt.month = (int8_t) month;
+   dt.day = (int8_t) (days + 1);
+   return dt;
+}
+
 millis_t getTimeDeltaInMillis(DateTime a, DateTime b) {
    if (!isValidDateTime(a) || !isValidDateTime(b))
       return 0;
@@ -22,18 +22,65 @@
 #include "geopoint.h"
 #include "tracks.h"
 #include "printk.h"
+
 struct GeoCircle gc_createGeoCircle(const GeoPoint gp, const float r) {
    struct GeoCircle gc;
 
    gc.point = gp;
    gc.radius = r;
+   gc.projection = createGeoProjection(&gp);
+   gc.radiusSquared = r * r;
 
    return gc;
 }
 
 bool gc_isPointInGeoCircle(const GeoPoint point, const struct GeoCircle gc) {
-   float dist = distPythag(&point, &(gc.point));
-   return  dist <= gc.radius;
+   return distSquaredProjected(&gc.projection, &point, &gc.point) <= gc.radiusSquared;
+}
+
+void gc_resetPass(struct GeoCirclePass *pass) {
+   pass->active = false;
+   pass->crossed = false;
+}
+
+float gc_updatePass(struct GeoCirclePass *pass, const struct GeoCircle gc,
+                    const GeoPoint from, const GeoPoint to) {
+   const bool inside = gc_isPointInGeoCircle(to, gc);
+
+   if (!pass->active) {
+      if (!inside)
+         return -1;
+
+      pass->active = true;
+      pass->crossed = false;
+      pass->entry = isValidPoint(&from) ? from : to;
+   }
+
+   float t = -1;
+   if (!pass->crossed) {
+      float ex, ey, fx, fy, tx, ty;
+      projectGeoPoint(&gc.projection, &pass->entry, &ex, &ey);
+      projectGeoPoint(&gc.projection, &from, &fx, &fy);
+      projectGeoPoint(&gc.projection, &to, &tx, &ty);
+
+      const float hx = tx - ex;
+      const float hy = ty - ey;
+      const float toAhead = tx * hx + ty * hy;
+
+      if (toAhead >= 0) {
+         pass->crossed = true;
+         t = 1;
+
+         const float fromAhead = fx * hx + fy * hy;
+         if (isValidPoint(&from) && fromAhead < 0)
+            t = -fromAhead / (toAhead - fromAhead);
+      }
+   }
+
+   if (!inside)
+      pass->active = false;
+
+   return t;
 }
 
 bool gc_isValidGeoCircle(const struct GeoCircle gc) {
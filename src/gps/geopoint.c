@@ -31,6 +31,27 @@ float distPythag(const GeoPoint *a, const GeoPoint *b) {
    return sqrt(tmp * tmp + dLatRad * dLatRad) * GP_EARTH_RADIUS_M;
 }
 
+GeoProjection createGeoProjection(const GeoPoint *origin) {
+   GeoProjection proj;
+
+   proj.origin = *origin;
+   proj.metersPerDegreeLongitude = GP_METERS_PER_DEGREE * cosf(toRad(origin->latitude));
+
+   return proj;
+}
+
+void projectGeoPoint(const GeoProjection *proj, const GeoPoint *p, float *x, float *y) {
+   *x = (p->longitude - proj->origin.longitude) * proj->metersPerDegreeLongitude;
+   *y = (p->latitude - proj->origin.latitude) * GP_METERS_PER_DEGREE;
+}
+
+float distSquaredProjected(const GeoProjection *proj, const GeoPoint *a, const GeoPoint *b) {
+   const float dx = (b->longitude - a->longitude) * proj->metersPerDegreeLongitude;
+   const float dy = (b->latitude - a->latitude) * GP_METERS_PER_DEGREE;
+
+   return dx * dx + dy * dy;
+}
+
 int isValidPoint(const GeoPoint *p) {
    return p->latitude != 0.0 || p->longitude != 0.0;
 }
@@ -5,25 +5,32 @@
 #include "geoCircle.h"
 #include "launch_control.h"
 #include "loggerHardware.h"
+#include "loggerTaskEx.h"
 #include "LED.h"
 #include "loggerConfig.h"
 #include "modp_numtoa.h"
 #include "modp_atonum.h"
 #include "mod_string.h"
+#include "nmea.h"
 #include "predictive_timer_2.h"
 #include "printk.h"
 #include "tracks.h"
 
 
+#include <math.h>
 #include <stdint.h>
 
 #define GPS_LOCK_FLASH_COUNT 5
 #define GPS_NOFIX_FLASH_COUNT 50
-#define LATITUDE_DATA_LEN 12
-#define LONGITUDE_DATA_LEN 13
 #define UTC_TIME_BUFFER_LEN 11
 #define UTC_SPEED_BUFFER_LEN 10
 
+#define DEGREES_TO_RADIANS (3.14159265f / 180)
+#define CM_PER_SEC_TO_KPH (0.036f)
+
+/* A new fast lap is flashed once slower than this, usually in the pits */
+#define SAVE_FAST_LAP_SPEED_KPH	5.0f
+
 // In Millis now.
 #define START_FINISH_TIME_THRESHOLD 10000
 
@@ -45,12 +52,18 @@ static enum GpsSignalQuality g_gpsQuality;
 
 static int g_satellitesUsedForPosition;
 
+static tiny_millis_t g_prevFixMillis;
+static tiny_millis_t g_fixMillis;
+
 static int g_atStartFinish;
-static int g_prevAtStartFinish;
+static struct GeoCircle g_startFinishCircle;
+static struct GeoCirclePass g_startFinishPass;
 static tiny_millis_t g_lastStartFinishTimestamp;
+static GeoPoint g_lastStartFinishPoint;
 
 static int g_atTarget;
-static int g_prevAtTarget;
+static struct GeoCircle g_sectorCircle;
+static struct GeoCirclePass g_sectorPass;
 static tiny_millis_t g_lastSectorTimestamp;
 
 static int g_sector;
@@ -70,6 +83,27 @@ static DateTime g_dtLastFix;
 static millis_t g_utcMillisAtSample;
 static tiny_millis_t g_uptimeAtSample;
 
+/**
+ * The last few fixes as logged, for estimating values between fixes.  The
+ * logger reads the latest two while the next one is written into the third.
+ */
+enum GpsFixValue {
+   GPS_FIX_LATITUDE,
+   GPS_FIX_LONGITUDE,
+   GPS_FIX_SPEED,
+   GPS_FIX_DISTANCE,
+   GPS_FIX_VALUES
+};
+
+struct GpsFix {
+   tiny_millis_t uptime;
+   float values[GPS_FIX_VALUES];
+};
+
+#define GPS_FIX_HISTORY 3
+static struct GpsFix g_fixes[GPS_FIX_HISTORY];
+static volatile size_t g_fixCount;
+
 static float degreesToMeters(float degrees) {
    // There are 110574.27 meters per degree of latitude at the equator.
    return degrees * 110574.27;
@@ -120,6 +154,58 @@ tiny_millis_t getUptimeAtSample() {
    return g_uptimeAtSample;
 }
 
+static void recordFix() {
+   struct GpsFix *fix = g_fixes + (g_fixCount + 1) % GPS_FIX_HISTORY;
+   fix->uptime = g_uptimeAtSample;
+   fix->values[GPS_FIX_LATITUDE] = g_latitude;
+   fix->values[GPS_FIX_LONGITUDE] = g_longitude;
+   fix->values[GPS_FIX_SPEED] = g_speed;
+   fix->values[GPS_FIX_DISTANCE] = g_distance;
+   g_fixCount++;
+}
+
+/**
+ * Carries the line through the last two fixes on to the current uptime.  Never goes further
+ * than one fix interval past the latest fix, so a lost fix is held rather than run away with.
+ */
+static float extrapolateFixValue(enum GpsFixValue value, float current) {
+   const size_t count = g_fixCount;
+   if (count < 2)
+      return current;
+
+   const struct GpsFix *fix = g_fixes + count % GPS_FIX_HISTORY;
+   const struct GpsFix *prev = g_fixes + (count - 1) % GPS_FIX_HISTORY;
+   const tiny_millis_t interval = fix->uptime - prev->uptime;
+   if (interval <= 0)
+      return fix->values[value];
+
+   float t = (float) (getUptime() - fix->uptime) / interval;
+   if (t < 0)
+      t = 0;
+   if (t > 1)
+      t = 1;
+
+   return fix->values[value] + (fix->values[value] - prev->values[value]) * t;
+}
+
+float getExtrapolatedLatitude() {
+   return extrapolateFixValue(GPS_FIX_LATITUDE, getLatitude());
+}
+
+float getExtrapolatedLongitude() {
+   return extrapolateFixValue(GPS_FIX_LONGITUDE, getLongitude());
+}
+
+float getExtrapolatedGpsSpeedInMph() {
+   return extrapolateFixValue(GPS_FIX_SPEED, getGPSSpeed()) * 0.621371192;
+}
+
+float getExtrapolatedGpsDistanceMiles() {
+   // Distance restarts every lap; only carry it forward while it is growing.
+   const float distance = extrapolateFixValue(GPS_FIX_DISTANCE, g_distance);
+   return KMS_TO_MILES_CONSTANT * (distance > g_distance ? distance : g_distance);
+}
+
 /**
  * Performs a full update of the g_dtLastFix value.  Also update the g_dtFirstFix value if it hasn't
  * already been set along with updating the Milliseconds as well
@@ -153,157 +239,48 @@ int atoiOffsetLenSafe(const char *str, size_t offset, size_t len) {
    return modp_atoi(buff);
 }
 
-static float parseLatitude(char *data){
-   unsigned int len = strlen(data);
-
-   if (len <= 0 && len > LATITUDE_DATA_LEN)
-      return 0.0;
-
-   //Raw GPS Format is ddmm.mmmmmm
-   int degrees = atoiOffsetLenSafe(data, 0, 2);
-   float minutes = modp_atof(data + 2);
+static float parseCoordinate(const char *data, size_t degreeDigits, const char *hemisphere){
+   //Raw GPS Format is ddmm.mmmmmm or dddmm.mmmmmm; parsed as fixed point
+   int32_t coordinate = nmea_parse_coordinate(data, degreeDigits);
+   if (hemisphere[0] == 'S' || hemisphere[0] == 'W')
+      coordinate = -coordinate;
 
-   return degrees + (minutes / 60);
-}
-
-static float parseLongitude(char *data){
-   unsigned int len = strlen(data);
-
-   if (len <= 0 && len > LONGITUDE_DATA_LEN)
-      return 0.0;
-
-   //Raw GPS Format is dddmm.mmmmmm
-   int degrees = atoiOffsetLenSafe(data, 0, 3);
-   float minutes = modp_atof(data + 3);
-
-   return degrees + (minutes / 60);
+   return coordinate / (float) NMEA_COORDINATE_SCALE;
 }
 
 //Parse Global Positioning System Fix Data.
-static void parseGGA(char *data) {
-   char * delim = strchr(data, ',');
-   int param = 0;
-   int keepParsing = 1;
-
-   while (delim != NULL && keepParsing) {
-      *delim = '\0';
-      switch (param) {
-         /*
-      case 1: {
-         unsigned int len = strlen(data);
-         if (len > 0 && len <= LATITUDE_DATA_LEN) {
-            //Raw GPS Format is ddmm.mmmmmm
-            char degreesStr[3] = { 0 };
-            memcpy(degreesStr, data, 2);
-            degreesStr[2] = 0;
-            float minutes = modp_atof(data + 2);
-            minutes = minutes / 60.0;
-            latitude = modp_atoi(degreesStr) + minutes;
-         } else {
-            latitude = 0;
-            //TODO log error
-         }
-      }
-         break;
-      case 2: {
-         if (data[0] == 'S') {
-            latitude = -latitude;
-         }
-      }
-         break;
-      case 3: {
-         unsigned int len = strlen(data);
-         if (len > 0 && len <= LONGITUDE_DATA_LEN) {
-            //Raw GPS Format is dddmm.mmmmmm
-            char degreesStr[4] = { 0 };
-            memcpy(degreesStr, data, 3);
-            degreesStr[3] = 0;
-            float minutes = modp_atof(data + 3);
-            minutes = minutes / 60.0;
-            longitude = modp_atoi(degreesStr) + minutes;
-         } else {
-            longitude = 0;
-            //TODO log error
-         }
-      }
-         break;
-      case 4: {
-         if (data[0] == 'W') {
-            longitude = -longitude;
-         }
-      }
-         break;
-      case 5:
-         g_gpsQuality = (enum GpsSignalQuality) modp_atoi(data);
-         break;
-      case 6:
-         g_satellitesUsedForPosition = modp_atoi(data);
-         keepParsing = 0;
-         break;
-         */ // Kept until Full sanity checks pass.
-
-      case 5:
-         // FIXME: Better suport fo GPS quality here?
-         g_gpsQuality = modp_atoi(data) > 0 ? GPS_QUALITY_FIX : GPS_QUALITY_NO_FIX;
-         break;
-
-      case 6:
-         g_satellitesUsedForPosition = modp_atoi(data);
-         keepParsing = 0;
-         break;
-
-      }
-
-      param++;
-      data = delim + 1;
-      delim = strchr(data, ',');
-   }
+static void parseGGA(const NmeaSentence *nmea) {
+   // FIXME: Better suport fo GPS quality here?
+   g_gpsQuality = modp_atoi(nmea_field(nmea, 5)) > 0 ? GPS_QUALITY_FIX : GPS_QUALITY_NO_FIX;
+   g_satellitesUsedForPosition = modp_atoi(nmea_field(nmea, 6));
 }
 
 void updatePosition(float latitude, float longitude) {
    g_prevLatitude = g_latitude;
    g_prevLongitude = g_longitude;
+   g_prevFixMillis = g_fixMillis;
+   g_fixMillis = getMillisSinceFirstFix();
    g_longitude = longitude;
    g_latitude = latitude;
 }
 
 //Parse GNSS DOP and Active Satellites
-static void parseGSA(char *data) {}
+static void parseGSA(const NmeaSentence *nmea) {}
 
 //Parse Course Over Ground and Ground Speed
-static void parseVTG(char *data) {
-
-   char * delim = strchr(data, ',');
-   int param = 0;
-
-   int keepParsing = 1;
-   while (delim != NULL && keepParsing) {
-      *delim = '\0';
-      switch (param) {
-      case 6: //Speed over ground
-      {
-         if (strlen(data) >= 1) {
-            setGPSSpeed(modp_atof(data)); //convert to MPH
-         }
-         keepParsing = 0;
-      }
-         break;
-      default:
-         break;
-      }
-      param++;
-      data = delim + 1;
-      delim = strchr(data, ',');
-   }
+static void parseVTG(const NmeaSentence *nmea) {
+   const char *speed = nmea_field(nmea, 6); //Speed over ground
+   if (speed[0] != '\0')
+      setGPSSpeed(modp_atof(speed));
 }
 
 //Parse Geographic Position - Latitude / Longitude
-static void parseGLL(char *data) {
+static void parseGLL(const NmeaSentence *nmea) {
 
 }
 
 //Parse Time & Date
-static void parseZDA(char *data) {
+static void parseZDA(const NmeaSentence *nmea) {
    /*
     $GPZDA
 
@@ -323,12 +300,12 @@ static void parseZDA(char *data) {
 }
 
 //Parse GNSS Satellites in View
-static void parseGSV(char *data) {
+static void parseGSV(const NmeaSentence *nmea) {
 
 }
 
 //Parse Recommended Minimum Navigation Information
-static void parseRMC(char *data) {
+static void parseRMC(const NmeaSentence *nmea) {
    /*
     * $GPRMC,053740.000,A,2503.6319,N,12136.0099,E,2.69,79.65,100106,,,A*53
     * Message ID $GPRMC RMC protocol header
@@ -350,53 +327,26 @@ static void parseRMC(char *data) {
     * <CR> <LF> End of message termination
     */
 
-   char *delim = strchr(data, ',');
-   int param = 0;
    DateTime dt = { 0 };
-   float latitude = 0.0;
-   float longitude = 0.0;
-
-   while (delim) {
-      *delim = '\0';
-      switch (param) {
-      case 0: //UTC Time (HHMMSS.SSS)
-         dt.hour = (int8_t) atoiOffsetLenSafe(data, 0, 2);
-         dt.minute = (int8_t) atoiOffsetLenSafe(data, 2, 2);
-         dt.second = (int8_t) atoiOffsetLenSafe(data, 4, 2);
-         dt.millisecond = (int16_t) atoiOffsetLenSafe(data, 7, 3);
-         break;
-
-      case 2:
-    	 latitude = parseLatitude(data);
-         break;
-
-      case 3:
-         if (data[0] == 'S') latitude = -latitude;
-         break;
-
-      case 4:
-    	 longitude = parseLongitude(data);
-         break;
-
-      case 5:
-         if (data[0] == 'W') longitude = -longitude;
-         break;
-
-      case 6: //Speed over ground
-         if (strlen(data) >= 1) setGPSSpeed(modp_atof(data) * KNOTS_TO_KPH);
-         break;
-
-      case 8: //Date (DDMMYY)
-         dt.day = (int8_t) atoiOffsetLenSafe(data, 0, 2);
-         dt.month = (int8_t) atoiOffsetLenSafe(data, 2, 2);
-         dt.year = (int16_t) atoiOffsetLenSafe(data, 4, 2) + 2000;
-         break;
-      }
 
-      ++param;
-      data = ++delim;
-      delim = strchr(delim, ',');
-   }
+   //UTC Time (HHMMSS.SSS)
+   const char *time = nmea_field(nmea, 0);
+   dt.hour = (int8_t) atoiOffsetLenSafe(time, 0, 2);
+   dt.minute = (int8_t) atoiOffsetLenSafe(time, 2, 2);
+   dt.second = (int8_t) atoiOffsetLenSafe(time, 4, 2);
+   dt.millisecond = (int16_t) atoiOffsetLenSafe(time, 7, 3);
+
+   float latitude = parseCoordinate(nmea_field(nmea, 2), 2, nmea_field(nmea, 3));
+   float longitude = parseCoordinate(nmea_field(nmea, 4), 3, nmea_field(nmea, 5));
+
+   const char *speed = nmea_field(nmea, 6); //Speed over ground
+   if (speed[0] != '\0') setGPSSpeed(modp_atof(speed) * KNOTS_TO_KPH);
+
+   //Date (DDMMYY)
+   const char *date = nmea_field(nmea, 8);
+   dt.day = (int8_t) atoiOffsetLenSafe(date, 0, 2);
+   dt.month = (int8_t) atoiOffsetLenSafe(date, 2, 2);
+   dt.year = (int16_t) atoiOffsetLenSafe(date, 4, 2) + 2000;
 
    updateFullDateTime(dt);
    updatePosition(latitude, longitude);
@@ -525,6 +475,43 @@ static float calcDistancesSinceLastSample() {
    return distPythag(&prev, &curr) / 1000;
 }
 
+/**
+ * Finds where the path between the last two fixes crossed the center of the
+ * target, with the time there interpolated between the two fixes.  Lap and
+ * sector times are then not limited to the period between fixes.
+ * @return true if the target was crossed, false otherwise.
+ */
+static bool getTargetCrossing(struct GeoCirclePass *pass, const struct GeoCircle target,
+                              GeoPoint *point, tiny_millis_t *time) {
+   const GeoPoint prev = {g_prevLatitude, g_prevLongitude};
+   const GeoPoint curr = {g_latitude, g_longitude};
+
+   const float t = gc_updatePass(pass, target, prev, curr);
+   if (t < 0)
+      return false;
+
+   if (!isValidPoint(&prev)) {
+      *point = curr;
+      *time = g_fixMillis;
+      return true;
+   }
+
+   point->latitude = prev.latitude + t * (curr.latitude - prev.latitude);
+   point->longitude = prev.longitude + t * (curr.longitude - prev.longitude);
+   *time = g_prevFixMillis + (tiny_millis_t) (t * (g_fixMillis - g_prevFixMillis) + 0.5f);
+   return true;
+}
+
+/**
+ * Moves sector tracking on to the given sector boundary.
+ */
+static void setSector(const Track *track, const float targetRadius, const int sector) {
+   g_sector = sector;
+   g_sectorCircle = gc_createGeoCircle(getSectorGeoPointAtIndex(track, sector),
+                                       targetRadius);
+   gc_resetPass(&g_sectorPass);
+}
+
 static int processStartFinish(const Track *track, const float targetRadius) {
    const struct GpsSample gpss = getGpsSample();
 
@@ -535,42 +522,35 @@ static int processStartFinish(const Track *track, const float targetRadius) {
       if (lc_hasLaunched()) {
          g_lastStartFinishTimestamp = lc_getLaunchTime();
          g_lastSectorTimestamp = lc_getLaunchTime();
-         g_prevAtStartFinish = 1;
-         g_sector = 0;
+         g_lastStartFinishPoint = getStartPoint(track);
+         setSector(track, targetRadius, 0);
          return true;
       }
 
       return false;
    }
 
-   const tiny_millis_t timestamp = getMillisSinceFirstFix();
-   const tiny_millis_t elapsed = timestamp - g_lastStartFinishTimestamp;
-   const struct GeoCircle sfCircle = gc_createGeoCircle(getFinishPoint(track),
-                                                        targetRadius);
+   g_atStartFinish = gc_isPointInGeoCircle(gpss.point, g_startFinishCircle);
+
+   GeoPoint point;
+   tiny_millis_t timestamp;
+   if (!getTargetCrossing(&g_startFinishPass, g_startFinishCircle, &point, &timestamp))
+      return false;
 
    /*
-    * Guard against false triggering. We have to be out of the start/finish
-    * target for some amount of time and couldn't have been in there during our
-    * last time in this method.
-    *
-    * FIXME: Should have logic that checks that we left the start/finish circle
-    * for some time.
+    * Guard against false triggering.  Each pass through the target crosses
+    * it once, but jitter while crawling at its edge can start a new pass.
     */
-   g_atStartFinish = gc_isPointInGeoCircle(gpss.point, sfCircle);
-
-   if (!g_atStartFinish || g_prevAtStartFinish != 0 ||
-       elapsed <= START_FINISH_TIME_THRESHOLD) {
-      g_prevAtStartFinish = 0;
+   const tiny_millis_t elapsed = timestamp - g_lastStartFinishTimestamp;
+   if (elapsed <= START_FINISH_TIME_THRESHOLD)
       return false;
-   }
 
-   // If here, we are at Start/Finish and have de-bounced duplicate entries.
    pr_debug_int(g_lapCount);
    pr_debug(" Lap Detected\r\n");
    g_lapCount++;
    g_lastLapTime = elapsed;
    g_lastStartFinishTimestamp = timestamp;
-   g_prevAtStartFinish = 1;
+   g_lastStartFinishPoint = point;
 
    return true;
 }
@@ -580,32 +560,27 @@ static void processSector(const Track *track, float targetRadius) {
    if (!isStartCrossedYet())
       return;
 
-   const GeoPoint point = getSectorGeoPointAtIndex(track, g_sector);
-   const struct GeoCircle sbCircle = gc_createGeoCircle(point, targetRadius);
+   g_atTarget = gc_isPointInGeoCircle(getGeoPoint(), g_sectorCircle);
 
-   g_atTarget = gc_isPointInGeoCircle(getGeoPoint(), sbCircle);
-   if (!g_atTarget) {
-      g_prevAtTarget = 0;
+   GeoPoint crossing;
+   tiny_millis_t millis;
+   if (!getTargetCrossing(&g_sectorPass, g_sectorCircle, &crossing, &millis))
       return;
-   }
 
    /*
-    * Past here we are sure we are at a sector boundary.
+    * Past here we are sure we passed a sector boundary.
     */
-   const tiny_millis_t millis = getMillisSinceFirstFix();
    pr_debug_int(g_sector);
    pr_debug(" Sector Boundary Detected\r\n");
 
-   g_prevAtTarget = 1;
    g_lastSectorTime = millis - g_lastSectorTimestamp;
    g_lastSectorTimestamp = millis;
    g_lastSector = g_sector;
-   ++g_sector;
 
    // Check if we need to wrap the sectors.
-   GeoPoint next = getSectorGeoPointAtIndex(track, g_sector);
-   if (areGeoPointsEqual(point, next))
-      g_sector = 0;
+   const GeoPoint point = getSectorGeoPointAtIndex(track, g_sector);
+   const GeoPoint next = getSectorGeoPointAtIndex(track, g_sector + 1);
+   setSector(track, targetRadius, areGeoPointsEqual(point, next) ? 0 : g_sector + 1);
 }
 
 void gpsConfigChanged(void) {
@@ -626,11 +601,14 @@ void initGPS() {
    g_speed = 0.0;
    g_lastLapTime = 0;
    g_lastSectorTime = 0;
+   g_prevFixMillis = 0;
+   g_fixMillis = 0;
    g_atStartFinish = 0;
-   g_prevAtStartFinish = 0;
    g_lastStartFinishTimestamp = 0;
+   g_lastStartFinishPoint = (GeoPoint) { 0 };
    g_atTarget = 0;
-   g_prevAtTarget = 0;
+   gc_resetPass(&g_startFinishPass);
+   gc_resetPass(&g_sectorPass);
    g_lastSectorTimestamp = 0;
    g_lapCount = 0;
    g_distance = 0;
@@ -639,6 +617,7 @@ void initGPS() {
    resetPredictiveTimer();
    g_dtFirstFix = g_dtLastFix = (DateTime) { 0 };
    g_uptimeAtSample = 0;
+   g_fixCount = 0;
 }
 
 static void flashGpsStatusLed() {
@@ -693,6 +672,10 @@ void onLocationUpdated() {
       startFinishEnabled = isStartFinishEnabled(g_activeTrack);
       sectorEnabled = isSectorTrackingEnabled(g_activeTrack);
       lc_setup(g_activeTrack, targetRadius);
+      g_startFinishCircle = gc_createGeoCircle(getFinishPoint(g_activeTrack), targetRadius);
+      setSector(g_activeTrack, targetRadius, g_sector);
+      if (startFinishEnabled && !isPredictiveTimeAvailable())
+         loadFastLap(g_activeTrack);
       g_configured = 1;
    }
 
@@ -720,7 +703,8 @@ void onLocationUpdated() {
             startFinishCrossed(sp, g_lastStartFinishTimestamp);
             addGpsSample(gp, millisSinceFirstFix);
          } else {
-            startFinishCrossed(gp, millisSinceFirstFix);
+            startFinishCrossed(g_lastStartFinishPoint, g_lastStartFinishTimestamp);
+            addGpsSample(gp, millisSinceFirstFix);
          }
       } else {
          addGpsSample(gp, millisSinceFirstFix);
@@ -728,61 +712,87 @@ void onLocationUpdated() {
 
       if (sectorEnabled)
          processSector(g_activeTrack, targetRadius);
+
+      /*
+       * Erasing the flash sector stalls every task, so wait until logging has
+       * stopped and the car is standing still.
+       */
+      if (!isFastLapSaved() && !isLogging() && getGPSSpeed() < SAVE_FAST_LAP_SPEED_KPH)
+         saveFastLap(g_activeTrack);
    }
 
 }
 
-int checksumValid(const char *gpsData, size_t len) {
-   int valid = 0;
-   unsigned char checksum = 0;
-   size_t i = 0;
-   for (; i < len - 1; i++) {
-      char c = *(gpsData + i);
-      if (c == '*' || c == '\0')
-         break;
-      else if (c == '$')
-         continue;
-      else
-         checksum ^= c;
-   }
-   if (len > i + 2) {
-      unsigned char dataChecksum = modp_xtoc(gpsData + i + 1);
-      if (checksum == dataChecksum)
-         valid = 1;
-   }
-   return valid;
-}
+typedef void (*nmea_parser_t)(const NmeaSentence *nmea);
+
+static const struct {
+   uint32_t type;
+   nmea_parser_t parse;
+   int positionUpdate;
+} g_nmeaParsers[] = {
+   { NMEA_TYPE('G', 'G', 'A'), parseGGA, 0 },
+   { NMEA_TYPE('V', 'T', 'G'), parseVTG, 0 }, //Course Over Ground and Ground Speed
+   { NMEA_TYPE('G', 'S', 'A'), parseGSA, 0 }, //GPS Fix gpsData
+   { NMEA_TYPE('G', 'S', 'V'), parseGSV, 0 }, //Satellites in view
+   { NMEA_TYPE('R', 'M', 'C'), parseRMC, 1 }, //Recommended Minimum Specific GNSS Data
+   { NMEA_TYPE('G', 'L', 'L'), parseGLL, 0 }, //Geographic Position - Latitude/Longitude
+   { NMEA_TYPE('Z', 'D', 'A'), parseZDA, 0 }, //Time & Date
+};
 
 void processGPSData(char *gpsData, size_t len) {
-   if (len <= 4 || !checksumValid(gpsData, len) || strstr(gpsData, "$GP") != gpsData) {
+   NmeaSentence nmea;
+   if (!nmea_tokenize(gpsData, len, &nmea) || nmea.talker[0] != 'G' || nmea.talker[1] != 'P') {
       pr_trace("GPS: corrupt frame ");
       pr_trace(gpsData);
       pr_trace("\r\n");
       return;
    }
-   size_t positionUpdated = 0;
-
-   // Advance the pointer 3 spaces since we know it begins with "$GP"
-   gpsData += 3;
-   if (strstr(gpsData, "GGA,")) {
-      parseGGA(gpsData + 4);
-   } else if (strstr(gpsData, "VTG,")) { //Course Over Ground and Ground Speed
-      parseVTG(gpsData + 4);
-   } else if (strstr(gpsData, "GSA,")) { //GPS Fix gpsData
-      parseGSA(gpsData + 4);
-   } else if (strstr(gpsData, "GSV,")) { //Satellites in view
-      parseGSV(gpsData + 4);
-   } else if (strstr(gpsData, "RMC,")) { //Recommended Minimum Specific GNSS Data
-      parseRMC(gpsData + 4);
-      positionUpdated = 1;
-   } else if (strstr(gpsData, "GLL,")) { //Geographic Position - Latitude/Longitude
-      parseGLL(gpsData + 4);
-   } else if (strstr(gpsData, "ZDA,")) { //Time & Date
-      parseZDA(gpsData + 4);
+
+   for (size_t i = 0; i < sizeof(g_nmeaParsers) / sizeof(g_nmeaParsers[0]); i++) {
+      if (g_nmeaParsers[i].type != nmea.type)
+         continue;
+
+      g_nmeaParsers[i].parse(&nmea);
+      if (g_nmeaParsers[i].positionUpdate && !isGpsDataCold()) {
+         onLocationUpdated();
+         recordFix();
+         flashGpsStatusLed();
+      }
+      break;
    }
+}
+
+/*
+ * Ground speed from an earth centered velocity: the part of the velocity
+ * along the local vertical at the fix is removed.
+ */
+static float groundSpeedFromEcef(const int32_t *velocity, float latitude, float longitude) {
+   const float lat = latitude * DEGREES_TO_RADIANS;
+   const float lon = longitude * DEGREES_TO_RADIANS;
+   const float vx = velocity[0], vy = velocity[1], vz = velocity[2];
+
+   const float up = vx * cosf(lat) * cosf(lon) + vy * cosf(lat) * sinf(lon) + vz * sinf(lat);
+   float horizontal = vx * vx + vy * vy + vz * vz - up * up;
+   if (horizontal < 0)
+      horizontal = 0;
+
+   return sqrtf(horizontal) * CM_PER_SEC_TO_KPH;
+}
+
+void processGPSNavData(const GpsNavData *nav) {
+   g_gpsQuality = nav->quality;
+   g_satellitesUsedForPosition = nav->satellites;
+
+   const float latitude = nav->latitude / (float) NMEA_COORDINATE_SCALE;
+   const float longitude = nav->longitude / (float) NMEA_COORDINATE_SCALE;
+   setGPSSpeed(groundSpeedFromEcef(nav->ecefVelocity, latitude, longitude));
+
+   updateFullDateTime(getDateTimeFromMillisecondsSinceUnixEpoch(nav->utcMillis));
+   updatePosition(latitude, longitude);
 
-   if (positionUpdated && !isGpsDataCold()) {
+   if (!isGpsDataCold()) {
       onLocationUpdated();
+      recordFix();
       flashGpsStatusLed();
    }
 }
@@ -8,6 +8,7 @@
 #include "gps.h"
 #include "gps_device.h"
 #include "FreeRTOS.h"
+#include "loggerConfig.h"
 #include "printk.h"
 #include "task.h"
 #include "serial.h"
@@ -35,11 +36,20 @@ static void logGpsInput(const char *buf, int len) {
 
 void GPSTask(void *pvParameters) {
 	Serial *gpsSerial = get_serial(SERIAL_GPS);
-	int rc = GPS_device_provision(gpsSerial);
+	unsigned char navFormat = getWorkingLoggerConfig()->GPSConfigs.navFormat;
+	int rc = GPS_device_provision(gpsSerial, &navFormat);
 	if (!rc){
 		pr_error("Error provisioning GPS module\r\n");
 	}
 
+	if (navFormat == GPS_NAV_FORMAT_BINARY) {
+		GpsNavData nav;
+		for (;;) {
+			if (GPS_device_read_nav_data(gpsSerial, &nav))
+				processGPSNavData(&nav);
+		}
+	}
+
 	for (;;) {
       int len = gpsSerial->get_line(g_GPSdataLine, GPS_DATA_LINE_BUFFER_LEN - 1);
       g_GPSdataLine[len] = '\0';
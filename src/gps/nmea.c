@@ -0,0 +1,77 @@
+/*
+ * nmea.c
+ *
+ * Single pass NMEA 0183 tokenizer; see nmea.h.
+ */
+#include "nmea.h"
+
+#define NMEA_ADDRESS_LEN	5
+
+static int hexDigit(char c){
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+int nmea_tokenize(char *sentence, size_t len, NmeaSentence *nmea){
+	if (len < NMEA_ADDRESS_LEN + 4 || sentence[0] != '$') return 0;
+
+	unsigned char checksum = 0;
+	size_t fieldCount = 0;
+	size_t addressEnd = 0;
+	size_t i = 1;
+	for (; i < len; i++){
+		char c = sentence[i];
+		if (c == '*') break;
+		if (c == '\0' || c == '\r' || c == '\n') return 0;
+		checksum ^= c;
+		if (c == ',' && fieldCount < NMEA_MAX_FIELDS){
+			if (addressEnd == 0) addressEnd = i;
+			nmea->fields[fieldCount++] = sentence + i + 1;
+		}
+	}
+
+	if (i + 2 >= len || addressEnd != NMEA_ADDRESS_LEN + 1) return 0;
+	int high = hexDigit(sentence[i + 1]);
+	int low = hexDigit(sentence[i + 2]);
+	if (high < 0 || low < 0 || checksum != ((high << 4) | low)) return 0;
+
+	nmea->talker[0] = sentence[1];
+	nmea->talker[1] = sentence[2];
+	nmea->type = NMEA_TYPE(sentence[3], sentence[4], sentence[5]);
+
+	for (size_t f = 0; f < fieldCount; f++){
+		nmea->fields[f][-1] = '\0';
+	}
+	sentence[i] = '\0';
+	nmea->fieldCount = fieldCount;
+	return 1;
+}
+
+const char * nmea_field(const NmeaSentence *nmea, size_t index){
+	return index < nmea->fieldCount ? nmea->fields[index] : "";
+}
+
+int32_t nmea_parse_coordinate(const char *field, size_t degreeDigits){
+	int32_t degrees = 0;
+	for (size_t i = 0; i < degreeDigits; i++, field++){
+		if (*field < '0' || *field > '9') return 0;
+		degrees = degrees * 10 + (*field - '0');
+	}
+
+	/* minutes scaled by NMEA_COORDINATE_SCALE; two digits keep it below 1e9, which fits */
+	int32_t minutes = 0;
+	for (size_t i = 0; i < 2 && *field >= '0' && *field <= '9'; i++, field++){
+		minutes = minutes * 10 + (*field - '0');
+	}
+	minutes *= NMEA_COORDINATE_SCALE;
+	if (*field == '.'){
+		int32_t scale = NMEA_COORDINATE_SCALE;
+		for (field++; *field >= '0' && *field <= '9' && scale > 1; field++){
+			scale /= 10;
+			minutes += (*field - '0') * scale;
+		}
+	}
+	return degrees * NMEA_COORDINATE_SCALE + (minutes + 30) / 60;
+}
@@ -0,0 +1,173 @@
+/*
+ * binaryLogFormat.c
+ *
+ * Encoder for the compact binary log file; see binaryLogFormat.h for the layout.
+ */
+#include "binaryLogFormat.h"
+#include "crc16.h"
+#include "mod_string.h"
+
+static void pack_uint16(uint8_t *buf, uint16_t value){
+	buf[0] = value & 0xff;
+	buf[1] = (value >> 8) & 0xff;
+}
+
+static void pack_uint32(uint8_t *buf, uint32_t value){
+	for (size_t i = 0; i < 4; i++, value >>= 8){
+		buf[i] = value & 0xff;
+	}
+}
+
+static void pack_uint64(uint8_t *buf, uint64_t value){
+	for (size_t i = 0; i < 8; i++, value >>= 8){
+		buf[i] = value & 0xff;
+	}
+}
+
+static void pack_float(uint8_t *buf, float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	pack_uint32(buf, bits);
+}
+
+static void pack_double(uint8_t *buf, double value){
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	pack_uint64(buf, bits);
+}
+
+enum BinaryLogValueType binary_log_value_type(enum SampleData sampleData){
+	switch(sampleData){
+		case SampleData_LongLong:
+		case SampleData_LongLong_Noarg:
+			return BinaryLogValueType_Int64;
+		case SampleData_Float:
+		case SampleData_Float_Noarg:
+		case SampleData_Float_Planned:
+			return BinaryLogValueType_Float32;
+		case SampleData_Double:
+		case SampleData_Double_Noarg:
+			return BinaryLogValueType_Float64;
+		case SampleData_Int:
+		case SampleData_Int_Noarg:
+		default:
+			return BinaryLogValueType_Int32;
+	}
+}
+
+void binary_log_encode_channel_meta(uint8_t *meta, const ChannelSample *sample){
+	const ChannelConfig *cfg = sample->cfg;
+	uint8_t *field = meta;
+
+	memset(meta, 0, BINARY_LOG_CHANNEL_META_SIZE);
+	strlcpy((char *)field, cfg->label, DEFAULT_LABEL_LENGTH);
+	field += DEFAULT_LABEL_LENGTH;
+	strlcpy((char *)field, cfg->units, DEFAULT_UNITS_LENGTH);
+	field += DEFAULT_UNITS_LENGTH;
+	pack_float(field, cfg->min);
+	field += 4;
+	pack_float(field, cfg->max);
+	field += 4;
+	pack_uint16(field, decodeSampleRate(cfg->sampleRate));
+	field += 2;
+	*field++ = cfg->precision;
+	*field++ = binary_log_value_type(sample->sampleData);
+}
+
+uint8_t binary_log_encode_mask(const ChannelSample *samples, size_t channelCount){
+	uint8_t mask = 0;
+	for (size_t bit = 0; bit < 8 && bit < channelCount; bit++){
+		if (samples[bit].populated) mask |= (1 << bit);
+	}
+	return mask;
+}
+
+size_t binary_log_encode_value(uint8_t *value, const ChannelSample *sample){
+	enum BinaryLogValueType type = binary_log_value_type(sample->sampleData);
+	switch(type){
+		case BinaryLogValueType_Int64:
+			pack_uint64(value, (uint64_t)sample->valueLongLong);
+			break;
+		case BinaryLogValueType_Float32:
+			pack_float(value, sample->valueFloat);
+			break;
+		case BinaryLogValueType_Float64:
+			pack_double(value, sample->valueDouble);
+			break;
+		case BinaryLogValueType_Int32:
+		default:
+			pack_uint32(value, (uint32_t)sample->valueInt);
+			break;
+	}
+	return BINARY_LOG_VALUE_SIZE(type);
+}
+
+size_t binary_log_record_length(const ChannelSample *samples, size_t channelCount){
+	size_t length = BINARY_LOG_MASK_SIZE(channelCount);
+	if (get_fix_sample(samples, channelCount))
+		length += BINARY_LOG_FIX_TIME_SIZE;
+
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		if (samples->populated){
+			length += BINARY_LOG_VALUE_SIZE(binary_log_value_type(samples->sampleData));
+		}
+	}
+	return length;
+}
+
+void binary_log_write_header(binary_log_write_func write, const ChannelSample *samples,
+		size_t channelCount, uint32_t fileId){
+	uint8_t preamble[BINARY_LOG_PREAMBLE_SIZE];
+	memcpy(preamble, BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_LENGTH);
+	preamble[BINARY_LOG_MAGIC_LENGTH] = BINARY_LOG_VERSION;
+	pack_uint16(preamble + BINARY_LOG_MAGIC_LENGTH + 1, channelCount);
+	pack_uint32(preamble + BINARY_LOG_MAGIC_LENGTH + 3, fileId);
+	write(preamble, sizeof(preamble));
+
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		uint8_t meta[BINARY_LOG_CHANNEL_META_SIZE];
+		binary_log_encode_channel_meta(meta, samples);
+		if (samples->fixTimestamped)
+			meta[BINARY_LOG_CHANNEL_META_SIZE - 1] |= BINARY_LOG_FIX_TIMESTAMPED;
+		write(meta, sizeof(meta));
+	}
+}
+
+size_t binary_log_write_record(binary_log_write_func write, const ChannelSample *samples,
+		size_t channelCount, uint32_t fileId){
+	const size_t length = binary_log_record_length(samples, channelCount);
+	const ChannelSample *fixSample = get_fix_sample(samples, channelCount);
+
+	uint8_t header[BINARY_LOG_RECORD_HEADER_SIZE] = {BINARY_LOG_RECORD_SYNC0, BINARY_LOG_RECORD_SYNC1};
+	pack_uint16(header + 2, length);
+	write(header, sizeof(header));
+	uint16_t crc = crc16_ccitt(BINARY_LOG_CRC_SEED(fileId), header + 2, 2);
+
+	for (size_t i = 0; i < channelCount; i += 8){
+		uint8_t mask = binary_log_encode_mask(samples + i, channelCount - i);
+		write(&mask, 1);
+		crc = crc16_ccitt(crc, &mask, 1);
+	}
+
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		if (!samples->populated)
+			continue;
+
+		uint8_t value[8];
+		size_t size = binary_log_encode_value(value, samples);
+		write(value, size);
+		crc = crc16_ccitt(crc, value, size);
+	}
+
+	if (fixSample){
+		uint8_t fixTime[BINARY_LOG_FIX_TIME_SIZE];
+		pack_uint32(fixTime, (uint32_t)fixSample->fixUptime);
+		write(fixTime, sizeof(fixTime));
+		crc = crc16_ccitt(crc, fixTime, sizeof(fixTime));
+	}
+
+	uint8_t trailer[BINARY_LOG_RECORD_CRC_SIZE];
+	pack_uint16(trailer, crc);
+	write(trailer, sizeof(trailer));
+	return BINARY_LOG_RECORD_HEADER_SIZE + length + BINARY_LOG_RECORD_CRC_SIZE;
+}
@@ -9,6 +9,8 @@
 #include "mod_string.h"
 #include "loggerHardware.h"
 #include "loggerApi.h"
+#include "telemetryFrame.h"
+#include "sampleDelta.h"
 #include "serial.h"
 #include "usart.h"
 #include "printk.h"
@@ -45,6 +47,8 @@
 #define BAD_MESSAGE_THRESHOLD					10
 
 #define METADATA_SAMPLE_INTERVAL				100
+//samples between full records when delta encoding
+#define KEYFRAME_SAMPLE_INTERVAL				METADATA_SAMPLE_INTERVAL
 
 static xQueueHandle g_sampleQueue[CONNECTIVITY_CHANNELS] = CONNECTIVITY_TASK_INIT;
 
@@ -88,7 +92,14 @@ void queueTelemetryRecord(LoggerMessage *msg){
     msg->ticks = getUptime();
 	for (size_t i = 0; i < CONNECTIVITY_CHANNELS; i++){
 		xQueueHandle queue = g_sampleQueue[i];
-		if (NULL != queue) xQueueSend(queue, &msg, TELEMETRY_QUEUE_WAIT_TIME);
+		if (NULL == queue) continue;
+		if (LoggerMessageType_Sample == msg->type &&
+				uxQueueMessagesWaiting(queue) >= SAMPLE_RECORD_PENDING_LIMIT) continue;
+
+		logger_message_retain(msg);
+		if (pdTRUE != xQueueSend(queue, &msg, TELEMETRY_QUEUE_WAIT_TIME)){
+			logger_message_release(msg);
+		}
 	}
 }
 
@@ -189,6 +200,10 @@ void connectivityTask(void *params) {
 	uint8_t isPrimary = connParams->isPrimary;
 	size_t periodicMeta = connParams->periodicMeta;
 	xQueueHandle sampleQueue = connParams->sampleQueue;
+	TelemetryConfig *telemetryConfig = &getWorkingLoggerConfig()->ConnectivityConfigs.telemetryConfig;
+
+	SampleDelta sampleDelta;
+	sample_delta_init(&sampleDelta);
 
 	DeviceConfig deviceConfig;
 	deviceConfig.serial = serial;
@@ -201,9 +216,13 @@ void connectivityTask(void *params) {
 			vTaskDelay(INIT_DELAY);
 		}
 		serial->flush();
+		//every new connection starts out in JSON until the client negotiates otherwise
+		set_telemetry_format(serial, TELEMETRY_FORMAT_DEFAULT);
 		rxCount = 0;
 		size_t badMsgCount = 0;
 		size_t tick = 0;
+		//format the channel meta was last sent in; a client switching format needs it again
+		enum TelemetryFormat metaFormat = TELEMETRY_FORMAT_DEFAULT;
 		while (1) {
 			//wait for the next sample record
 			char res = xQueueReceive(sampleQueue, &(msg), IDLE_TIMEOUT);
@@ -217,26 +236,51 @@ void connectivityTask(void *params) {
 			// Process a pending message from logger task, if exists
 			////////////////////////////////////////////////////////////
 			if (pdFALSE != res) {
+				const enum TelemetryFormat format = get_telemetry_format(serial);
+				int binary = (format == TelemetryFormat_Binary);
 				switch(msg->type){
 					case LoggerMessageType_Start:
 					{
-						api_sendLogStart(serial);
-						put_crlf(serial);
+						if (binary){
+							telemetry_send_event_frame(serial, TelemetryFrameType_Start);
+						}
+						else{
+							api_sendLogStart(serial);
+							put_crlf(serial);
+						}
 						tick = 0;
 						break;
 					}
 					case LoggerMessageType_Stop:
 					{
-						api_sendLogEnd(serial);
-						put_crlf(serial);
+						if (binary){
+							telemetry_send_event_frame(serial, TelemetryFrameType_End);
+						}
+						else{
+							api_sendLogEnd(serial);
+							put_crlf(serial);
+						}
 						break;
 					}
 					case LoggerMessageType_Sample:
 					{
-						int sendMeta = (tick == 0 || (periodicMeta && (tick % METADATA_SAMPLE_INTERVAL == 0)));
-						api_sendSampleRecord(serial, msg->channelSamples, msg->sampleCount, tick, sendMeta);
+						int sendMeta = (tick == 0 || format != metaFormat ||
+								(periodicMeta && (tick % METADATA_SAMPLE_INTERVAL == 0)));
+						metaFormat = format;
+						ChannelSample *samples = msg->channelSamples;
+						if (telemetryConfig->deltaEncoding){
+							if (tick % KEYFRAME_SAMPLE_INTERVAL == 0) sample_delta_keyframe(&sampleDelta);
+							samples = sample_delta_filter(&sampleDelta, samples, msg->sampleCount);
+						}
+						if (binary){
+							if (sendMeta) telemetry_send_meta_frame(serial, samples, msg->sampleCount);
+							telemetry_send_sample_frame(serial, samples, msg->sampleCount, tick);
+						}
+						else{
+							api_sendSampleRecord(serial, samples, msg->sampleCount, tick, sendMeta);
+							put_crlf(serial);
+						}
 						if (isPrimary) LED_toggle(0);
-						put_crlf(serial);
 						tick++;
 						break;
 					}
@@ -248,6 +292,7 @@ void connectivityTask(void *params) {
 						break;
 					}
 				}
+				logger_message_release(msg);
 			}
 
 			////////////////////////////////////////////////////////////
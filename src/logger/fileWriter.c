@@ -10,6 +10,7 @@
 #include "modp_numtoa.h"
 #include "sdcard.h"
 #include "sampleRecord.h"
+#include "binaryLogFormat.h"
 #include "loggerHardware.h"
 #include "taskUtil.h"
 #include "mod_string.h"
@@ -24,12 +25,21 @@ enum writing_status {
 };
 
 #define FILE_WRITER_STACK_SIZE  				200
-#define SAMPLE_RECORD_QUEUE_SIZE				20
-#define FILE_BUFFER_SIZE						256
+
+//output is staged in a ring of whole sectors; only complete sectors are handed to f_write
+#define FILE_SECTOR_SIZE						_MAX_SS
+#define FILE_BUFFER_COUNT						2
+#define FILE_BUFFER_SIZE						(FILE_SECTOR_SIZE * FILE_BUFFER_COUNT)
 
 #define FILENAME_LEN							13
 #define MAX_LOG_FILE_INDEX 						99999
+#define UNKNOWN_LOG_FILE_INDEX					-1
+#define LOG_FILE_PREFIX							"rc_"
+#define LOG_FILE_PREFIX_LEN						3
+#define LOG_FILE_EXTENSION						".log"
 #define FLUSH_INTERVAL_MS						5000
+//pre-allocation grows the file's reserved clusters by this much at a time, keeping each stall short
+#define PREALLOCATION_STEP_BYTES				(256UL * 1024)
 #define ERROR_SLEEP_DELAY_MS					1000
 
 //wait time for sample queue. can be portMAX_DELAY to wait forever, or zero to not wait at all
@@ -40,42 +50,144 @@ enum writing_status {
 
 typedef struct _FileBuffer{
 	char buffer[FILE_BUFFER_SIZE];
-	size_t index;
+	/* offset of the oldest unwritten byte; always sector aligned */
+	size_t head;
+	/* number of bytes buffered starting at head */
+	size_t count;
+	int status;
 } FileBuffer;
 
 static FIL *g_logfile;
 static xQueueHandle g_sampleRecordQueue = NULL;
-static FileBuffer fileBuffer = {"", 0};
+static FileBuffer fileBuffer;
+static FileWriterStats g_writerStats;
+static int g_nextLogfileIndex = UNKNOWN_LOG_FILE_INDEX;
+static size_t g_sessionStartTicks;
+//tells this log's binary records apart from stale data left in the file's clusters
+static uint32_t g_logfileId;
+//clusters are allocated up to g_reservedEnd, growing towards g_reserveLimit
+static DWORD g_reservedEnd;
+static DWORD g_reserveLimit;
+//rate of the CSV GPS fix time column, worked out with the header; 0 if the log has none
+static unsigned int g_fixTimeRate;
+
+static void resetFileBuffer(){
+	fileBuffer.head = 0;
+	fileBuffer.count = 0;
+	fileBuffer.status = WRITE_SUCCESS;
+}
+
+static void resetWriterStats(){
+	memset(&g_writerStats, 0, sizeof(g_writerStats));
+	g_sessionStartTicks = getCurrentTicks();
+}
+
+static void updateBytesPerSecond(){
+	size_t elapsedMs = ticksToMs(getCurrentTicks() - g_sessionStartTicks);
+	if (elapsedMs > 0){
+		g_writerStats.bytesPerSecond = (unsigned int)(((unsigned long long)g_writerStats.bytesWritten * 1000) / elapsedMs);
+	}
+}
+
+void get_file_writer_stats(FileWriterStats *stats){
+	*stats = g_writerStats;
+}
+
+static int writeLogfile(const char *data, size_t length){
+	UINT written = 0;
+	size_t startTicks = getCurrentTicks();
+	int rc = f_write(g_logfile, data, length, &written);
+	size_t latencyMs = ticksToMs(getCurrentTicks() - startTicks);
+
+	g_writerStats.bytesWritten += written;
+	if (latencyMs > g_writerStats.maxWriteLatencyMs){
+		g_writerStats.maxWriteLatencyMs = latencyMs;
+	}
+	return (rc == FR_OK && written == length) ? WRITE_SUCCESS : WRITE_FAIL;
+}
 
+/*
+ * Writes every complete sector in the buffer. Sectors that are contiguous
+ * in the ring go out in a single f_write so FatFs can transfer them directly
+ * as a multi-sector write.
+ */
 static int writeFileBuffer(){
-	int rc = f_puts(fileBuffer.buffer, g_logfile);
-	fileBuffer.index = 0;
-	fileBuffer.buffer[0] = '\0';
-	return rc;
+	while (fileBuffer.count >= FILE_SECTOR_SIZE){
+		size_t length = fileBuffer.count - (fileBuffer.count % FILE_SECTOR_SIZE);
+		if (length > FILE_BUFFER_SIZE - fileBuffer.head){
+			length = FILE_BUFFER_SIZE - fileBuffer.head;
+		}
+		if (WRITE_FAIL == writeLogfile(fileBuffer.buffer + fileBuffer.head, length)){
+			fileBuffer.status = WRITE_FAIL;
+		}
+		//the data is dropped on failure as well; the writer task recovers the file
+		fileBuffer.head = (fileBuffer.head + length) % FILE_BUFFER_SIZE;
+		fileBuffer.count -= length;
+	}
+	return fileBuffer.status;
 }
 
-static void appendFileBuffer(const char * data){
-	size_t index = fileBuffer.index;
-	char * buffer = fileBuffer.buffer + index;
-
-	while(*data){
-		*buffer++ = *data++;
-		index++;
-		if (index >= FILE_BUFFER_SIZE){
-			pr_info("flush file buffer\r\n");
-			*buffer = '\0';
+/*
+ * Writes the trailing partial sector so the file is complete on disk.
+ * When rewind is set the file pointer is moved back to the start of that
+ * sector, which stays buffered and is rewritten in full once it fills up;
+ * this keeps all regular writes sector aligned.
+ */
+static int writeFileBufferTail(int rewind){
+	writeFileBuffer();
+	size_t length = fileBuffer.count;
+	if (length > 0){
+		if (WRITE_FAIL == writeLogfile(fileBuffer.buffer + fileBuffer.head, length)){
+			fileBuffer.status = WRITE_FAIL;
+			fileBuffer.count = 0;
+		}
+		else if (rewind){
+			g_writerStats.bytesWritten -= length;
+			f_lseek(g_logfile, f_tell(g_logfile) - length);
+		}
+		else{
+			fileBuffer.count = 0;
+		}
+	}
+	return fileBuffer.status;
+}
+
+static int takeFileBufferStatus(){
+	int status = fileBuffer.status;
+	fileBuffer.status = WRITE_SUCCESS;
+	return status;
+}
+
+static void appendFileBytes(const void * data, size_t length){
+	const char *src = (const char *)data;
+
+	while (length > 0){
+		if (fileBuffer.count == FILE_BUFFER_SIZE){
+			//all buffers are full; the writer has to catch up before we can continue
 			writeFileBuffer();
-			index = fileBuffer.index;
-			buffer = fileBuffer.buffer + index;
 		}
+		size_t tail = (fileBuffer.head + fileBuffer.count) % FILE_BUFFER_SIZE;
+		size_t chunk = FILE_BUFFER_SIZE - fileBuffer.count;
+		if (chunk > FILE_BUFFER_SIZE - tail) chunk = FILE_BUFFER_SIZE - tail;
+		if (chunk > length) chunk = length;
+
+		memcpy(fileBuffer.buffer + tail, src, chunk);
+		fileBuffer.count += chunk;
+		src += chunk;
+		length -= chunk;
 	}
-	*buffer = '\0';
-	fileBuffer.index = index;
+}
+
+static void appendFileBuffer(const char * data){
+	appendFileBytes(data, strlen(data));
 }
 
 portBASE_TYPE queue_logfile_record(LoggerMessage * msg){
 	if (NULL != g_sampleRecordQueue){
-		return xQueueSend(g_sampleRecordQueue, &msg, SAMPLE_QUEUE_WAIT_TIME);
+		logger_message_retain(msg);
+		portBASE_TYPE rc = xQueueSend(g_sampleRecordQueue, &msg, SAMPLE_QUEUE_WAIT_TIME);
+		if (pdTRUE != rc) logger_message_release(msg);
+		return rc;
 	}
 	else{
 		return errQUEUE_EMPTY;
@@ -112,7 +224,22 @@ static void appendFloat(float num, int precision){
 	appendFileBuffer(buf);
 }
 
+/*
+ * The GPS fix time column follows the channels, at the highest rate of the
+ * GPS channels.  Returns 0 if the sample has no GPS channels.
+ */
+static unsigned int getFixTimeSampleRate(ChannelSample *sample, size_t channelCount){
+	unsigned int rate = 0;
+	for (; 0 < channelCount; channelCount--, sample++) {
+		if (!sample->fixTimestamped) continue;
+		unsigned int channelRate = decodeSampleRate(sample->cfg->sampleRate);
+		if (channelRate > rate) rate = channelRate;
+	}
+	return rate;
+}
+
 static int writeHeaders(ChannelSample *sample, size_t channelCount){
+	g_fixTimeRate = getFixTimeSampleRate(sample, channelCount);
 	char *separator = "";
 
 	for (; 0 < channelCount; channelCount--, sample++) {
@@ -124,15 +251,24 @@ static int writeHeaders(ChannelSample *sample, size_t channelCount){
       appendFileBuffer("|");
       appendQuotedString(sample->cfg->units);
       appendFileBuffer("|");
-      appendFloat(decodeSampleRate(sample->cfg->min), precision);
+      appendFloat(sample->cfg->min, precision);
       appendFileBuffer("|");
-      appendFloat(decodeSampleRate(sample->cfg->max), precision);
+      appendFloat(sample->cfg->max, precision);
       appendFileBuffer("|");
       appendInt(decodeSampleRate(sample->cfg->sampleRate));
 	}
 
+	if (g_fixTimeRate) {
+      appendFileBuffer(separator);
+      appendQuotedString(FIX_TIME_LABEL);
+      appendFileBuffer("|");
+      appendQuotedString(FIX_TIME_UNITS);
+      appendFileBuffer("|0|0|");
+      appendInt(g_fixTimeRate);
+	}
+
 	appendFileBuffer("\n");
-	return writeFileBuffer();
+	return WRITE_SUCCESS;
 }
 
 
@@ -142,6 +278,9 @@ static int writeChannelSamples(ChannelSample *sample, size_t channelCount){
       return WRITE_FAIL;
 	}
 
+	//the first populated GPS channel of the row carries the fix time
+	const ChannelSample *fixSample = NULL;
+
 	char *separator = "";
    for (; 0 < channelCount; channelCount--, sample++) {
       appendFileBuffer(separator);
@@ -150,11 +289,15 @@ static int writeChannelSamples(ChannelSample *sample, size_t channelCount){
       if (!sample->populated)
          continue;
 
+      if (sample->fixTimestamped && fixSample == NULL)
+         fixSample = sample;
+
       const int precision = sample->cfg->precision;
 
       switch(sample->sampleData) {
       case SampleData_Float:
       case SampleData_Float_Noarg:
+      case SampleData_Float_Planned:
          appendFloat(sample->valueFloat, precision);
          break;
       case SampleData_Int:
@@ -174,45 +317,183 @@ static int writeChannelSamples(ChannelSample *sample, size_t channelCount){
       }
    }
 
-   appendFileBuffer("\n");
-   writeFileBuffer();
+   if (g_fixTimeRate) {
+      appendFileBuffer(separator);
+      if (fixSample)
+         appendInt(fixSample->fixUptime);
+   }
 
+   appendFileBuffer("\n");
    return WRITE_SUCCESS;
 }
 
-static int openLogfile(FIL *f, char *filename){
+static int writeBinaryHeaders(ChannelSample *sample, size_t channelCount){
+	binary_log_write_header(appendFileBytes, sample, channelCount, g_logfileId);
+	return WRITE_SUCCESS;
+}
+
+static int writeBinaryChannelSamples(ChannelSample *sample, size_t channelCount){
+	if (NULL == sample) {
+      pr_debug("null sample record\r\n");
+      return WRITE_FAIL;
+	}
+	binary_log_write_record(appendFileBytes, sample, channelCount, g_logfileId);
+	return WRITE_SUCCESS;
+}
+
+static int openLogfile(FIL *f, char *filename, DWORD position){
 	int rc = f_open(f,filename, FA_WRITE);
+	if (0 == rc){
+		//continue where the previous writes left off
+		rc = f_lseek(f, position);
+	}
 	return rc;
 }
 
+/*
+ * Returns the index N of a rc_N.log directory entry, or UNKNOWN_LOG_FILE_INDEX
+ * if the name is not a log file. Directory entries come back as upper case 8.3 names.
+ */
+static int parseLogfileIndex(const char *name){
+	char prefix[LOG_FILE_PREFIX_LEN + 1];
+	strlcpy(prefix, name, sizeof(prefix));
+	if (0 != strcasecmp(prefix, LOG_FILE_PREFIX)) return UNKNOWN_LOG_FILE_INDEX;
+
+	const char *digit = name + LOG_FILE_PREFIX_LEN;
+	int index = 0;
+	for (; *digit >= '0' && *digit <= '9'; digit++){
+		index = index * 10 + (*digit - '0');
+		if (index > MAX_LOG_FILE_INDEX) return UNKNOWN_LOG_FILE_INDEX;
+	}
+	if (digit == name + LOG_FILE_PREFIX_LEN || 0 != strcasecmp(digit, LOG_FILE_EXTENSION)){
+		return UNKNOWN_LOG_FILE_INDEX;
+	}
+	return index;
+}
+
+/*
+ * Finds the index following the highest existing log file with a single
+ * pass over the root directory.
+ */
+static int scanNextLogfileIndex(){
+	DIR dir;
+	FILINFO info;
+	int next = 0;
+
+	if (FR_OK != f_opendir(&dir, "/")) return next;
+	while (FR_OK == f_readdir(&dir, &info) && info.fname[0]){
+		int index = parseLogfileIndex(info.fname);
+		if (index >= next) next = index + 1;
+	}
+	f_closedir(&dir);
+	return next;
+}
+
+static void formatLogfileName(char *filename, int index){
+	char numBuf[12];
+	modp_itoa10(index, numBuf);
+	strcpy(filename, LOG_FILE_PREFIX);
+	strcat(filename, numBuf);
+	strcat(filename, LOG_FILE_EXTENSION);
+}
+
+/*
+ * The next index is found by a directory scan the first time and then
+ * remembered, so later sessions open their file directly. If the remembered
+ * name is taken (e.g. the card was swapped) the directory is scanned again.
+ */
 static int openNextLogfile(FIL *f, char *filename){
-	int i = 0;
-	int rc;
-	for (; i < MAX_LOG_FILE_INDEX; i++){
-		strcpy(filename,"rc_");
-		char numBuf[12];
-		modp_itoa10(i,numBuf);
-		strcat(filename, numBuf);
-		strcat(filename, ".log");
+	int rc = FR_EXIST;
+	for (int attempt = 0; attempt < 2 && FR_EXIST == rc; attempt++){
+		if (UNKNOWN_LOG_FILE_INDEX == g_nextLogfileIndex || attempt > 0){
+			g_nextLogfileIndex = scanNextLogfileIndex();
+		}
+		if (g_nextLogfileIndex > MAX_LOG_FILE_INDEX) return -2;
+
+		formatLogfileName(filename, g_nextLogfileIndex);
 		rc = f_open(f,filename, FA_WRITE | FA_CREATE_NEW);
-		if ( rc == 0 ) break;
-		f_close(f);
 	}
-	if (i >= MAX_LOG_FILE_INDEX) return -2;
+	if (0 != rc){
+		//force a rescan next time, the card may have changed
+		g_nextLogfileIndex = UNKNOWN_LOG_FILE_INDEX;
+		return rc;
+	}
+	g_nextLogfileIndex++;
 	pr_info("open ");
 	pr_info(filename);
 	pr_info("\r\n");
 	return rc;
 }
 
+/*
+ * Reserves the log file's clusters ahead of the data by seeking past the
+ * reserved end, which makes FatFs extend the file and its cluster chain from
+ * the next free cluster. On a freshly formatted card the file stays
+ * contiguous, and writes follow the existing chain instead of updating the FAT.
+ *
+ * The file size includes the reserved space until the file is closed and
+ * truncated to its data. A log cut short by a power loss therefore ends with
+ * the stale contents of the reserved clusters; the records of a binary log
+ * are seeded with the file id, so the decoder skips them.
+ *
+ * Each call reserves at most one step, and only once the data comes within a
+ * step of the reserved end, so no single call holds up the writer for long.
+ */
+static void reserveAhead(FIL *f){
+	const DWORD position = f_tell(f);
+	if (g_reservedEnd >= g_reserveLimit || position == 0 ||
+			position + PREALLOCATION_STEP_BYTES <= g_reservedEnd) return;
+
+	DWORD end = g_reservedEnd + PREALLOCATION_STEP_BYTES;
+	if (end < position + PREALLOCATION_STEP_BYTES) end = position + PREALLOCATION_STEP_BYTES;
+	if (end > g_reserveLimit) end = g_reserveLimit;
+	if (end <= position){
+		//the data has caught up with the limit
+		g_reservedEnd = g_reserveLimit;
+		return;
+	}
+
+	const size_t startTicks = getCurrentTicks();
+	int rc = f_lseek(f, end);
+	if (0 == rc) rc = f_lseek(f, position);
+
+	size_t elapsedMs = ticksToMs(getCurrentTicks() - startTicks);
+	if (elapsedMs > g_writerStats.maxPreallocationMs){
+		g_writerStats.maxPreallocationMs = elapsedMs;
+	}
+	//even a failed step may have allocated some clusters; they are released on close
+	g_reservedEnd = end;
+	if (0 != rc){
+		pr_warning("Log file pre-allocation error.  Code: ");
+		pr_warning_int(rc);
+		pr_warning("\r\n");
+		//stop reserving; the file still grows as it is written
+		g_reserveLimit = 0;
+		f_lseek(f, position);
+	}
+}
+
+static void startReservation(unsigned int sizeMb){
+	g_reservedEnd = 0;
+	g_reserveLimit = (DWORD)sizeMb * 1024 * 1024;
+}
+
 static void endLogfile(){
 	pr_info("close logfile\r\n");
+	writeFileBufferTail(0);
+	updateBytesPerSecond();
+	if (f_tell(g_logfile) < f_size(g_logfile)){
+		//release the unused reserved clusters
+		f_truncate(g_logfile);
+	}
 	f_close(g_logfile);
 	UnmountFS();
 }
 
 static void flushLogfile(FIL *file){
 	pr_debug("flush logfile\r\n");
+	writeFileBufferTail(1);
+	updateBytesPerSecond();
 	int res = f_sync(file);
 	if (0 != res){
 		pr_debug_int(res);
@@ -244,6 +525,8 @@ static int openNewLogfile(char *filename){
       return WRITING_INACTIVE;
    }
 
+   g_logfileId = ((uint32_t) (g_nextLogfileIndex - 1) << 16) ^ (uint32_t) getCurrentTicks();
+   startReservation(getWorkingLoggerConfig()->SdLoggingConfigs.preallocationMb);
    return WRITING_ACTIVE;
 }
 
@@ -253,8 +536,15 @@ void fileWriterTask(void *params){
 	portTickType flushTimeoutStart = 0;
 	size_t tick = 0;
 	enum writing_status writingStatus = WRITING_INACTIVE;
+	unsigned char loggingMode = SD_LOGGING_MODE_CSV;
 	char filename[FILENAME_LEN];
 
+	//learn the next log file index up front so the first session starts without a directory scan
+	if (0 == InitFS()){
+		g_nextLogfileIndex = scanNextLogfileIndex();
+		UnmountFS();
+	}
+
 	while(1){
 		while(1){
 			//wait for the next sample record
@@ -267,10 +557,20 @@ void fileWriterTask(void *params){
 				flushTimeoutInterval = FLUSH_INTERVAL_MS;
 				flushTimeoutStart = xTaskGetTickCount();
 				tick = 0;
-				writingStatus = openNewLogfile(filename);
+				resetFileBuffer();
+				resetWriterStats();
+				loggingMode = getWorkingLoggerConfig()->SdLoggingConfigs.loggingMode;
+				writingStatus = loggingMode == SD_LOGGING_MODE_DISABLED ?
+						WRITING_INACTIVE : openNewLogfile(filename);
 			} else if (LoggerMessageType_Stop == msg->type){
 				pr_info_int(tick);
 				pr_info(" logfile lines written\r\n");
+				updateBytesPerSecond();
+				pr_info_int(g_writerStats.bytesPerSecond);
+				pr_info(" bytes/sec, max write latency ");
+				pr_info_int(g_writerStats.maxWriteLatencyMs);
+				pr_info(" ms\r\n");
+				logger_message_release(msg);
                                 break;
 			}
 
@@ -281,19 +581,38 @@ void fileWriterTask(void *params){
 //                    continue;
 //                }
 
+				const int binary = (loggingMode == SD_LOGGING_MODE_BINARY);
 			    if (0 == tick){
-					writeHeaders(msg->channelSamples, msg->sampleCount);
+					if (binary){
+						writeBinaryHeaders(msg->channelSamples, msg->sampleCount);
+					}
+					else{
+						writeHeaders(msg->channelSamples, msg->sampleCount);
+					}
 				}
 				LED_toggle(2);
-				int rc = writeChannelSamples(msg->channelSamples, msg->sampleCount);
+				int rc = binary ?
+						writeBinaryChannelSamples(msg->channelSamples, msg->sampleCount) :
+						writeChannelSamples(msg->channelSamples, msg->sampleCount);
+				//the record is in the file buffer now; hand the sample buffer back
+				logger_message_release(msg);
+				//defer sector writes while samples are queued; a full ring is written as it fills
+				if (0 == uxQueueMessagesWaiting(g_sampleRecordQueue)){
+					writeFileBuffer();
+					reserveAhead(g_logfile);
+				}
+				if (WRITE_FAIL == takeFileBufferStatus()){
+					rc = WRITE_FAIL;
+				}
 				if (rc == WRITE_FAIL){
 					LED_enable(3);
 					//try to recover
+					DWORD position = f_tell(g_logfile);
 					f_close(g_logfile);
 					UnmountFS();
 					pr_error("Error writing file, recovering..\r\n");
 					InitFS();
-					rc = openLogfile(g_logfile, filename);
+					rc = openLogfile(g_logfile, filename, position);
 					if (0 != rc){
 						pr_error("could not recover file ");
 						pr_error(filename);
@@ -310,6 +629,8 @@ void fileWriterTask(void *params){
 					flushTimeoutStart = xTaskGetTickCount();
 				}
 				tick++;
+			} else {
+				logger_message_release(msg);
 			}
 		}
 
@@ -323,7 +644,7 @@ void fileWriterTask(void *params){
 
 void startFileWriterTask( int priority ){
 
-	g_sampleRecordQueue = xQueueCreate(SAMPLE_RECORD_QUEUE_SIZE,sizeof( ChannelSample *));
+	g_sampleRecordQueue = xQueueCreate(FILE_WRITER_QUEUE_SIZE,sizeof( ChannelSample *));
 	if (NULL == g_sampleRecordQueue){
 		pr_error("Could not create sample record queue!");
 		return;
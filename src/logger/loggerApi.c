@@ -3,6 +3,7 @@
 #include "constants.h"
 #include "capabilities.h"
 #include "loggerApi.h"
+#include "telemetryFrame.h"
 #include "loggerConfig.h"
 #include "modp_atonum.h"
 #include "mod_string.h"
@@ -24,6 +25,7 @@
 #include "cpu.h"
 #include "luaScript.h"
 #include "luaTask.h"
+#include "luaScheduler.h"
 #include "loggerTaskEx.h"
 #include "FreeRTOS.h"
 #include "taskUtil.h"
@@ -187,6 +189,10 @@ int api_getCapabilities(Serial *serial, const jsmntok_t *json){
 	json_int(serial, "tracks", MAX_TRACKS, 1);
 	json_int(serial, "sectors", MAX_SECTORS, 1);
 	json_int(serial, "script", SCRIPT_MEMORY_LENGTH, 0);
+	json_objEnd(serial, 1);
+
+	json_objStartString(serial,"telemetry");
+	json_int(serial, "bin", 1, 0);
 	json_objEnd(serial, 0);
 
 	json_objEnd(serial, 0);
@@ -333,6 +339,7 @@ void api_sendSampleRecord(Serial *serial, ChannelSample *channelSamples,
 		  switch(sample->sampleData) {
 		  case SampleData_Float:
 		  case SampleData_Float_Noarg:
+		  case SampleData_Float_Planned:
 			 put_float(serial, sample->valueFloat, precision);
 			 break;
 		  case SampleData_Int:
@@ -733,6 +740,7 @@ static void setTelemetryConfig(const jsmntok_t *root){
 		setStringValueIfExists(telemetryCfgNode, "deviceId", telemetryCfg->telemetryDeviceId, DEVICE_ID_LENGTH);
 		setStringValueIfExists(telemetryCfgNode, "host", telemetryCfg->telemetryServerHost, TELEMETRY_SERVER_HOST_LENGTH);
 		setUnsignedCharValueIfExists(telemetryCfgNode, "bgStream", &telemetryCfg->backgroundStreaming, filterBgStreamingMode);
+		setUnsignedCharValueIfExists(telemetryCfgNode, "delta", &telemetryCfg->deltaEncoding, filterTelemetryDeltaMode);
 	}
 }
 
@@ -764,6 +772,7 @@ int api_getConnectivityConfig(Serial *serial, const jsmntok_t *json){
 
 	json_objStartString(serial, "telCfg");
 	json_int(serial, "bgStream", cfg->telemetryConfig.backgroundStreaming, 1);
+	json_int(serial, "delta", cfg->telemetryConfig.deltaEncoding, 1);
 	json_string(serial, "deviceId", cfg->telemetryConfig.telemetryDeviceId, 1);
 	json_string(serial, "host", cfg->telemetryConfig.telemetryServerHost, 0);
 	json_objEnd(serial, 0);
@@ -773,6 +782,35 @@ int api_getConnectivityConfig(Serial *serial, const jsmntok_t *json){
 	return API_SUCCESS_NO_RETURN;
 }
 
+int api_setSdLoggingConfig(Serial *serial, const jsmntok_t *json){
+	SdLoggingConfig *cfg = &(getWorkingLoggerConfig()->SdLoggingConfigs);
+	setUnsignedCharValueIfExists(json, "mode", &cfg->loggingMode, filterSdLoggingMode);
+	int preallocationMb;
+	if (setIntValueIfExists(json, "prealloc", &preallocationMb)){
+		cfg->preallocationMb = filterSdLoggingPreallocation(preallocationMb);
+	}
+	return API_SUCCESS;
+}
+
+int api_getSdLoggingConfig(Serial *serial, const jsmntok_t *json){
+	SdLoggingConfig *cfg = &(getWorkingLoggerConfig()->SdLoggingConfigs);
+	json_objStart(serial);
+	json_objStartString(serial, "sdLogCfg");
+	json_int(serial, "mode", cfg->loggingMode, 1);
+	json_uint(serial, "prealloc", cfg->preallocationMb, 0);
+	json_objEnd(serial, 0);
+	json_objEnd(serial, 0);
+	return API_SUCCESS_NO_RETURN;
+}
+
+int api_setTelemetryFormat(Serial *serial, const jsmntok_t *json){
+	int format;
+	if (setIntValueIfExists(json, "fmt", &format)){
+		set_telemetry_format(serial, (enum TelemetryFormat)filterTelemetryFormat(format));
+	}
+	return API_SUCCESS;
+}
+
 static void sendPwmConfig(Serial *serial, size_t startIndex, size_t endIndex){
 
 	json_objStart(serial);
@@ -987,7 +1025,9 @@ int api_getGpsConfig(Serial *serial, const jsmntok_t *json){
    json_int(serial, "pos",  posEnabled, 1);
    json_int(serial, "speed", gpsCfg->speed.sampleRate != SAMPLE_DISABLED, 1);
    json_int(serial, "dist", gpsCfg->distance.sampleRate != SAMPLE_DISABLED, 1);
-   json_int(serial, "sats", gpsCfg->satellites.sampleRate != SAMPLE_DISABLED, 0);
+   json_int(serial, "sats", gpsCfg->satellites.sampleRate != SAMPLE_DISABLED, 1);
+   json_int(serial, "navFmt", gpsCfg->navFormat, 1);
+   json_int(serial, "extrap", gpsCfg->extrapolate, 0);
 
    json_objEnd(serial, 0);
    json_objEnd(serial, 0);
@@ -1015,6 +1055,8 @@ int api_setGpsConfig(Serial *serial, const jsmntok_t *json){
    gpsConfigTestAndSet(json, &(gpsCfg->speed), "speed", sr);
    gpsConfigTestAndSet(json, &(gpsCfg->distance), "dist", sr);
    gpsConfigTestAndSet(json, &(gpsCfg->satellites), "sats", sr);
+   setUnsignedCharValueIfExists(json, "navFmt", &gpsCfg->navFormat, filterGpsNavFormat);
+   setUnsignedCharValueIfExists(json, "extrap", &gpsCfg->extrapolate, filterGpsExtrapolate);
 
 	configChanged();
 	return API_SUCCESS;
@@ -1398,3 +1440,46 @@ int api_runScript(Serial *serial, const jsmntok_t *json){
 	setShouldReloadScript(1);
 	return API_SUCCESS;
 }
+
+int api_storeScriptBytecode(Serial *serial, const jsmntok_t *json){
+	if (SCRIPT_BYTECODE_LENGTH == 0) return API_ERROR_UNSPECIFIED;
+	requestStoreScriptBytecode();
+	return API_SUCCESS;
+}
+
+int api_getLuaStats(Serial *serial, const jsmntok_t *json){
+	json_objStart(serial);
+	json_objStartString(serial, "luaStats");
+	json_arrayStart(serial, "cb");
+	int first = 1;
+	for (int id = 0; id < LUA_MAX_CALLBACKS; id++){
+		const LuaCallback *cb = lua_scheduler_get(id);
+		if (!cb) continue;
+
+		if (!first) serial->put_c(',');
+		first = 0;
+		const LuaCallbackStats *stats = &cb->stats;
+		json_objStart(serial);
+		json_int(serial, "id", id, 1);
+		json_uint(serial, "hz", 1000 / ticksToMs(cb->interval), 1);
+		json_uint(serial, "budget", ticksToMs(cb->budget), 1);
+		json_uint(serial, "runs", stats->runs, 1);
+		json_uint(serial, "over", stats->overruns, 1);
+		json_uint(serial, "skip", stats->skips, 1);
+		json_uint(serial, "last", ticksToMs(stats->lastTicks), 1);
+		json_uint(serial, "max", ticksToMs(stats->maxTicks), 0);
+		json_objEnd(serial, 0);
+	}
+	json_arrayEnd(serial, 1);
+
+	const LuaGcStats *gc = lua_scheduler_get_gc_stats();
+	json_objStartString(serial, "gc");
+	json_uint(serial, "budget", gc->stepBudget, 1);
+	json_uint(serial, "steps", gc->steps, 1);
+	json_uint(serial, "cycles", gc->cycles, 1);
+	json_uint(serial, "max", ticksToMs(gc->maxStepTicks), 0);
+	json_objEnd(serial, 0);
+	json_objEnd(serial, 0);
+	json_objEnd(serial, 0);
+	return API_SUCCESS_NO_RETURN;
+}
@@ -24,6 +24,13 @@
 #include "loggerTaskEx.h"
 #include "taskUtil.h"
 #include "GPIO.h"
+#include "watchdog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define TEST_SERIAL_DEFAULT_SECONDS	5
+
+static const char g_testSerialPattern[] = "The quick brown fox jumped over the lazy dog\r\n";
 
 
 void TestSD(Serial *serial, unsigned int argc, char **argv){
@@ -36,6 +43,91 @@ void TestSD(Serial *serial, unsigned int argc, char **argv){
 	TestSDWrite(serial, lines, doFlush, quiet);
 }
 
+static uint32_t spinUntilNextTick(){
+	uint32_t spins = 0;
+	portTickType tick = xTaskGetTickCount();
+	while (xTaskGetTickCount() == tick) spins++;
+	return spins;
+}
+
+static void writeTestPattern(Serial *target, size_t *offset, size_t length, int useBuffer){
+	while (length > 0){
+		size_t count = sizeof(g_testSerialPattern) - 1 - *offset;
+		if (count > length) count = length;
+		const char *data = g_testSerialPattern + *offset;
+		if (useBuffer){
+			target->put_buf(data, count);
+		}
+		else{
+			for (size_t i = 0; i < count; i++) target->put_c(data[i]);
+		}
+		*offset = (*offset + count) % (sizeof(g_testSerialPattern) - 1);
+		length -= count;
+	}
+}
+
+/*
+ * Spins on the tick count for the given number of ticks; the iterations
+ * counted are the CPU time left over to this task. With a target port the
+ * pattern is written at the link rate, so the writer never waits on a full
+ * transmit buffer and the lost iterations are the cost of transmitting.
+ */
+static uint32_t runSerialTest(Serial *target, uint32_t baud, int useBuffer, size_t ticks, size_t *bytesSent, size_t *elapsedTicks){
+	size_t ticksPerSecond = msToTicks(1000);
+	size_t offset = 0;
+	size_t sent = 0;
+	uint32_t spins = 0;
+
+	spinUntilNextTick();
+	portTickType startTicks = xTaskGetTickCount();
+	for (size_t i = 1; i <= ticks; i++){
+		if (target){
+			size_t due = (size_t)((uint64_t)baud / 10 * i / ticksPerSecond);
+			writeTestPattern(target, &offset, due - sent, useBuffer);
+			sent = due;
+		}
+		spins += spinUntilNextTick();
+		watchdog_reset();
+	}
+	*elapsedTicks = xTaskGetTickCount() - startTicks;
+	*bytesSent = sent;
+	return spins;
+}
+
+void TestSerial(Serial *serial, unsigned int argc, char **argv){
+	if (argc < 4){
+		put_commandError(serial, ERROR_CODE_MISSING_PARAMS);
+		return;
+	}
+	uint32_t port = modp_atoui(argv[1]);
+	uint32_t baud = modp_atoui(argv[2]);
+	int useBuffer = modp_atoui(argv[3]) != 0;
+	uint32_t seconds = argc > 4 ? modp_atoui(argv[4]) : TEST_SERIAL_DEFAULT_SECONDS;
+
+	Serial *target = get_serial(port);
+	if (target == NULL || target == serial || baud == 0 || seconds == 0){
+		put_commandError(serial, ERROR_CODE_INVALID_PARAM);
+		return;
+	}
+	configure_serial(port, 8, 0, 1, baud);
+
+	size_t ticks = msToTicks(seconds * 1000);
+	size_t bytesSent, elapsedTicks;
+	uint32_t idleSpins = runSerialTest(NULL, baud, useBuffer, ticks, &bytesSent, &elapsedTicks);
+	uint32_t busySpins = runSerialTest(target, baud, useBuffer, ticks, &bytesSent, &elapsedTicks);
+
+	serial->put_s(useBuffer ? "put_buf" : "put_c");
+	serial->put_s(" @ ");
+	put_uint(serial, baud);
+	serial->put_s(" baud: ");
+	put_uint(serial, (unsigned int)((uint64_t)bytesSent * 1000 / ticksToMs(elapsedTicks)));
+	serial->put_s(" bytes/sec, CPU load ");
+	put_float(serial, busySpins < idleSpins ? 100.0f * (idleSpins - busySpins) / idleSpins : 0, 1);
+	serial->put_s("%");
+	put_crlf(serial);
+	put_commandOK(serial);
+}
+
 
 void ResetConfig(Serial *serial, unsigned int argc, char **argv){
 	if (flash_default_logger_config() == 0 && flash_default_script() == 0 && flash_default_tracks() == 0) {
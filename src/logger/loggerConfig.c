@@ -146,6 +146,7 @@ static void resetCellularConfig(CellularConfig *cfg) {
 static void resetTelemetryConfig(TelemetryConfig *cfg) {
    memset(cfg, 0, sizeof(TelemetryConfig));
    cfg->backgroundStreaming = BACKGROUND_STREAMING_ENABLED;
+   cfg->deltaEncoding = DEFAULT_TELEMETRY_DELTA;
    strcpy(cfg->telemetryServerHost, DEFAULT_TELEMETRY_SERVER_HOST);
 }
 
@@ -155,6 +156,12 @@ static void resetConnectivityConfig(ConnectivityConfig *cfg) {
    resetTelemetryConfig(&cfg->telemetryConfig);
 }
 
+static void resetSdLoggingConfig(SdLoggingConfig *cfg) {
+   memset(cfg, 0, sizeof(SdLoggingConfig));
+   cfg->loggingMode = DEFAULT_SD_LOGGING_MODE;
+   cfg->preallocationMb = DEFAULT_SD_LOGGING_PREALLOCATION_MB;
+}
+
 bool isHigherSampleRate(const int contender, const int champ) {
    // Contender can't win here.  Ever.
    if (contender == SAMPLE_DISABLED)
@@ -190,6 +197,7 @@ int flash_default_logger_config(void){
    resetLapConfig(&lc->LapConfigs);
    resetTrackConfig(&lc->TrackConfigs);
    resetConnectivityConfig(&lc->ConnectivityConfigs);
+   resetSdLoggingConfig(&lc->SdLoggingConfigs);
    strcpy(lc->padding_data, "");
 
 	int result = flashLoggerConfig();
@@ -305,16 +313,36 @@ unsigned char filterBgStreamingMode(unsigned char mode){
 	return mode == 0 ? 0 : 1;
 }
 
+unsigned char filterTelemetryDeltaMode(unsigned char mode){
+	return mode == TELEMETRY_DELTA_DISABLED ? TELEMETRY_DELTA_DISABLED : TELEMETRY_DELTA_ENABLED;
+}
+
+unsigned char filterGpsNavFormat(unsigned char format){
+	return format == GPS_NAV_FORMAT_BINARY ? GPS_NAV_FORMAT_BINARY : GPS_NAV_FORMAT_NMEA;
+}
+
+unsigned char filterGpsExtrapolate(unsigned char extrapolate){
+	return extrapolate != 0;
+}
+
 unsigned char filterSdLoggingMode(unsigned char mode){
 	switch (mode){
 		case SD_LOGGING_MODE_CSV:
 			return SD_LOGGING_MODE_CSV;
+		case SD_LOGGING_MODE_BINARY:
+			return SD_LOGGING_MODE_BINARY;
 		default:
 		case SD_LOGGING_MODE_DISABLED:
 			return SD_LOGGING_MODE_DISABLED;
 	}
 }
 
+unsigned short filterSdLoggingPreallocation(int sizeMb){
+	if (sizeMb < 0) return 0;
+	if (sizeMb > MAX_SD_LOGGING_PREALLOCATION_MB) return MAX_SD_LOGGING_PREALLOCATION_MB;
+	return sizeMb;
+}
+
 char filterGpioMode(int value){
 	switch(value){
 		case CONFIG_GPIO_OUT:
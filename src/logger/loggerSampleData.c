@@ -19,6 +19,8 @@
 #include "printk.h"
 #include "FreeRTOS.h"
 #include "taskUtil.h"
+#include "mem_mang.h"
+#include "mod_string.h"
 
 #include <stdbool.h>
 
@@ -199,11 +201,125 @@ float get_imu_sample(int channelId){
 	return value;
 }
 
+/*
+ * Planned getters. Mode and scaling were resolved into the sample's plan
+ * when the buffer was built; see resolve*SamplePlan below.
+ */
+static float get_analog_raw_sample(const ChannelSample *s){
+	return ADC_read(s->channelIndex);
+}
+
+static float get_analog_linear_sample(const ChannelSample *s){
+	return s->plan.scaling * ADC_read(s->channelIndex);
+}
+
+static float get_analog_mapped_sample(const ChannelSample *s){
+	return get_mapped_value(ADC_read(s->channelIndex), s->plan.scalingMap);
+}
+
+static float get_timer_rpm_sample(const ChannelSample *s){
+	return timer_get_rpm(s->channelIndex) / s->plan.pulsePerRevolution;
+}
+
+static float get_timer_frequency_sample(const ChannelSample *s){
+	return timer_get_hz(s->channelIndex) / s->plan.pulsePerRevolution;
+}
+
+static float get_timer_period_ms_sample(const ChannelSample *s){
+	return timer_get_ms(s->channelIndex) * s->plan.pulsePerRevolution;
+}
+
+static float get_timer_period_usec_sample(const ChannelSample *s){
+	return timer_get_usec(s->channelIndex) * s->plan.pulsePerRevolution;
+}
+
+static float get_pwm_period_sample(const ChannelSample *s){
+	return PWM_channel_get_period(s->channelIndex);
+}
+
+static float get_pwm_duty_sample(const ChannelSample *s){
+	return PWM_get_duty_cycle(s->channelIndex);
+}
+
+static float get_pwm_volts_sample(const ChannelSample *s){
+	return PWM_get_duty_cycle(s->channelIndex) * PWM_VOLTAGE_SCALING;
+}
+
+static float get_planned_imu_sample(const ChannelSample *s){
+	return imu_read_value(s->channelIndex, s->plan.imuConfig);
+}
+
+static float get_unknown_mode_sample(const ChannelSample *s){
+	return -1;
+}
+
+static ChannelSample* processChannelSampleWithPlannedGetter(ChannelSample *s,
+                                                  ChannelConfig *cfg,
+                                                  const size_t index,
+                                                  planned_float_sample_func getter,
+                                                  SamplePlan plan) {
+   if (cfg->sampleRate == SAMPLE_DISABLED)
+      return s;
+
+   s->cfg = cfg;
+   s->channelIndex = index;
+   s->sampleData = SampleData_Float_Planned;
+   s->get_float_sample_planned = getter;
+   s->plan = plan;
+
+   return ++s;
+}
+
+static planned_float_sample_func resolveAnalogSamplePlan(ADCConfig *config, SamplePlan *plan){
+	switch(config->scalingMode){
+		case SCALING_MODE_RAW:
+			return get_analog_raw_sample;
+		case SCALING_MODE_LINEAR:
+			plan->scaling = config->linearScaling;
+			return get_analog_linear_sample;
+		case SCALING_MODE_MAP:
+			plan->scalingMap = &config->scalingMap;
+			return get_analog_mapped_sample;
+		default:
+			return get_unknown_mode_sample;
+	}
+}
+
+static planned_float_sample_func resolveTimerSamplePlan(TimerConfig *config, SamplePlan *plan){
+	plan->pulsePerRevolution = config->pulsePerRevolution;
+	switch (config->mode){
+		case MODE_LOGGING_TIMER_RPM:
+			return get_timer_rpm_sample;
+		case MODE_LOGGING_TIMER_FREQUENCY:
+			return get_timer_frequency_sample;
+		case MODE_LOGGING_TIMER_PERIOD_MS:
+			return get_timer_period_ms_sample;
+		case MODE_LOGGING_TIMER_PERIOD_USEC:
+			return get_timer_period_usec_sample;
+		default:
+			return get_unknown_mode_sample;
+	}
+}
+
+static planned_float_sample_func resolvePwmSamplePlan(PWMConfig *config){
+	switch (config->loggingMode){
+		case MODE_LOGGING_PWM_PERIOD:
+			return get_pwm_period_sample;
+		case MODE_LOGGING_PWM_DUTY:
+			return get_pwm_duty_sample;
+		case MODE_LOGGING_PWM_VOLTS:
+			return get_pwm_volts_sample;
+		default:
+			return get_unknown_mode_sample;
+	}
+}
+
 /* XXX Now we setup how we initialize the sample buffer XXX */
 
 void init_channel_sample_buffer(LoggerConfig *loggerConfig, ChannelSample * samples, size_t channelCount){
    ChannelSample *sample = samples;
    ChannelConfig *chanCfg;
+   memset(samples, 0, sizeof(ChannelSample) * channelCount);
 
    /*
     * This sets up immutable channels.  These channels are channels that are always
@@ -225,19 +341,25 @@ void init_channel_sample_buffer(LoggerConfig *loggerConfig, ChannelSample * samp
    for (int i=0; i < CONFIG_ADC_CHANNELS; i++) {
       ADCConfig *config = &(loggerConfig->ADCConfigs[i]);
       chanCfg = &(config->cfg);
-      sample = processChannelSampleWithFloatGetter(sample, chanCfg, i, get_analog_sample);
+      SamplePlan plan = {0};
+      planned_float_sample_func getter = resolveAnalogSamplePlan(config, &plan);
+      sample = processChannelSampleWithPlannedGetter(sample, chanCfg, i, getter, plan);
    }
 
    for (int i = 0; i < CONFIG_IMU_CHANNELS; i++) {
       ImuConfig *config = &(loggerConfig->ImuConfigs[i]);
       chanCfg = &(config->cfg);
-      sample = processChannelSampleWithFloatGetter(sample, chanCfg, i, get_imu_sample);
+      SamplePlan plan;
+      plan.imuConfig = config;
+      sample = processChannelSampleWithPlannedGetter(sample, chanCfg, i, get_planned_imu_sample, plan);
    }
 
    for (int i=0; i < CONFIG_TIMER_CHANNELS; i++) {
       TimerConfig *config = &(loggerConfig->TimerConfigs[i]);
       chanCfg = &(config->cfg);
-      sample = processChannelSampleWithFloatGetter(sample, chanCfg, i, get_timer_sample);
+      SamplePlan plan = {0};
+      planned_float_sample_func getter = resolveTimerSamplePlan(config, &plan);
+      sample = processChannelSampleWithPlannedGetter(sample, chanCfg, i, getter, plan);
    }
 
    for (int i=0; i < CONFIG_GPIO_CHANNELS; i++) {
@@ -249,7 +371,8 @@ void init_channel_sample_buffer(LoggerConfig *loggerConfig, ChannelSample * samp
    for (int i=0; i < CONFIG_PWM_CHANNELS; i++) {
       PWMConfig *config = &(loggerConfig->PWMConfigs[i]);
       chanCfg = &(config->cfg);
-      sample = processChannelSampleWithFloatGetter(sample, chanCfg, i, get_pwm_sample);
+      SamplePlan plan = {0};
+      sample = processChannelSampleWithPlannedGetter(sample, chanCfg, i, resolvePwmSamplePlan(config), plan);
    }
 
    OBD2Config *obd2Config = &(loggerConfig->OBD2Configs);
@@ -266,16 +389,24 @@ void init_channel_sample_buffer(LoggerConfig *loggerConfig, ChannelSample * samp
 	}
 
    GPSConfig *gpsConfig = &(loggerConfig->GPSConfigs);
+   const int extrapolate = gpsConfig->extrapolate;
+   ChannelSample *gpsSamples = sample;
    chanCfg = &(gpsConfig->latitude);
-   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg, getLatitude);
+   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg,
+                                                     extrapolate ? getExtrapolatedLatitude : getLatitude);
    chanCfg = &(gpsConfig->longitude);
-   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg, getLongitude);
+   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg,
+                                                     extrapolate ? getExtrapolatedLongitude : getLongitude);
    chanCfg = &(gpsConfig->speed);
-   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg, getGpsSpeedInMph);
+   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg,
+                                                     extrapolate ? getExtrapolatedGpsSpeedInMph : getGpsSpeedInMph);
    chanCfg = &(gpsConfig->distance);
-   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg, getGpsDistanceMiles);
+   sample = processChannelSampleWithFloatGetterNoarg(sample, chanCfg,
+                                                     extrapolate ? getExtrapolatedGpsDistanceMiles : getGpsDistanceMiles);
    chanCfg = &(gpsConfig->satellites);
    sample = processChannelSampleWithIntGetterNoarg(sample, chanCfg, getSatellitesUsedForPosition);
+   for (ChannelSample *s = gpsSamples; s < sample; s++)
+      s->fixTimestamped = true;
 
 
    LapConfig *trackConfig = &(loggerConfig->LapConfigs);
@@ -319,11 +450,17 @@ static void populate_channel_sample(ChannelSample *sample) {
     case SampleData_Double:
        sample->valueDouble = sample->get_double_sample(channelIndex);
        break;
+    case SampleData_Float_Planned:
+       sample->valueFloat = sample->get_float_sample_planned(sample);
+       break;
     default:
        pr_warning("Got into supposedly unreachable area in populate_sample_buffer");
        sample->valueLongLong = -1;
        break;
     }
+
+    if (sample->fixTimestamped)
+       sample->fixUptime = getUptimeAtSample();
 }
 
 int populate_sample_buffer(LoggerMessage *lm,  size_t count, size_t logTick) {
@@ -363,3 +500,118 @@ int populate_sample_buffer(LoggerMessage *lm,  size_t count, size_t logTick) {
 
    return highestRate;
 }
+
+void free_sample_schedule(SampleSchedule *schedule) {
+   if (schedule->groups != NULL)
+      portFree(schedule->groups);
+   if (schedule->channels != NULL)
+      portFree(schedule->channels);
+   memset(schedule, 0, sizeof(SampleSchedule));
+}
+
+size_t init_sample_schedule(SampleSchedule *schedule, const ChannelSample *samples, size_t channelCount) {
+   memset(schedule, 0, sizeof(SampleSchedule));
+   if (channelCount == 0)
+      return 0;
+
+   schedule->groups = (SampleRateGroup *) portMalloc(sizeof(SampleRateGroup) * channelCount);
+   schedule->channels = (unsigned short *) portMalloc(sizeof(unsigned short) * channelCount * 2);
+   if (schedule->groups == NULL || schedule->channels == NULL) {
+      pr_error("could not allocate sample schedule\r\n");
+      free_sample_schedule(schedule);
+      return 0;
+   }
+
+   /*
+    * Collect the distinct rates, fastest first. A higher rate is a smaller
+    * tick interval; the list is tiny so an insertion sort is fine.
+    */
+   for (size_t i = 0; i < channelCount; i++) {
+      const unsigned short sampleRate = samples[i].cfg->sampleRate;
+      size_t g = 0;
+      while (g < schedule->groupCount && isHigherSampleRate(schedule->groups[g].sampleRate, sampleRate))
+         g++;
+      if (g < schedule->groupCount && schedule->groups[g].sampleRate == sampleRate)
+         continue;
+
+      for (size_t j = schedule->groupCount; j > g; j--)
+         schedule->groups[j] = schedule->groups[j - 1];
+      schedule->groups[g].sampleRate = sampleRate;
+      schedule->groups[g].count = 0;
+      schedule->groupCount++;
+   }
+
+   size_t position = 0;
+   for (size_t g = 0; g < schedule->groupCount; g++) {
+      SampleRateGroup *group = schedule->groups + g;
+      group->first = position;
+      for (size_t i = 0; i < channelCount; i++) {
+         if (samples[i].cfg->sampleRate == group->sampleRate)
+            schedule->channels[position++] = i;
+      }
+      group->count = position - group->first;
+   }
+
+   for (size_t i = 0; i < channelCount; i++) {
+      if (samples[i].cfg->flags & ALWAYS_SAMPLED) {
+         schedule->channels[position++] = i;
+         schedule->alwaysSampledCount++;
+      }
+   }
+
+   schedule->channelCount = channelCount;
+   return channelCount;
+}
+
+int sample_schedule_is_due(const SampleSchedule *schedule, size_t logTick) {
+   for (size_t g = 0; g < schedule->groupCount; g++) {
+      if (logTick % schedule->groups[g].sampleRate == 0)
+         return 1;
+   }
+   return 0;
+}
+
+int populate_scheduled_sample_buffer(LoggerMessage *lm, const SampleSchedule *schedule, size_t logTick) {
+   unsigned short highestRate = SAMPLE_DISABLED;
+   ChannelSample *samples = lm->channelSamples;
+   const size_t count = schedule->channelCount;
+
+   for (size_t g = 0; g < schedule->groupCount; g++) {
+      const SampleRateGroup *group = schedule->groups + g;
+      if (logTick % group->sampleRate != 0)
+         continue;
+
+      // First due group is the fastest; reset the buffer before filling it.
+      if (highestRate == SAMPLE_DISABLED) {
+         highestRate = group->sampleRate;
+         for (size_t i = 0; i < count; i++)
+            samples[i].populated = false;
+      }
+
+      const unsigned short *channel = schedule->channels + group->first;
+      for (size_t i = 0; i < group->count; i++, channel++) {
+         ChannelSample *sample = samples + *channel;
+         sample->populated = true;
+         populate_channel_sample(sample);
+      }
+   }
+
+   if (highestRate == SAMPLE_DISABLED)
+       return SAMPLE_DISABLED;
+
+   // Every channel belongs to one rate group, so the always sampled list starts at count.
+   const unsigned short *channel = schedule->channels + count;
+   for (size_t i = 0; i < schedule->alwaysSampledCount; i++, channel++) {
+      ChannelSample *sample = samples + *channel;
+      if (sample->populated)
+         continue;
+
+      sample->populated = true;
+      populate_channel_sample(sample);
+   }
+
+   lm->ticks = getCurrentTicks();
+   lm->sampleCount = count;
+
+   return highestRate;
+}
@@ -47,22 +47,56 @@ int g_telemetryBackgroundStreaming;
 
 xSemaphoreHandle onTick;
 
-#define LOGGER_MESSAGE_BUFFER_SIZE 10
+/*
+ * Enough buffers for every consumer to hold as many as it may at once: the
+ * file writer's queue and the one it is writing, each connection's pending
+ * samples and the one it is sending, plus the logger's current and next sample.
+ * Capped by LOGGER_MESSAGE_BUFFER_LIMIT where RAM is short; past the cap a
+ * backed up consumer costs dropped samples.
+ */
+#define LOGGER_MESSAGE_BUFFER_DEMAND (FILE_WRITER_QUEUE_SIZE + 1 + \
+		CONNECTIVITY_CHANNELS * (SAMPLE_RECORD_PENDING_LIMIT + 1) + 2)
+#define LOGGER_MESSAGE_BUFFER_SIZE (LOGGER_MESSAGE_BUFFER_DEMAND < LOGGER_MESSAGE_BUFFER_LIMIT ? \
+		LOGGER_MESSAGE_BUFFER_DEMAND : LOGGER_MESSAGE_BUFFER_LIMIT)
 static LoggerMessage g_sampleRecordMsgBuffer[LOGGER_MESSAGE_BUFFER_SIZE];
+static LoggerMessagePool g_sampleRecordPool;
+static SampleSchedule g_sampleSchedule;
+
+/* consumers may still read these after the logger moves on, so they are not on the stack */
+static LoggerMessage g_logStartMsg;
+static LoggerMessage g_logStopMsg;
+
+/* whether LED 3 is lit for a dropped sample */
+static int g_dropIndicated;
 
-static LoggerMessage getTimeInsensativeLoggerMessage(const enum LoggerMessageType t) {
-   LoggerMessage msg;
-   msg.type = t;
-   msg.ticks = 0; // Time insensitive.
+static volatile int g_sampleBuffersAllocated;
+
+static LoggerMessage * getTimeInsensativeLoggerMessage(LoggerMessage *msg, const enum LoggerMessageType t) {
+   msg->type = t;
+   msg->ticks = 0; // Time insensitive.
    return msg;
 }
 
-static LoggerMessage getLogStartMessage() {
-   return getTimeInsensativeLoggerMessage(LoggerMessageType_Start);
+static LoggerMessage * getLogStartMessage() {
+   return getTimeInsensativeLoggerMessage(&g_logStartMsg, LoggerMessageType_Start);
 }
 
-static LoggerMessage getLogStopMessage() {
-   return getTimeInsensativeLoggerMessage(LoggerMessageType_Stop);
+static LoggerMessage * getLogStopMessage() {
+   return getTimeInsensativeLoggerMessage(&g_logStopMsg, LoggerMessageType_Stop);
+}
+
+/**
+ * Lights LED 3 while samples are being dropped and clears it once one gets through.
+ */
+static void indicateDroppedSample(int dropped) {
+   if (dropped == g_dropIndicated)
+      return;
+
+   g_dropIndicated = dropped;
+   if (dropped)
+      LED_enable(3);
+   else
+      LED_disable(3);
 }
 
 /**
@@ -88,6 +122,14 @@ void stopLogging(){
 	g_loggingShouldRun = 0;
 }
 
+size_t getDroppedSampleCount(){
+	return g_sampleRecordPool.dropped;
+}
+
+int areSampleBuffersAllocated(){
+	return g_sampleBuffersAllocated;
+}
+
 void startLoggerTaskEx(int priority){
 	xTaskCreate( loggerTaskEx,( signed portCHAR * ) "logger",	LOGGER_STACK_SIZE, NULL, priority, NULL );
 }
@@ -95,17 +137,25 @@ void startLoggerTaskEx(int priority){
 static size_t initSampleRecords(LoggerConfig *loggerConfig){
 	size_t channelSampleCount = get_enabled_channel_count(loggerConfig);
 
-	for (size_t i=0; i < LOGGER_MESSAGE_BUFFER_SIZE; i++){
-		LoggerMessage *msg = (g_sampleRecordMsgBuffer + i);
-		msg->type = LoggerMessageType_Sample;
-		if (msg->channelSamples != NULL){
-			vPortFree(msg->channelSamples);
-		}
-		ChannelSample *channelSamples = create_channel_sample_buffer(loggerConfig, channelSampleCount);
+	/* buffers still held by consumers are rebuilt once they are released */
+	logger_message_pool_invalidate(&g_sampleRecordPool);
+
+	/* the schedule only depends on the buffer layout, so build it from a scratch buffer */
+	free_sample_schedule(&g_sampleSchedule);
+	ChannelSample *channelSamples = create_channel_sample_buffer(loggerConfig, channelSampleCount);
+	if (channelSamples != NULL){
 		init_channel_sample_buffer(loggerConfig, channelSamples, channelSampleCount);
-		msg->channelSamples = channelSamples;
+		init_sample_schedule(&g_sampleSchedule, channelSamples, channelSampleCount);
+		vPortFree(channelSamples);
+	}
+
+	const size_t failed = logger_message_pool_allocate(&g_sampleRecordPool, loggerConfig,
+			g_sampleSchedule.channelCount);
+	if (failed > 0){
+		pr_error_int(failed);
+		pr_error(" sample buffers could not be allocated\r\n");
 	}
-	return channelSampleCount;
+	return g_sampleSchedule.channelCount;
 }
 
 static int calcTelemetrySampleRate(LoggerConfig *config, int desiredSampleRate){
@@ -133,13 +183,13 @@ size_t updateSampleRates(LoggerConfig *loggerConfig, int *loggingSampleRate,
 
 void loggerTaskEx(void *params) {
 g_loggingShouldRun = 0;
-memset(&g_sampleRecordMsgBuffer, 0, sizeof(g_sampleRecordMsgBuffer));
+logger_message_pool_init(&g_sampleRecordPool, g_sampleRecordMsgBuffer, LOGGER_MESSAGE_BUFFER_SIZE);
 vSemaphoreCreateBinary(onTick);
 
 LoggerConfig *loggerConfig = getWorkingLoggerConfig();
 
 g_isLogging = 0;
-size_t bufferIndex = 0;
+LoggerMessage *msg = NULL;
 size_t currentTicks = 0;
 g_configChanged = 1;
 size_t channelCount = 0;
@@ -163,19 +213,25 @@ while (1) {
         channelCount = updateSampleRates(loggerConfig, &loggingSampleRate, &telemetrySampleRate,
                 &sampleRateTimebase);
         backgroundStreaming = loggerConfig->ConnectivityConfigs.telemetryConfig.backgroundStreaming;
+        if (msg != NULL) {
+            logger_message_release(msg);
+            msg = NULL;
+        }
         resetLapCount();
         resetGpsDistance();
         g_configChanged = 0;
+        g_sampleBuffersAllocated = 1;
     }
 
     if (g_loggingShouldRun && !g_isLogging) {
         pr_info("Logging started\r\n");
         g_isLogging = 1;
         LED_disable(3);
+        g_dropIndicated = 0;
 
-        LoggerMessage logStartMsg = getLogStartMessage();
-        queue_logfile_record(&logStartMsg);
-        queueTelemetryRecord(&logStartMsg);
+        LoggerMessage *logStartMsg = getLogStartMessage();
+        queue_logfile_record(logStartMsg);
+        queueTelemetryRecord(logStartMsg);
     }
 
     if (!g_loggingShouldRun && g_isLogging) {
@@ -183,34 +239,59 @@ while (1) {
         g_isLogging = 0;
         LED_disable(2);
 
-        LoggerMessage logStopMsg = getLogStopMessage();
-        queue_logfile_record(&logStopMsg);
-        queueTelemetryRecord(&logStopMsg);
+        pr_info_int(g_sampleRecordPool.dropped);
+        pr_info(" samples dropped\r\n");
+
+        LoggerMessage *logStopMsg = getLogStopMessage();
+        queue_logfile_record(logStopMsg);
+        queueTelemetryRecord(logStopMsg);
+    }
+
+    if (msg == NULL) {
+        msg = logger_message_pool_acquire(&g_sampleRecordPool, loggerConfig, channelCount);
+        if (msg == NULL) {
+            // Only a tick with something to sample loses a sample.
+            if (sample_schedule_is_due(&g_sampleSchedule, currentTicks)) {
+                logger_message_pool_drop(&g_sampleRecordPool);
+                indicateDroppedSample(1);
+            }
+            continue;
+        }
     }
 
     // Check if we need to actually populate the buffer.
-    LoggerMessage *msg = &g_sampleRecordMsgBuffer[bufferIndex];
-    int sampledRate = populate_sample_buffer(msg, channelCount, currentTicks);
+    int sampledRate = populate_scheduled_sample_buffer(msg, &g_sampleSchedule, currentTicks);
     msg->sampleCount = channelCount;
 
     // If here, no sample to give.
     if (sampledRate == SAMPLE_DISABLED)
         continue;
 
-    // We only log to file if the user has manually pushed the logging button.
-    if (g_isLogging && sampledRate >= loggingSampleRate) {
-        const portBASE_TYPE res = queue_logfile_record(msg);
-        if (res != pdTRUE)
-            LED_enable(3);
+    /*
+     * Claim the buffer for the next sample before handing this one out. If
+     * every buffer is still held by a consumer this sample is dropped and
+     * its buffer is reused.
+     */
+    LoggerMessage *nextMsg = logger_message_pool_acquire(&g_sampleRecordPool, loggerConfig, channelCount);
+    if (nextMsg == NULL) {
+        logger_message_pool_drop(&g_sampleRecordPool);
+        indicateDroppedSample(1);
+        continue;
     }
 
+    // We only log to file if the user has manually pushed the logging button.
+    int dropped = 0;
+    if (g_isLogging && sampledRate >= loggingSampleRate)
+        dropped = queue_logfile_record(msg) != pdTRUE;
+    indicateDroppedSample(dropped);
+
     // Log if the user has manually pushed the logging button or if background is enabled.
     if ((g_isLogging || backgroundStreaming) &&
             (sampledRate >= telemetrySampleRate || currentTicks % telemetrySampleRate == 0)) {
         queueTelemetryRecord(msg);
     }
 
-    ++bufferIndex;
-    bufferIndex %= LOGGER_MESSAGE_BUFFER_SIZE;
+    logger_message_release(msg);
+    msg = nextMsg;
 }
 }
@@ -95,6 +95,7 @@ void registerLuaLoggerBindings(lua_State *L){
 
 	lua_registerlight(L, "addChannel", Lua_AddVirtualChannel);
 	lua_registerlight(L, "setChannel", Lua_SetVirtualChannelValue);
+	lua_registerlight(L, "setChannels", Lua_SetVirtualChannelValues);
 }
 
 ////////////////////////////////////////////////////
@@ -567,3 +568,31 @@ int Lua_SetVirtualChannelValue(lua_State *L){
 	}
 	return 0;
 }
+
+/**
+ * Sets several virtual channels from one table, keyed by channel id or name:
+ * setChannels({[speedId] = 12.5, Boost = 1.2}).  Entries for unknown channels
+ * or with values that are not numbers are skipped.
+ * @return the number of channels set
+ */
+int Lua_SetVirtualChannelValues(lua_State *L){
+	int count = 0;
+	if (lua_istable(L, 1)){
+		lua_pushnil(L);
+		while (lua_next(L, 1) != 0){
+			int id = INVALID_VIRTUAL_CHANNEL;
+			if (lua_type(L, -2) == LUA_TNUMBER){
+				id = lua_tointeger(L, -2);
+			} else if (lua_type(L, -2) == LUA_TSTRING){
+				id = find_virtual_channel(lua_tostring(L, -2));
+			}
+			if (id >= 0 && (size_t) id < get_virtual_channel_count() && lua_isnumber(L, -1)){
+				set_virtual_channel_value(id, lua_tonumber(L, -1));
+				count++;
+			}
+			lua_pop(L, 1);
+		}
+	}
+	lua_pushinteger(L, count);
+	return 1;
+}
@@ -0,0 +1,112 @@
+/*
+ * sampleDelta.c
+ *
+ * Change-only filtering of telemetry sample records; see sampleDelta.h.
+ */
+#include "sampleDelta.h"
+#include "mem_mang.h"
+#include "mod_string.h"
+
+void sample_delta_init(SampleDelta *delta){
+	delta->channelCount = 0;
+	delta->samples = NULL;
+	delta->channels = NULL;
+}
+
+void sample_delta_free(SampleDelta *delta){
+	if (delta->samples) portFree(delta->samples);
+	if (delta->channels) portFree(delta->channels);
+	sample_delta_init(delta);
+}
+
+float sample_delta_deadband(const ChannelConfig *cfg){
+	float deadband = 0.5f;
+	for (size_t i = 0; i < cfg->precision; i++){
+		deadband /= 10;
+	}
+	return deadband;
+}
+
+void sample_delta_keyframe(SampleDelta *delta){
+	for (size_t i = 0; i < delta->channelCount; i++){
+		delta->channels[i].cfg = NULL;
+	}
+}
+
+/* the change since the value last sent, taken in the channel's own type */
+static float sampleChange(const ChannelSample *sample, const SampleDeltaChannel *channel){
+	switch(sample->sampleData){
+		case SampleData_Int:
+		case SampleData_Int_Noarg:
+			return (float)(sample->valueInt - channel->valueInt);
+		case SampleData_LongLong:
+		case SampleData_LongLong_Noarg:
+			return (float)(sample->valueLongLong - channel->valueLongLong);
+		case SampleData_Double:
+		case SampleData_Double_Noarg:
+			return (float)(sample->valueDouble - channel->valueDouble);
+		default:
+			return sample->valueFloat - channel->valueFloat;
+	}
+}
+
+static void keepValue(SampleDeltaChannel *channel, const ChannelSample *sample){
+	switch(sample->sampleData){
+		case SampleData_Int:
+		case SampleData_Int_Noarg:
+			channel->valueInt = sample->valueInt;
+			break;
+		case SampleData_LongLong:
+		case SampleData_LongLong_Noarg:
+			channel->valueLongLong = sample->valueLongLong;
+			break;
+		case SampleData_Double:
+		case SampleData_Double_Noarg:
+			channel->valueDouble = sample->valueDouble;
+			break;
+		default:
+			channel->valueFloat = sample->valueFloat;
+			break;
+	}
+}
+
+static int resize(SampleDelta *delta, size_t channelCount){
+	sample_delta_free(delta);
+	delta->samples = (ChannelSample *)portMalloc(sizeof(ChannelSample) * channelCount);
+	delta->channels = (SampleDeltaChannel *)portMalloc(sizeof(SampleDeltaChannel) * channelCount);
+	if (delta->samples == NULL || delta->channels == NULL){
+		sample_delta_free(delta);
+		return 0;
+	}
+	delta->channelCount = channelCount;
+	sample_delta_keyframe(delta);
+	return 1;
+}
+
+ChannelSample * sample_delta_filter(SampleDelta *delta, ChannelSample *samples, size_t channelCount){
+	if (delta->channelCount != channelCount && !resize(delta, channelCount)){
+		return samples;
+	}
+
+	memcpy(delta->samples, samples, sizeof(ChannelSample) * channelCount);
+	for (size_t i = 0; i < channelCount; i++){
+		ChannelSample *sample = delta->samples + i;
+		if (!sample->populated) continue;
+
+		SampleDeltaChannel *channel = delta->channels + i;
+		if (channel->cfg == sample->cfg){
+			//compared against the last value sent, so a slow drift is still sent once it adds up
+			const float change = sampleChange(sample, channel);
+			if (change < channel->deadband && -change < channel->deadband){
+				sample->populated = false;
+				continue;
+			}
+		}
+		else{
+			channel->cfg = sample->cfg;
+			channel->deadband = sample_delta_deadband(sample->cfg);
+		}
+		keepValue(channel, sample);
+	}
+	return delta->samples;
+}
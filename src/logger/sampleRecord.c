@@ -6,8 +6,11 @@
  */
 #include "sampleRecord.h"
 #include "loggerConfig.h"
+#include "loggerSampleData.h"
 #include "mem_mang.h"
+#include "mod_string.h"
 #include "FreeRTOS.h"
+#include "task.h"
 #include "taskUtil.h"
 
 ChannelSample * create_channel_sample_buffer(LoggerConfig *loggerConfig, size_t channelCount){
@@ -16,6 +19,106 @@ ChannelSample * create_channel_sample_buffer(LoggerConfig *loggerConfig, size_t
 	return samples;
 }
 
+const ChannelSample * get_fix_sample(const ChannelSample *samples, size_t channelCount){
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		if (samples->fixTimestamped && samples->populated) return samples;
+	}
+	return NULL;
+}
+
 int isValidLoggerMessageAge(LoggerMessage *lm) {
     return (getCurrentTicks() - lm->ticks) < 10;
 }
+
+void logger_message_retain(LoggerMessage *msg){
+	taskENTER_CRITICAL();
+	msg->refCount++;
+	taskEXIT_CRITICAL();
+}
+
+void logger_message_release(LoggerMessage *msg){
+	taskENTER_CRITICAL();
+	if (msg->refCount > 0) msg->refCount--;
+	taskEXIT_CRITICAL();
+}
+
+void logger_message_pool_init(LoggerMessagePool *pool, LoggerMessage *messages, size_t size){
+	memset(messages, 0, sizeof(LoggerMessage) * size);
+	pool->messages = messages;
+	pool->size = size;
+	pool->next = 0;
+	pool->generation = 1;
+	pool->dropped = 0;
+}
+
+void logger_message_pool_invalidate(LoggerMessagePool *pool){
+	pool->generation++;
+}
+
+/* gives a claimed message a buffer for the current layout; false if there was no memory for it */
+static bool rebuildMessage(LoggerMessagePool *pool, LoggerMessage *msg, LoggerConfig *loggerConfig, size_t channelCount){
+	if (msg->generation == pool->generation)
+		return true;
+
+	if (msg->channelSamples != NULL){
+		portFree(msg->channelSamples);
+	}
+	ChannelSample *channelSamples = create_channel_sample_buffer(loggerConfig, channelCount);
+	msg->channelSamples = channelSamples;
+	if (channelSamples == NULL)
+		return false;
+
+	init_channel_sample_buffer(loggerConfig, channelSamples, channelCount);
+	msg->generation = pool->generation;
+	return true;
+}
+
+size_t logger_message_pool_allocate(LoggerMessagePool *pool, LoggerConfig *loggerConfig, size_t channelCount){
+	size_t failed = 0;
+	for (size_t i = 0; i < pool->size; i++){
+		LoggerMessage *msg = pool->messages + i;
+
+		taskENTER_CRITICAL();
+		const bool claimed = msg->refCount == 0;
+		if (claimed) msg->refCount = 1;
+		taskEXIT_CRITICAL();
+
+		if (!claimed)
+			continue;
+		if (!rebuildMessage(pool, msg, loggerConfig, channelCount))
+			failed++;
+		logger_message_release(msg);
+	}
+	return failed;
+}
+
+LoggerMessage * logger_message_pool_acquire(LoggerMessagePool *pool, LoggerConfig *loggerConfig, size_t channelCount){
+	LoggerMessage *msg = NULL;
+
+	taskENTER_CRITICAL();
+	for (size_t i = 0; i < pool->size; i++){
+		LoggerMessage *candidate = pool->messages + ((pool->next + i) % pool->size);
+		if (0 == candidate->refCount){
+			candidate->refCount = 1;
+			pool->next = (pool->next + i + 1) % pool->size;
+			msg = candidate;
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (NULL == msg)
+		return NULL;
+
+	if (!rebuildMessage(pool, msg, loggerConfig, channelCount)){
+		logger_message_release(msg);
+		return NULL;
+	}
+	msg->type = LoggerMessageType_Sample;
+	msg->sampleCount = channelCount;
+	return msg;
+}
+
+void logger_message_pool_drop(LoggerMessagePool *pool){
+	pool->dropped++;
+}
@@ -0,0 +1,134 @@
+/*
+ * telemetryFrame.c
+ *
+ * Encoder for binary telemetry frames; see telemetryFrame.h for the layout.
+ */
+#include "telemetryFrame.h"
+#include "binaryLogFormat.h"
+#include "crc16.h"
+
+typedef struct _FrameWriter {
+	Serial *serial;
+	uint16_t crc;
+	size_t length;
+	//COBS code byte followed by the block, so each block goes out as one write
+	uint8_t block[TELEMETRY_FRAME_COBS_BLOCK + 1];
+} FrameWriter;
+
+//serial ports that negotiated binary telemetry; any other port gets JSON
+static Serial * g_binarySerials[SERIAL_COUNT];
+
+int filterTelemetryFormat(int format){
+	switch(format){
+		case TelemetryFormat_Json:
+		case TelemetryFormat_Binary:
+			return format;
+		default:
+			return TELEMETRY_FORMAT_DEFAULT;
+	}
+}
+
+void set_telemetry_format(Serial *serial, enum TelemetryFormat format){
+	Serial **slot = NULL;
+	for (size_t i = 0; i < SERIAL_COUNT; i++){
+		if (g_binarySerials[i] == serial){
+			g_binarySerials[i] = NULL;
+		}
+		if (slot == NULL && g_binarySerials[i] == NULL){
+			slot = &g_binarySerials[i];
+		}
+	}
+	if (format == TelemetryFormat_Binary && slot != NULL){
+		*slot = serial;
+	}
+}
+
+enum TelemetryFormat get_telemetry_format(Serial *serial){
+	for (size_t i = 0; i < SERIAL_COUNT; i++){
+		if (g_binarySerials[i] == serial) return TelemetryFormat_Binary;
+	}
+	return TelemetryFormat_Json;
+}
+
+static void flushBlock(FrameWriter *writer){
+	writer->block[0] = writer->length + 1;
+	writer->serial->put_buf((const char *)writer->block, writer->length + 1);
+	writer->length = 0;
+}
+
+static void encodeByte(FrameWriter *writer, uint8_t b){
+	if (b == 0){
+		flushBlock(writer);
+		return;
+	}
+	writer->block[++writer->length] = b;
+	if (writer->length == TELEMETRY_FRAME_COBS_BLOCK){
+		flushBlock(writer);
+	}
+}
+
+static void writeFrame(FrameWriter *writer, const uint8_t *data, size_t length){
+	writer->crc = crc16_ccitt(writer->crc, data, length);
+	for (size_t i = 0; i < length; i++){
+		encodeByte(writer, data[i]);
+	}
+}
+
+static void startFrame(FrameWriter *writer, Serial *serial, enum TelemetryFrameType type){
+	writer->serial = serial;
+	writer->crc = TELEMETRY_FRAME_CRC_INIT;
+	writer->length = 0;
+	serial->put_c(TELEMETRY_FRAME_DELIMITER);
+	uint8_t frameType = type;
+	writeFrame(writer, &frameType, 1);
+}
+
+static void endFrame(FrameWriter *writer){
+	encodeByte(writer, writer->crc & 0xff);
+	encodeByte(writer, (writer->crc >> 8) & 0xff);
+	flushBlock(writer);
+	writer->serial->put_c(TELEMETRY_FRAME_DELIMITER);
+}
+
+void telemetry_send_meta_frame(Serial *serial, const ChannelSample *samples, size_t channelCount){
+	FrameWriter writer;
+	startFrame(&writer, serial, TelemetryFrameType_Meta);
+
+	uint8_t count[2] = {(uint8_t)(channelCount & 0xff), (uint8_t)((channelCount >> 8) & 0xff)};
+	writeFrame(&writer, count, sizeof(count));
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		uint8_t meta[BINARY_LOG_CHANNEL_META_SIZE];
+		binary_log_encode_channel_meta(meta, samples);
+		writeFrame(&writer, meta, sizeof(meta));
+	}
+	endFrame(&writer);
+}
+
+void telemetry_send_sample_frame(Serial *serial, const ChannelSample *samples, size_t channelCount, unsigned int tick){
+	FrameWriter writer;
+	startFrame(&writer, serial, TelemetryFrameType_Sample);
+
+	uint8_t tickBytes[4];
+	for (size_t i = 0; i < sizeof(tickBytes); i++, tick >>= 8){
+		tickBytes[i] = tick & 0xff;
+	}
+	writeFrame(&writer, tickBytes, sizeof(tickBytes));
+
+	for (size_t i = 0; i < channelCount; i += 8){
+		uint8_t mask = binary_log_encode_mask(samples + i, channelCount - i);
+		writeFrame(&writer, &mask, 1);
+	}
+	for (size_t i = 0; i < channelCount; i++, samples++){
+		if (!samples->populated) continue;
+		uint8_t value[8];
+		size_t size = binary_log_encode_value(value, samples);
+		writeFrame(&writer, value, size);
+	}
+	endFrame(&writer);
+}
+
+void telemetry_send_event_frame(Serial *serial, enum TelemetryFrameType type){
+	FrameWriter writer;
+	startFrame(&writer, serial, type);
+	endFrame(&writer);
+}
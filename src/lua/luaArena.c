@@ -0,0 +1,207 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "luaArena.h"
+#include "mod_string.h"
+
+static size_t roundUp(size_t size) {
+   return (size + LUA_ARENA_ALIGN - 1) & ~((size_t) LUA_ARENA_ALIGN - 1);
+}
+
+static int isSmall(size_t size) {
+   return size <= LUA_ARENA_SMALL_MAX;
+}
+
+static LuaArenaBlock ** smallList(LuaArena *arena, size_t size) {
+   return arena->small + size / LUA_ARENA_ALIGN - 1;
+}
+
+static unsigned char * arenaTop(const LuaArena *arena) {
+   return arena->base + arena->top;
+}
+
+/* hands free large blocks at the top back to the untouched space */
+static void trimTop(LuaArena *arena) {
+   LuaArenaBlock **link = &arena->large;
+   while (*link && (*link)->next)
+      link = &(*link)->next;
+
+   LuaArenaBlock *last = *link;
+   if (last && (unsigned char *) last + last->size == arenaTop(arena)) {
+      arena->top -= last->size;
+      *link = NULL;
+   }
+}
+
+static void insertLarge(LuaArena *arena, unsigned char *p, size_t size) {
+   LuaArenaBlock *prev = NULL;
+   LuaArenaBlock *next = arena->large;
+   while (next && (unsigned char *) next < p) {
+      prev = next;
+      next = next->next;
+   }
+
+   LuaArenaBlock *block = (LuaArenaBlock *) p;
+   block->size = size;
+   block->next = next;
+   if (next && p + size == (unsigned char *) next) {
+      block->size += next->size;
+      block->next = next->next;
+   }
+
+   if (prev && (unsigned char *) prev + prev->size == p) {
+      prev->size += block->size;
+      prev->next = block->next;
+   } else if (prev) {
+      prev->next = block;
+   } else {
+      arena->large = block;
+   }
+}
+
+static void releaseBlock(LuaArena *arena, unsigned char *p, size_t size) {
+   if (p + size == arenaTop(arena)) {
+      arena->top -= size;
+      trimTop(arena);
+   } else if (isSmall(size)) {
+      LuaArenaBlock **list = smallList(arena, size);
+      LuaArenaBlock *block = (LuaArenaBlock *) p;
+      block->next = *list;
+      *list = block;
+   } else {
+      insertLarge(arena, p, size);
+   }
+}
+
+static unsigned char * takeLarge(LuaArena *arena, size_t size) {
+   LuaArenaBlock **link = &arena->large;
+   while (*link && (*link)->size < size)
+      link = &(*link)->next;
+
+   LuaArenaBlock *block = *link;
+   if (!block)
+      return NULL;
+
+   *link = block->next;
+   const size_t remainder = block->size - size;
+   if (remainder)
+      releaseBlock(arena, (unsigned char *) block + size, remainder);
+
+   return (unsigned char *) block;
+}
+
+static unsigned char * allocBlock(LuaArena *arena, size_t size) {
+   if (isSmall(size) && *smallList(arena, size)) {
+      LuaArenaBlock **list = smallList(arena, size);
+      LuaArenaBlock *block = *list;
+      *list = block->next;
+      return (unsigned char *) block;
+   }
+
+   // Reuse a hole before growing, so large blocks pack towards the bottom.
+   unsigned char *p = isSmall(size) ? NULL : takeLarge(arena, size);
+   if (!p && size <= arena->size - arena->top) {
+      p = arenaTop(arena);
+      arena->top += size;
+   }
+   if (!p)
+      p = takeLarge(arena, size);
+
+   return p;
+}
+
+static void addUsed(LuaArena *arena, size_t size) {
+   arena->used += size;
+   if (arena->used > arena->highWater)
+      arena->highWater = arena->used;
+}
+
+void lua_arena_init(LuaArena *arena, void *memory, size_t size) {
+   memset(arena, 0, sizeof(LuaArena));
+   arena->base = (unsigned char *) memory;
+   arena->size = size & ~((size_t) LUA_ARENA_ALIGN - 1);
+}
+
+void lua_arena_reset(LuaArena *arena) {
+   arena->top = 0;
+   arena->large = NULL;
+   arena->used = 0;
+   memset(arena->small, 0, sizeof(arena->small));
+}
+
+void * lua_arena_realloc(LuaArena *arena, void *ptr, size_t osize, size_t nsize) {
+   unsigned char *p = (unsigned char *) ptr;
+   const size_t oldSize = p ? roundUp(osize) : 0;
+   const size_t newSize = roundUp(nsize);
+
+   if (newSize == 0) {
+      if (p) {
+         releaseBlock(arena, p, oldSize);
+         arena->used -= oldSize;
+      }
+      return NULL;
+   }
+   if (p && newSize <= oldSize) {
+      if (newSize < oldSize)
+         releaseBlock(arena, p + newSize, oldSize - newSize);
+      arena->used -= oldSize - newSize;
+      return p;
+   }
+
+   // The newest block can grow where it is.
+   if (p && p + oldSize == arenaTop(arena) && newSize - oldSize <= arena->size - arena->top) {
+      arena->top += newSize - oldSize;
+      addUsed(arena, newSize - oldSize);
+      return p;
+   }
+
+   unsigned char *block = allocBlock(arena, newSize);
+   if (!block) {
+      arena->failures++;
+      return NULL;
+   }
+   arena->allocations++;
+   addUsed(arena, newSize);
+
+   if (p) {
+      memcpy(block, p, osize);
+      releaseBlock(arena, p, oldSize);
+      arena->used -= oldSize;
+   }
+   return block;
+}
+
+void lua_arena_get_stats(const LuaArena *arena, LuaArenaStats *stats) {
+   size_t largest = arena->size - arena->top;
+   for (const LuaArenaBlock *block = arena->large; block; block = block->next) {
+      if (block->size > largest)
+         largest = block->size;
+   }
+   for (size_t i = 0; i < LUA_ARENA_SIZE_CLASSES; i++) {
+      const size_t size = (i + 1) * LUA_ARENA_ALIGN;
+      if (arena->small[i] && size > largest)
+         largest = size;
+   }
+
+   stats->size = arena->size;
+   stats->used = arena->used;
+   stats->highWater = arena->highWater;
+   stats->largestFree = largest;
+   stats->allocations = arena->allocations;
+   stats->failures = arena->failures;
+}
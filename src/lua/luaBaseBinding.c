@@ -15,6 +15,7 @@
 #include "command.h"
 #include "taskUtil.h"
 #include "luaTask.h"
+#include "luaScheduler.h"
 #include "printk.h"
 
 
@@ -22,6 +23,10 @@ void registerBaseLuaFunctions(lua_State *L){
 	lua_registerlight(L,"getStackSize", Lua_GetStackSize);
 	lua_registerlight(L,"setTickRate", Lua_SetTickRate);
 	lua_registerlight(L,"getTickRate", Lua_GetTickRate);
+	lua_registerlight(L,"addTickHandler", Lua_AddTickHandler);
+	lua_registerlight(L,"removeTickHandler", Lua_RemoveTickHandler);
+	lua_registerlight(L,"setGcSteps", Lua_SetGcSteps);
+	lua_registerlight(L,"getGcSteps", Lua_GetGcSteps);
 	lua_registerlight(L,"print", Lua_PrintLog);
 	lua_registerlight(L,"println", Lua_PrintLogLn);
 	lua_registerlight(L,"setLogLevel", Lua_SetLogLevel);
@@ -33,11 +38,19 @@ int Lua_GetStackSize(lua_State *L){
 	return 1;
 }
 
+/**
+ * setTickRate(rate [, budgetMs]) runs onTick rate times a second.  Passing
+ * budgetMs stops any run of onTick that takes longer, as for addTickHandler.
+ */
 int Lua_SetTickRate(lua_State *L){
 	if (lua_gettop(L) >= 1){
 		int freq = lua_tointeger(L, 1);
 		set_ontick_freq(freq);
 	}
+	if (lua_gettop(L) >= 2){
+		const int budgetMs = lua_tointeger(L, 2);
+		if (budgetMs >= 0) set_ontick_budget(budgetMs);
+	}
 	return 0;
 }
 
@@ -46,6 +59,52 @@ int Lua_GetTickRate(lua_State *L){
 	return 1;
 }
 
+/**
+ * addTickHandler(function, rate [, budgetMs]) runs function rate times a second
+ * alongside onTick, returning an id for removeTickHandler or nil if it could not be added.
+ */
+int Lua_AddTickHandler(lua_State *L){
+	if (lua_gettop(L) < 2 || !lua_isfunction(L, 1)) return 0;
+
+	const int freq = lua_tointeger(L, 2);
+	const int budgetMs = lua_gettop(L) >= 3 ? lua_tointeger(L, 3) : 0;
+	if (freq <= 0 || budgetMs < 0) return 0;
+
+	lua_pushvalue(L, 1);
+	const int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	const int id = add_tick_handler(ref, freq, budgetMs);
+	if (id < 0){
+		luaL_unref(L, LUA_REGISTRYINDEX, ref);
+		return 0;
+	}
+	lua_pushinteger(L, id);
+	return 1;
+}
+
+int Lua_RemoveTickHandler(lua_State *L){
+	if (lua_gettop(L) >= 1){
+		luaL_unref(L, LUA_REGISTRYINDEX, remove_tick_handler(lua_tointeger(L, 1)));
+	}
+	return 0;
+}
+
+/**
+ * setGcSteps(steps) sets how many garbage collector steps run after each tick
+ * handler; 0 leaves collection to Lua.
+ */
+int Lua_SetGcSteps(lua_State *L){
+	if (lua_gettop(L) >= 1){
+		int steps = lua_tointeger(L, 1);
+		if (steps >= 0) lua_scheduler_set_gc_steps(steps);
+	}
+	return 0;
+}
+
+int Lua_GetGcSteps(lua_State *L){
+	lua_pushinteger(L, lua_scheduler_get_gc_stats()->stepBudget);
+	return 1;
+}
+
 static int printLog(lua_State *L, int addNewline){
 	if (lua_gettop(L) >= 1){
 		const char *msg = lua_tostring(L, 1);
@@ -0,0 +1,183 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "luaScheduler.h"
+#include "mod_string.h"
+
+static LuaCallback g_callbacks[LUA_MAX_CALLBACKS];
+static LuaGcStats g_gcStats = {LUA_DEFAULT_GC_STEPS};
+
+/* how far now is past t, negative if t is still to come; safe across the tick count wrapping */
+static int ticksPast(size_t now, size_t t) {
+   return (int) (now - t);
+}
+
+static size_t defaultBudget(size_t interval) {
+   return interval > 1 ? interval / 2 : 1;
+}
+
+static LuaCallback * getCallback(int id) {
+   if (id < 0 || id >= LUA_MAX_CALLBACKS || !g_callbacks[id].active)
+      return NULL;
+
+   return g_callbacks + id;
+}
+
+/* moves the next run up to the latest one due by now, returning how many runs were passed over */
+static unsigned int dropMissedRuns(LuaCallback *cb, size_t now) {
+   const int late = ticksPast(now, cb->nextRun);
+   if (late <= 0)
+      return 0;
+
+   const unsigned int missed = late / cb->interval;
+   cb->nextRun += missed * cb->interval;
+   return missed;
+}
+
+void lua_scheduler_init(void) {
+   memset(g_callbacks, 0, sizeof(g_callbacks));
+   const unsigned int stepBudget = g_gcStats.stepBudget;
+   memset(&g_gcStats, 0, sizeof(g_gcStats));
+   g_gcStats.stepBudget = stepBudget;
+}
+
+int lua_scheduler_add(int ref, size_t interval, size_t budget, size_t now) {
+   if (interval == 0)
+      return -1;
+
+   for (int id = 0; id < LUA_MAX_CALLBACKS; id++) {
+      LuaCallback *cb = g_callbacks + id;
+      if (cb->active)
+         continue;
+
+      memset(cb, 0, sizeof(LuaCallback));
+      cb->active = 1;
+      cb->ref = ref;
+      cb->interval = interval;
+      cb->budget = budget ? budget : defaultBudget(interval);
+      cb->nextRun = now + interval;
+      return id;
+   }
+   return -1;
+}
+
+const LuaCallback * lua_scheduler_get(int id) {
+   return getCallback(id);
+}
+
+void lua_scheduler_remove(int id) {
+   LuaCallback *cb = getCallback(id);
+   if (cb)
+      cb->active = 0;
+}
+
+void lua_scheduler_set_interval(int id, size_t interval) {
+   LuaCallback *cb = getCallback(id);
+   if (!cb || interval == 0)
+      return;
+
+   cb->interval = interval;
+   if (cb->budget != LUA_BUDGET_NONE)
+      cb->budget = defaultBudget(interval);
+}
+
+void lua_scheduler_set_budget(int id, size_t budget) {
+   LuaCallback *cb = getCallback(id);
+   if (cb)
+      cb->budget = budget ? budget : defaultBudget(cb->interval);
+}
+
+int lua_scheduler_next_due(size_t now) {
+   int dueId = -1;
+   int mostLate = -1;
+   for (int id = 0; id < LUA_MAX_CALLBACKS; id++) {
+      const LuaCallback *cb = g_callbacks + id;
+      if (!cb->active)
+         continue;
+
+      const int late = ticksPast(now, cb->nextRun);
+      if (late > mostLate) {
+         mostLate = late;
+         dueId = id;
+      }
+   }
+   return dueId;
+}
+
+size_t lua_scheduler_ticks_until_due(size_t now, size_t maxTicks) {
+   size_t ticks = maxTicks;
+   for (int id = 0; id < LUA_MAX_CALLBACKS; id++) {
+      const LuaCallback *cb = g_callbacks + id;
+      if (!cb->active)
+         continue;
+
+      const int late = ticksPast(now, cb->nextRun);
+      if (late >= 0)
+         return 0;
+      if ((size_t) -late < ticks)
+         ticks = -late;
+   }
+   return ticks;
+}
+
+void lua_scheduler_ran(int id, size_t start, size_t end) {
+   LuaCallback *cb = getCallback(id);
+   if (!cb)
+      return;
+
+   LuaCallbackStats *stats = &cb->stats;
+   const size_t elapsed = end - start;
+   stats->runs++;
+   stats->lastTicks = elapsed;
+   if (elapsed > stats->maxTicks)
+      stats->maxTicks = elapsed;
+
+   cb->nextRun += cb->interval;
+   if (elapsed > cb->budget) {
+      stats->overruns++;
+      stats->skips++;
+      cb->nextRun += cb->interval;
+   }
+   stats->skips += dropMissedRuns(cb, end);
+}
+
+void lua_scheduler_postpone(int id, size_t now) {
+   LuaCallback *cb = getCallback(id);
+   if (!cb)
+      return;
+
+   cb->nextRun += cb->interval;
+   dropMissedRuns(cb, now);
+}
+
+void lua_scheduler_set_gc_steps(unsigned int steps) {
+   g_gcStats.stepBudget = steps;
+}
+
+const LuaGcStats * lua_scheduler_get_gc_stats(void) {
+   return &g_gcStats;
+}
+
+void lua_scheduler_gc_stepped(size_t start, size_t end, int cycleDone) {
+   const size_t elapsed = end - start;
+   g_gcStats.steps++;
+   if (cycleDone)
+      g_gcStats.cycles++;
+   if (elapsed > g_gcStats.maxStepTicks)
+      g_gcStats.maxStepTicks = elapsed;
+}
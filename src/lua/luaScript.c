@@ -2,6 +2,7 @@
 #include "mem_mang.h"
 #include "printk.h"
 #include "mod_string.h"
+#include "watchdog.h"
 
 
 #ifndef RCP_TESTING
@@ -10,6 +11,14 @@ static const volatile ScriptConfig g_scriptConfig  __attribute__((section(".scri
 static ScriptConfig g_scriptConfig = {DEFAULT_SCRIPT, MAGIC_NUMBER_SCRIPT_INIT};
 #endif
 
+#if SCRIPT_BYTECODE_LENGTH > 0
+#ifndef RCP_TESTING
+static const volatile ScriptBytecode g_scriptBytecode  __attribute__((section(".scriptbc\n\t#")));
+#else
+static ScriptBytecode g_scriptBytecode;
+#endif
+#endif
+
 static ScriptConfig * g_scriptBuffer = NULL;
 
 void initialize_script(){
@@ -118,8 +127,73 @@ int flashScriptPage(unsigned int page, const char *data, int mode){
 	return result;
 }
 
+#if SCRIPT_BYTECODE_LENGTH > 0
+
+/* FNV-1a */
+static uint32_t checksum(const unsigned char *data, size_t length){
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++){
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static uint32_t scriptChecksum(){
+	const char *script = getScript();
+	return checksum((const unsigned char *)script, strlen(script));
+}
+
+const unsigned char * get_script_bytecode(size_t *length){
+	const ScriptBytecode *bytecode = (const ScriptBytecode *)&g_scriptBytecode;
+	if (bytecode->magicInit != MAGIC_NUMBER_BYTECODE_INIT ||
+	    bytecode->firmware != SCRIPT_BYTECODE_FIRMWARE ||
+	    bytecode->length == 0 || bytecode->length > SCRIPT_BYTECODE_LENGTH ||
+	    bytecode->scriptChecksum != scriptChecksum() ||
+	    bytecode->codeChecksum != checksum(bytecode->code, bytecode->length)){
+		return NULL;
+	}
+	*length = bytecode->length;
+	return bytecode->code;
+}
+
+ScriptBytecode * create_script_bytecode(size_t length){
+	if (length == 0 || length > SCRIPT_BYTECODE_LENGTH) return NULL;
 
+	ScriptBytecode *bytecode = (ScriptBytecode *)portMalloc(offsetof(ScriptBytecode, code) + length);
+	if (bytecode != NULL){
+		bytecode->magicInit = MAGIC_NUMBER_BYTECODE_INIT;
+		bytecode->firmware = SCRIPT_BYTECODE_FIRMWARE;
+		bytecode->scriptChecksum = scriptChecksum();
+		bytecode->length = length;
+	}
+	return bytecode;
+}
 
+int flash_script_bytecode(ScriptBytecode *bytecode){
+	pr_info("flashing script bytecode...");
+	bytecode->codeChecksum = checksum(bytecode->code, bytecode->length);
+	/* give the sector erase the whole watchdog period */
+	watchdog_reset();
+	int result = memory_flash_region((void *)&g_scriptBytecode, (void *)bytecode,
+	                                 offsetof(ScriptBytecode, code) + bytecode->length);
+	portFree(bytecode);
+	if (result == 0) pr_info("success\r\n"); else pr_info("failed\r\n");
+	return result;
+}
 
+#else
 
+const unsigned char * get_script_bytecode(size_t *length){
+	return NULL;
+}
+
+ScriptBytecode * create_script_bytecode(size_t length){
+	return NULL;
+}
 
+int flash_script_bytecode(ScriptBytecode *bytecode){
+	portFree(bytecode);
+	return -1;
+}
+
+#endif
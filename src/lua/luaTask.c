@@ -5,6 +5,8 @@
 #include "semphr.h"
 #include "portable.h"
 #include "luaScript.h"
+#include "luaScheduler.h"
+#include "luaArena.h"
 #include "luaBaseBinding.h"
 #include "luaLoggerBinding.h"
 #include "mem_mang.h"
@@ -16,12 +18,25 @@
 #include "lua.h"
 #include "lauxlib.h"
 #include "lualib.h"
+#include "capabilities.h"
+#include "loggerTaskEx.h"
 
 
 #define DEFAULT_ONTICK_HZ 1
-#define MAX_ONTICK_HZ 30
 #define LUA_STACK_SIZE 1000
 
+/* how many Lua instructions run between checks of a callback's budget */
+#define BUDGET_CHECK_INSTRUCTIONS 1000
+
+/* the longest the task sleeps before checking for a script reload */
+#define MAX_IDLE_MS 100
+
+/* past this much Lua memory the collector runs on its own again, in case the steps between handlers fall behind */
+#define GC_BACKSTOP_KB ((int) (g_arena.size / 1024 * 3 / 4))
+
+/* an arena smaller than this is not worth splitting off the heap */
+#define LUA_ARENA_MIN_SIZE 8192
+
 #define LUA_PERIODIC_FUNCTION "onTick"
 
 
@@ -29,13 +44,33 @@ static lua_State *g_lua;
 static xSemaphoreHandle xLuaLock;
 static unsigned int lastPointer;
 static int g_shouldReloadScript;
+static int g_storeBytecodeRequested;
 static size_t onTickSleepInterval;
+static int g_onTickId;
+static size_t g_callbackDeadline;
+static LuaArena g_arena;
+static void *g_arenaMemory;
+static int g_collectorHeld;
 
 //#define ALLOC_DEBUG
 
 #ifdef ALLOC_DEBUG
 static int g_allocDebug = 0;
 #endif
+/* Lua has its own arena if there was room for it at startup, else it shares the heap */
+static void luaFree(void *ptr, size_t osize){
+	if (g_arenaMemory){
+		lua_arena_realloc(&g_arena, ptr, osize, 0);
+	}
+	else{
+		portFree(ptr);
+	}
+}
+
+static void * luaRealloc(void *ptr, size_t osize, size_t nsize){
+	return g_arenaMemory ? lua_arena_realloc(&g_arena, ptr, osize, nsize) : portRealloc(ptr, nsize);
+}
+
 void * myAlloc (void *ud, void *ptr, size_t osize,size_t nsize) {
 
 #ifdef ALLOC_DEBUG
@@ -50,7 +85,7 @@ void * myAlloc (void *ud, void *ptr, size_t osize,size_t nsize) {
 #endif
 
    if (nsize == 0) {
-     portFree(ptr);
+     luaFree(ptr, osize);
 #ifdef ALLOC_DEBUG
      if (g_allocDebug){
     	 SendString(" (free)");
@@ -62,7 +97,7 @@ void * myAlloc (void *ud, void *ptr, size_t osize,size_t nsize) {
    else{
 	 void *newPtr;
 	 if (osize != nsize){
-		 newPtr = portRealloc(ptr, nsize);
+		 newPtr = luaRealloc(ptr, osize, nsize);
 	 }
 	 else{
 		 newPtr = ptr;
@@ -103,6 +138,15 @@ int getAllocDebug(){
 #endif
 }
 
+void get_lua_arena_stats(LuaArenaStats *stats){
+	if (g_arenaMemory){
+		lua_arena_get_stats(&g_arena, stats);
+	}
+	else{
+		memset(stats, 0, sizeof(LuaArenaStats));
+	}
+}
+
 void lockLua(void){
 	xSemaphoreTake(xLuaLock, portMAX_DELAY);
 }
@@ -111,14 +155,48 @@ void unlockLua(void){
 	xSemaphoreGive(xLuaLock);
 }
 
+static size_t freqToTicks(size_t freq){
+	size_t ticks = msToTicks(1000 / freq);
+	return ticks ? ticks : 1;
+}
+
 void set_ontick_freq(size_t freq){
-	if (freq <= MAX_ONTICK_HZ) onTickSleepInterval = msToTicks(1000 / freq);
+	if (freq == 0 || freq > MAX_ONTICK_HZ) return;
+	onTickSleepInterval = freqToTicks(freq);
+	lua_scheduler_set_interval(g_onTickId, onTickSleepInterval);
 }
 
 size_t get_ontick_freq(){
 	return 1000 / ticksToMs(onTickSleepInterval);
 }
 
+void set_ontick_budget(size_t budgetMs){
+	lua_scheduler_set_budget(g_onTickId, msToTicks(budgetMs));
+}
+
+int add_tick_handler(int ref, size_t freq, size_t budgetMs){
+	if (freq == 0 || freq > MAX_ONTICK_HZ) return -1;
+	return lua_scheduler_add(ref, freqToTicks(freq), msToTicks(budgetMs), getCurrentTicks());
+}
+
+int remove_tick_handler(int id){
+	const LuaCallback *cb = lua_scheduler_get(id);
+	if (!cb || id == g_onTickId) return LUA_NOREF;
+
+	const int ref = cb->ref;
+	lua_scheduler_remove(id);
+	return ref;
+}
+
+/*
+ * handlers added by a script go with its Lua state; onTick stays, as the function is looked up by name.
+ * Scripts written before budgets existed may run onTick for as long as they like.
+ */
+static void initScheduler(){
+	lua_scheduler_init();
+	g_onTickId = lua_scheduler_add(LUA_NOREF, onTickSleepInterval, LUA_BUDGET_NONE, getCurrentTicks());
+}
+
 int getShouldReloadScript(void){
 	return g_shouldReloadScript;
 }
@@ -127,9 +205,14 @@ void setShouldReloadScript(int reload){
 	g_shouldReloadScript = reload;
 }
 
+void requestStoreScriptBytecode(void){
+	g_storeBytecodeRequested = 1;
+}
+
 static void initLuaState(){
     lockLua();
     if (g_lua != NULL) lua_close(g_lua);
+    if (g_arenaMemory) lua_arena_reset(&g_arena);
     g_lua=lua_newstate( myAlloc, NULL);
     //open optional libraries
     luaopen_base(g_lua);
@@ -141,10 +224,41 @@ static void initLuaState(){
     unlockLua();
 }
 
+/*
+ * Takes the arena once every other task has made its startup allocations,
+ * keeping LUA_HEAP_RESERVE of whatever heap is left for later buffers.  The
+ * sample buffers are allocated on the logger's first tick, so wait for them.
+ */
+static void allocateArena(){
+	while (!areSampleBuffersAllocated()){
+		delayTicks(1);
+	}
+
+	const size_t freeHeap = portGetFreeHeapSize();
+	size_t size = freeHeap > LUA_HEAP_RESERVE ? freeHeap - LUA_HEAP_RESERVE : 0;
+	if (size > LUA_ARENA_SIZE) size = LUA_ARENA_SIZE;
+	size -= size % LUA_ARENA_ALIGN;
+
+	g_arenaMemory = size >= LUA_ARENA_MIN_SIZE ? portMalloc(size) : NULL;
+	if (g_arenaMemory){
+		lua_arena_init(&g_arena, g_arenaMemory, size);
+		pr_info("lua: arena ");
+		pr_info_int(size);
+		pr_info(" bytes of ");
+		pr_info_int(freeHeap);
+		pr_info(" free heap\r\n");
+	}
+	else{
+		pr_error("lua: no room for arena; using the heap\r\n");
+	}
+}
+
 void startLuaTask(int priority){
 	g_lua = NULL;
+	g_arenaMemory = NULL;
 	setShouldReloadScript(0);
-	set_ontick_freq(DEFAULT_ONTICK_HZ);
+	onTickSleepInterval = freqToTicks(DEFAULT_ONTICK_HZ);
+	initScheduler();
 
 	vSemaphoreCreateBinary(xLuaLock);
 
@@ -156,6 +270,60 @@ void startLuaTask(int priority){
 					NULL);
 }
 
+static int countWriter(lua_State *L, const void *p, size_t size, void *ud){
+	*(size_t *)ud += size;
+	return 0;
+}
+
+static int copyWriter(lua_State *L, const void *p, size_t size, void *ud){
+	unsigned char **pos = (unsigned char **)ud;
+	memcpy(*pos, p, size);
+	*pos += size;
+	return 0;
+}
+
+/* compiles the script and flashes the result, so the next start can skip compiling it */
+static void storeBytecode(void){
+	ScriptBytecode *bytecode = NULL;
+
+	lockLua();
+	const char *script = getScript();
+	if (luaL_loadbuffer(g_lua, script, strlen(script), "startup") == 0){
+		size_t length = 0;
+		lua_dump(g_lua, countWriter, &length);
+		bytecode = create_script_bytecode(length);
+		if (bytecode != NULL){
+			unsigned char *pos = bytecode->code;
+			lua_dump(g_lua, copyWriter, &pos);
+		}
+	}
+	lua_pop(g_lua, 1);
+	unlockLua();
+
+	if (bytecode == NULL){
+		pr_warning("script bytecode not stored\r\n");
+		return;
+	}
+	/* not under the Lua lock, so callers of lockLua are not held up by the flash */
+	flash_script_bytecode(bytecode);
+}
+
+/* loads the stored bytecode if it is good for this script, else compiles the source */
+static int loadScript(const char *script, size_t len){
+	size_t codeLength;
+	const unsigned char *code = get_script_bytecode(&codeLength);
+	if (code != NULL){
+		if (luaL_loadbuffer(g_lua, (const char *)code, codeLength, "startup") == 0){
+			pr_info("from bytecode...");
+			return 0;
+		}
+		pr_warning("script bytecode rejected; compiling source\r\n");
+		lua_pop(g_lua, 1);
+	}
+
+	return luaL_loadbuffer(g_lua, script, len, "startup");
+}
+
 static void doScript(void){
     lockLua();
     const char *script = getScript();
@@ -166,7 +334,7 @@ static void doScript(void){
 
     lua_gc(g_lua, LUA_GCCOLLECT,0);
 
-    int result = (luaL_loadbuffer(g_lua, script, len, "startup") || lua_pcall(g_lua, 0, LUA_MULTRET, 0));
+    int result = (loadScript(script, len) || lua_pcall(g_lua, 0, LUA_MULTRET, 0));
     if (0 != result){
         pr_error("startup script error: (");
         pr_error(lua_tostring(g_lua,-1));
@@ -191,35 +359,110 @@ static void guardedDoScript(void){
 	}
 }
 
+/* stops a callback that runs past its deadline; the error unwinds to its lua_pcall */
+static void budgetHook(lua_State *L, lua_Debug *ar){
+	if ((int)(getCurrentTicks() - g_callbackDeadline) > 0){
+		luaL_error(L, "tick handler over budget");
+	}
+}
+
+/* runs one callback, holding the lock only for as long as it takes */
+static void runCallback(int id){
+	lockLua();
+	//the handler may have been removed while waiting for the lock
+	const LuaCallback *cb = lua_scheduler_get(id);
+	if (cb == NULL){
+		unlockLua();
+		return;
+	}
+
+	if (cb->ref == LUA_NOREF){
+		lua_getglobal(g_lua, LUA_PERIODIC_FUNCTION);
+	}
+	else{
+		lua_rawgeti(g_lua, LUA_REGISTRYINDEX, cb->ref);
+	}
+
+	if (lua_isnil(g_lua, -1)){
+		//handle missing function error
+		lua_pop(g_lua, 1);
+		lua_scheduler_postpone(id, getCurrentTicks());
+		unlockLua();
+		return;
+	}
+
+	const size_t start = getCurrentTicks();
+	const int budgeted = cb->budget != LUA_BUDGET_NONE;
+	if (budgeted){
+		g_callbackDeadline = start + cb->budget;
+		lua_sethook(g_lua, budgetHook, LUA_MASKCOUNT, BUDGET_CHECK_INSTRUCTIONS);
+	}
+	if (lua_pcall(g_lua, 0, 0, 0) != 0){
+		// TODO log or indicate error. store this in a "Last Error"
+		lua_pop(g_lua, 1);
+	}
+	if (budgeted){
+		lua_sethook(g_lua, NULL, 0, 0);
+	}
+	lua_scheduler_ran(id, start, getCurrentTicks());
+	unlockLua();
+}
+
+/*
+ * While steps run between handlers, the collector is stopped so that it does not
+ * also run inside them.  Without an arena to bound Lua memory it is left running.
+ */
+static void holdCollector(int hold){
+	hold = hold && g_arenaMemory && lua_gc(g_lua, LUA_GCCOUNT, 0) < GC_BACKSTOP_KB;
+	if (hold){
+		lua_gc(g_lua, LUA_GCSTOP, 0);
+	}
+	else if (g_collectorHeld){
+		lua_gc(g_lua, LUA_GCRESTART, 0);
+	}
+	g_collectorHeld = hold;
+}
+
+/* runs GC steps after a handler until the budget is spent, a cycle ends or another handler is due */
+static void collectGarbage(void){
+	const unsigned int budget = lua_scheduler_get_gc_stats()->stepBudget;
+	lockLua();
+	for (unsigned int i = 0; i < budget; i++){
+		const size_t start = getCurrentTicks();
+		if (lua_scheduler_ticks_until_due(start, 1) == 0) break;
+
+		const int cycleDone = lua_gc(g_lua, LUA_GCSTEP, 0);
+		lua_scheduler_gc_stepped(start, getCurrentTicks(), cycleDone);
+		if (cycleDone) break;
+	}
+	holdCollector(budget > 0);
+	unlockLua();
+}
+
 void luaTask(void *params){
+	allocateArena();
 	initLuaState();
 	guardedDoScript();
 	while(1){
-		portTickType xLastWakeTime;
-		xLastWakeTime = xTaskGetTickCount();
 		if (getShouldReloadScript()){
+			initScheduler();
+			g_collectorHeld = 0;
 			initLuaState();
 			doScript();
 			setShouldReloadScript(0);
 		}
-		lockLua();
- 		lua_getglobal(g_lua, LUA_PERIODIC_FUNCTION);
-    	if (! lua_isnil(g_lua,-1)){
-        	if (lua_pcall(g_lua, 0, 0, 0) != 0){
-// TODO log or indicate error. store this in a "Last Error"
-//        		SendString("Error calling ");
-//        		SendString(LUA_PERIODIC_FUNCTION);
-//        		SendString("(): ");
-//        		SendString( lua_tostring(g_lua,-1));
-//        		SendCrlf();
-        		lua_pop(g_lua,1);
-        	}
-    	} else{
-	       // //handle missing function error
-	        lua_pop(g_lua,1);
-	    }
-    	unlockLua();
-		vTaskDelayUntil( &xLastWakeTime, onTickSleepInterval );
+		if (g_storeBytecodeRequested && !isLogging()){
+			g_storeBytecodeRequested = 0;
+			storeBytecode();
+		}
+		const size_t now = getCurrentTicks();
+		const int id = lua_scheduler_next_due(now);
+		if (id < 0){
+			delayTicks(lua_scheduler_ticks_until_due(now, msToTicks(MAX_IDLE_MS)));
+			continue;
+		}
+		runCallback(id);
+		collectGarbage();
 	}
 }
 
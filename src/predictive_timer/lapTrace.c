@@ -0,0 +1,158 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lapTrace.h"
+#include "mod_string.h"
+
+#include <math.h>
+
+static int32_t toUnits(const float meters) {
+   return (int32_t) floorf(meters * LAP_TRACE_UNITS_PER_METER + 0.5f);
+}
+
+static int32_t stepsFor(const int32_t delta, const int32_t maxStep) {
+   const int32_t magnitude = delta < 0 ? -delta : delta;
+   return (magnitude + maxStep - 1) / maxStep;
+}
+
+void lap_trace_init(LapTrace *trace, LapTraceSample *samples, size_t capacity,
+                    const GeoPoint *origin) {
+   trace->samples = samples;
+   trace->capacity = capacity;
+   trace->count = 1;
+   trace->projection = createGeoProjection(origin);
+   trace->x = 0;
+   trace->y = 0;
+   trace->time = 0;
+
+   samples[0].dx = 0;
+   samples[0].dy = 0;
+   samples[0].dt = 0;
+}
+
+void lap_trace_load(LapTrace *trace, LapTraceSample *samples, size_t capacity,
+                    const GeoPoint *origin, const LapTraceSample *source, size_t count) {
+   lap_trace_init(trace, samples, capacity, origin);
+   memcpy(samples, source, count * sizeof(LapTraceSample));
+   trace->count = count;
+
+   // Sum the deltas so the end of the trace is known for appends.
+   LapTraceCursor cursor;
+   lap_trace_first(trace, &cursor);
+   while (lap_trace_next(trace, &cursor));
+   trace->x = cursor.x;
+   trace->y = cursor.y;
+   trace->time = cursor.time;
+}
+
+bool lap_trace_append(LapTrace *trace, const GeoPoint *point, tiny_millis_t time) {
+   float px, py;
+   lap_trace_project(trace, point, &px, &py);
+
+   const int32_t dx = toUnits(px) - trace->x;
+   const int32_t dy = toUnits(py) - trace->y;
+   const int32_t dt = time > trace->time ? time - trace->time : 0;
+
+   int32_t steps = 1;
+   if (stepsFor(dx, LAP_TRACE_MAX_STEP) > steps)
+      steps = stepsFor(dx, LAP_TRACE_MAX_STEP);
+   if (stepsFor(dy, LAP_TRACE_MAX_STEP) > steps)
+      steps = stepsFor(dy, LAP_TRACE_MAX_STEP);
+   if (stepsFor(dt, LAP_TRACE_MAX_TIME_STEP) > steps)
+      steps = stepsFor(dt, LAP_TRACE_MAX_TIME_STEP);
+
+   if (trace->count + steps > trace->capacity)
+      return false;
+
+   // Split evenly along the way; each part fits as the whole is at most steps times the limit.
+   const int32_t x = trace->x;
+   const int32_t y = trace->y;
+   const tiny_millis_t t = trace->time;
+   for (int32_t i = 1; i <= steps; ++i) {
+      LapTraceSample *sample = trace->samples + trace->count++;
+      const int32_t nx = x + (int32_t) ((int64_t) dx * i / steps);
+      const int32_t ny = y + (int32_t) ((int64_t) dy * i / steps);
+      const tiny_millis_t nt = t + (tiny_millis_t) ((int64_t) dt * i / steps);
+
+      sample->dx = (int8_t) (nx - trace->x);
+      sample->dy = (int8_t) (ny - trace->y);
+      sample->dt = (uint16_t) (nt - trace->time);
+      trace->x = nx;
+      trace->y = ny;
+      trace->time = nt;
+   }
+
+   return true;
+}
+
+void lap_trace_drop_last(LapTrace *trace) {
+   if (trace->count <= 1)
+      return;
+
+   const LapTraceSample *sample = trace->samples + --trace->count;
+   trace->x -= sample->dx;
+   trace->y -= sample->dy;
+   trace->time -= sample->dt;
+}
+
+void lap_trace_project(const LapTrace *trace, const GeoPoint *point, float *x, float *y) {
+   projectGeoPoint(&trace->projection, point, x, y);
+}
+
+float lap_trace_dist_squared_to_last(const LapTrace *trace, const GeoPoint *point) {
+   float px, py;
+   lap_trace_project(trace, point, &px, &py);
+
+   const float dx = px - (float) trace->x / LAP_TRACE_UNITS_PER_METER;
+   const float dy = py - (float) trace->y / LAP_TRACE_UNITS_PER_METER;
+   return dx * dx + dy * dy;
+}
+
+void lap_trace_first(const LapTrace *trace, LapTraceCursor *cursor) {
+   cursor->index = 0;
+   cursor->x = trace->samples[0].dx;
+   cursor->y = trace->samples[0].dy;
+   cursor->time = trace->samples[0].dt;
+}
+
+bool lap_trace_next(const LapTrace *trace, LapTraceCursor *cursor) {
+   if (cursor->index + 1 >= trace->count)
+      return false;
+
+   const LapTraceSample *sample = trace->samples + ++cursor->index;
+   cursor->x += sample->dx;
+   cursor->y += sample->dy;
+   cursor->time += sample->dt;
+   return true;
+}
+
+bool lap_trace_prev(const LapTrace *trace, LapTraceCursor *cursor) {
+   if (cursor->index == 0 || cursor->index >= trace->count)
+      return false;
+
+   const LapTraceSample *sample = trace->samples + cursor->index--;
+   cursor->x -= sample->dx;
+   cursor->y -= sample->dy;
+   cursor->time -= sample->dt;
+   return true;
+}
+
+void lap_trace_position(const LapTraceCursor *cursor, float *x, float *y) {
+   *x = (float) cursor->x / LAP_TRACE_UNITS_PER_METER;
+   *y = (float) cursor->y / LAP_TRACE_UNITS_PER_METER;
+}
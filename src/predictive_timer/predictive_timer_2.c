@@ -5,12 +5,21 @@
  *      Author: stieg
  */
 
+#include "capabilities.h"
 #include "dateTime.h"
 #include "debug.h"
 #include "geopoint.h"
 #include "gps.h"
+#include "lapTrace.h"
+#include "mem_mang.h"
 #include "mod_string.h"
 #include "predictive_timer_2.h"
+#include "printk.h"
+#include "referenceLap.h"
+
+#include <stddef.h>
+
+#include <math.h>
 
 /**
  * These settings control critical values that will affect performance.  Understand these values
@@ -18,15 +27,22 @@
  * in milliseconds.
  */
 /**
- * # of slots per buffer.  Each slot is 12 bytes.
+ * # of samples per lap trace.  Each sample is 4 bytes and there are two traces.  Set per platform
+ * in capabilities.h.
+ */
+#define MAX_TIMELOC_SAMPLES PREDICTIVE_TIMER_SAMPLES
+
+/**
+ * How far apart in meters to initially take samples.  Too small and we overflow on a long track.
+ * Too large and the split is coarse until the next lap.
  */
-#define MAX_TIMELOC_SAMPLES 96
+#define INITIAL_SAMPLE_DISTANCE 10.0f
 
 /**
- * How frequently to initially take in GPS data.  To small and we overflow.  To large and we don't
- * update very frequently.
+ * The closest we ever take samples, in meters.  Much finer than the accuracy of a GPS fix only
+ * records noise.
  */
-#define INITIAL_POLL_INTERVAL 5000
+#define MIN_SAMPLE_DISTANCE 2.0f
 
 /**
  * The absolute minimum predicted time.  This fixes issues related to predictive timing around the
@@ -34,39 +50,48 @@
  */
 #define MIN_PREDICTED_TIME 10000
 
-// A smaller TimeLoc value for space savings
-struct PtTimeLoc {
-   GeoPoint point;
-   tiny_millis_t time;
-};
-
-static struct PtTimeLoc buff1[MAX_TIMELOC_SAMPLES];
-static struct PtTimeLoc buff2[MAX_TIMELOC_SAMPLES];
-
-// Our pointers that maintain the fast lap and current lap buffers.
-static struct PtTimeLoc *currLap = buff1;
-static struct PtTimeLoc *fastLap = buff2;
+/**
+ * A closest point found by walking the fast lap is trusted if it is within this many meters, or
+ * within the length of its neighbouring segments if those are longer.  Otherwise the walk is
+ * assumed to have lost track and the whole fast lap is searched.
+ */
+#define MIN_WALK_REACH 25.0f
 
-// Index to track current slot in buffer
-static int buffIndex;
+static LapTraceSample buff1[MAX_TIMELOC_SAMPLES];
+static LapTraceSample buff2[MAX_TIMELOC_SAMPLES];
+static LapTrace traces[2];
 
-// Index to track high slot in fastLapTimer.  Its points to the next open slot there.
-static int fastLapIndex;
+// Our pointers that maintain the fast lap and current lap traces.
+static LapTrace *currLap = traces;
+static LapTrace *fastLap = traces + 1;
 
 // Time of the fast lap.
 static tiny_millis_t fastLapTime;
 
+// False when there is a fast lap set since the reference lap was last saved or loaded.
+static bool fastLapSaved = true;
+
+// The last closest point found in the fast lap.  Where the next search starts.
+static LapTraceCursor lastClosest;
+
 // Time current lap started.
 static tiny_millis_t currLapStartTime;
 
+// Distance in meters covered so far this lap, and where the last GPS fix was.
+static float currLapDistance;
+static GeoPoint lastFixPoint;
+
 // Holds the lastPredictedTime.  Used for when we don't have good data to give yet.
 static tiny_millis_t lastPredictedTime;
 
+// The fix time lastPredictedTime was worked out for.
+static tiny_millis_t lastPredictionFixTime = -1;
+
 // Holds the last predicted Delta.  Used like lastPredictedTime.
 static tiny_millis_t lastPredictedDelta;
 
-// Interval between polls in milliseconds.
-static tiny_millis_t pollInterval = INITIAL_POLL_INTERVAL;
+// Distance between samples in meters.
+static float sampleDistance = INITIAL_SAMPLE_DISTANCE;
 
 // Indicates the current status of the recording code.  DISABLED until we start the first lap.
 static enum Status {
@@ -82,20 +107,19 @@ static tiny_millis_t getCurrentLapTime(tiny_millis_t time) {
 	return time - currLapStartTime;
 }
 
+static LapTraceSample * getTraceBuffer(const LapTrace *trace) {
+	return trace == traces ? buff1 : buff2;
+}
+
 /**
- * Creates a timeLoc sample and places it in the currBuff.  Increments counter as needed.
+ * Adds a timeLoc sample to the end of the current lap trace.
  * @return true if the insert succeeded, false otherwise.
  */
 static bool insertTimeLocSample(GeoPoint point, tiny_millis_t time) {
-	if (buffIndex >= MAX_TIMELOC_SAMPLES)
-		return false;
-
-	struct PtTimeLoc *timeLoc = currLap + buffIndex;
-	timeLoc->point = point;
-	timeLoc->time = getCurrentLapTime(time);
-
-	if (++buffIndex >= MAX_TIMELOC_SAMPLES)
+	if (!lap_trace_append(currLap, &point, getCurrentLapTime(time))) {
 		DEBUG("Buffer now Full!\n");
+		return false;
+	}
 
 	return true;
 }
@@ -107,41 +131,52 @@ static bool insertTimeLocSample(GeoPoint point, tiny_millis_t time) {
 static void setNewFastLap(tiny_millis_t lapTime) {
 	DEBUG("Setting new fast lap time to %f\n", lapTime);
 	fastLapTime = lapTime;
+	fastLapSaved = false;
 
-	// Swap out our buffers.
-	fastLapIndex = buffIndex;
+	// Swap out our traces.
+	LapTrace *tmp = fastLap;
 	fastLap = currLap;
-	currLap = currLap == buff1 ? buff2 : buff1;
+	currLap = tmp;
 }
 
 bool isPredictiveTimeAvailable() {
-	return fastLapIndex != 0;
+	return fastLap->count != 0;
 }
 
 /**
- * Adjusts the poll interval so that we can effectively use our buffer.  The more full it
- * gets the better timing accuracy we can give.
+ * Adjusts the distance between samples so that we can effectively use our buffer.  The more full
+ * it gets the better timing accuracy we can give.
+ * @param samples The number of samples the lap used.
  */
-static tiny_millis_t adjustPollInterval(tiny_millis_t lapTime) {
+static float adjustSampleDistance(size_t samples) {
 	// If no hotLap is set there no data to work with.
 	if (!isPredictiveTimeAvailable())
-		return pollInterval;
+		return sampleDistance;
 
 	// Target 90% buffer use +- 10%.
 	const float slots = (float) MAX_TIMELOC_SAMPLES;
-	const float percentUsed = ((float) buffIndex) / slots;
-	DEBUG("Recorded %d samples.  Targeting ~ %f samples.\n", buffIndex, slots * 0.9);
+	const float percentUsed = ((float) samples) / slots;
+	DEBUG("Recorded %d samples.  Targeting ~ %f samples.\n", samples, slots * 0.9);
 
 	if (percentUsed > 0.8 && status != FULL) {
-		DEBUG("Within target range.  Not adjusting sample rate.\n");
-		return pollInterval;
+		DEBUG("Within target range.  Not adjusting sample distance.\n");
+		return sampleDistance;
 	}
 
-   // Careful here of gotchas with tiny_millis_t and floats.
-	pollInterval = lapTime / (slots / 0.9);
-	DEBUG("Setting poll interval to %ull\n", pollInterval);
+	sampleDistance = currLapDistance / (slots * 0.9f);
+	if (sampleDistance < MIN_SAMPLE_DISTANCE)
+		sampleDistance = MIN_SAMPLE_DISTANCE;
+	DEBUG("Setting sample distance to %f\n", sampleDistance);
 
-	return pollInterval;
+	return sampleDistance;
+}
+
+/**
+ * Adds the distance from the last GPS fix to point to the distance covered this lap.
+ */
+static void updateLapDistance(GeoPoint point) {
+	currLapDistance += sqrtf(distSquaredProjected(&currLap->projection, &lastFixPoint, &point));
+	lastFixPoint = point;
 }
 
 /**
@@ -151,11 +186,11 @@ static tiny_millis_t adjustPollInterval(tiny_millis_t lapTime) {
  * @param time Duh!
  */
 static void finishLap(GeoPoint point, tiny_millis_t time) {
-	// Drop last entry if necessary to record end of lap.
-	if (buffIndex >= MAX_TIMELOC_SAMPLES)
-		buffIndex = MAX_TIMELOC_SAMPLES - 1;
+	updateLapDistance(point);
 
-	insertTimeLocSample(point, time);
+	// Drop last entries if necessary to record end of lap.
+	while (!insertTimeLocSample(point, time) && currLap->count > 1)
+		lap_trace_drop_last(currLap);
 }
 
 /**
@@ -165,20 +200,16 @@ static void startNewLap(GeoPoint point, tiny_millis_t time) {
 	currLapStartTime = time;
 	lastPredictedDelta = 0;
 	lastPredictedTime = 0;
-	buffIndex = 0;
+	currLapDistance = 0;
+	lastFixPoint = point;
 	status = RECORDING;
 
-	DEBUG("Starting new lap.  Status %d, buffIndex = %d, startTime = %ull\n",
-			status, buffIndex, time);
-	insertTimeLocSample(point, time);
-}
+	// The start of the lap is the first sample.
+	lap_trace_init(currLap, getTraceBuffer(currLap), MAX_TIMELOC_SAMPLES, &point);
+	if (isPredictiveTimeAvailable())
+		lap_trace_first(fastLap, &lastClosest);
 
-/**
- * @param time The time the sample was taken
- * @return The difference in seconds between our most recent sample a this new one.
- */
-static tiny_millis_t getTimeSinceLastSample(tiny_millis_t time) {
-	return time - currLapStartTime - currLap[buffIndex - 1].time;
+	DEBUG("Starting new lap.  Status %d, startTime = %ull\n", status, time);
 }
 
 /**
@@ -189,16 +220,18 @@ static tiny_millis_t getTimeSinceLastSample(tiny_millis_t time) {
  */
 void startFinishCrossed(GeoPoint point, tiny_millis_t time) {
 	INFO("Start/Finish Crossed.\n");
-	finishLap(point, time);
 
 	if (status != DISABLED) {
+		finishLap(point, time);
+
 		tiny_millis_t lapTime = getCurrentLapTime(time);
 		INFO("Last lap time was %f seconds\n", lapTime);
 
+		const size_t samples = currLap->count;
 		if (fastLapTime <= 0.0 || lapTime <= fastLapTime)
 			setNewFastLap(lapTime);
 
-		adjustPollInterval(lapTime);
+		adjustSampleDistance(samples);
 	}
 
 	startNewLap(point, time);
@@ -214,14 +247,22 @@ void startFinishCrossed(GeoPoint point, tiny_millis_t time) {
 bool addGpsSample(GeoPoint point, tiny_millis_t time) {
 	DEVEL("Add GPS Sample called\n");
 
+	if (status == DISABLED) {
+		DEVEL("DROPPING - State is %d\n", status);
+		return false;
+	}
+
+	// Keep measuring the lap once full, so the next lap can be sampled to fit.
+	updateLapDistance(point);
+
 	if (status != RECORDING) {
 		DEVEL("DROPPING - State is %d\n", status);
 		return false;
 	}
 
-	// Check if enough time has elapsed between sample periods.
-	if (getTimeSinceLastSample(time) < pollInterval) {
-		DEVEL("DROPPING - elapsed < pollInterval\n");
+	// Check if we have moved far enough since the last sample.
+	if (lap_trace_dist_squared_to_last(currLap, &point) < sampleDistance * sampleDistance) {
+		DEVEL("DROPPING - distance < sampleDistance\n");
 		return false;
 	}
 
@@ -241,76 +282,147 @@ bool addGpsSample(GeoPoint point, tiny_millis_t time) {
  * and e on the earth's surface.  If that requirement is met this method should return a value
  * between 0 and 1.  Otherwise the value will be undefined.
  * those bounds then
- * @param s The start point.
- * @param e The end point.
- * @param m The middle point.
+ * @param sx, sy The start point, projected.
+ * @param ex, ey The end point, projected.
+ * @param mx, my The middle point, projected.
  * @return The percentage that projected point m lies between startPt and endPt if the method
  * requirements were met. < 0 or > 1 otherwise.
  */
-float distPctBtwnTwoPoints(GeoPoint *s, GeoPoint *e, GeoPoint *m) {
-	float distSM = distPythag(s, m); // A
-	float distME = distPythag(m, e); // B
-	float distSE = distPythag(s, e); // C
-
-	// projDist = (A^2 + C^2 - B^2) / 2 * C
-	float projDistFromS = ((distSM * distSM) + (distSE * distSE)
-			- (distME * distME)) / (2 * distSE);
+static float pctBtwnTwoPositions(float sx, float sy, float ex, float ey, float mx, float my) {
+	// (SM . SE) / |SE|^2; the same projection as the law of cosines, without the square roots
+	const float seX = ex - sx;
+	const float seY = ey - sy;
+	const float distSESquared = seX * seX + seY * seY;
+
+	DEVEL("distSE^2 = %f\n", distSESquared);
+	return ((mx - sx) * seX + (my - sy) * seY) / distSESquared;
+}
 
-	DEVEL("distSE = %f, distSM = %f, distME = %f, projDist = %f\n", distSE,
-			distSM, distME, projDistFromS);
+float distPctBtwnTwoPoints(GeoPoint *s, GeoPoint *e, GeoPoint *m) {
+	const GeoProjection proj = createGeoProjection(s);
+	float sx, sy, ex, ey, mx, my;
+	projectGeoPoint(&proj, s, &sx, &sy);
+	projectGeoPoint(&proj, e, &ex, &ey);
+	projectGeoPoint(&proj, m, &mx, &my);
+	return pctBtwnTwoPositions(sx, sy, ex, ey, mx, my);
+}
 
-	return projDistFromS / distSE;
+static float cursorPctBtwnTwoPoints(const LapTraceCursor *s, const LapTraceCursor *e, float mx,
+		float my) {
+	float sx, sy, ex, ey;
+	lap_trace_position(s, &sx, &sy);
+	lap_trace_position(e, &ex, &ey);
+	return pctBtwnTwoPositions(sx, sy, ex, ey, mx, my);
 }
 
 static bool inBounds(float v) {
 	return v >= 0 && v <= 1;
 }
 
+static float distSquaredToCursor(const LapTraceCursor *cursor, float x, float y) {
+	float cx, cy;
+	lap_trace_position(cursor, &cx, &cy);
+	return (cx - x) * (cx - x) + (cy - y) * (cy - y);
+}
+
+static float distSquaredBtwnCursors(const LapTraceCursor *a, const LapTraceCursor *b) {
+	float bx, by;
+	lap_trace_position(b, &bx, &by);
+	return distSquaredToCursor(a, bx, by);
+}
+
 /**
- * Finds the  closest point to the given point in the fastLap buffer.  Orders the output buffer
- * such that the lower time is always first.
- * @param currPoint The current point of measurement.
- * @return The index of the closest point in the fastLap buffer to the current point, or -1 if
- * no closest point is available.
+ * Finds the closest point to the given position by checking every point in the fast lap.
+ * @param x, y The current position in the projection of the fast lap.
+ * @param closest Where the closest point goes.
  */
-static int findClosestPt(GeoPoint *currPoint) {
-	if (!isPredictiveTimeAvailable())
-		return -1;
+static void scanForClosestPt(float x, float y, LapTraceCursor *closest) {
+	// First find the closest point.  Start with the first point as your best.
+	LapTraceCursor cursor;
+	lap_trace_first(fastLap, &cursor);
+	*closest = cursor;
+	float lowestDistance = distSquaredToCursor(&cursor, x, y);
 
-	// First find the closest point.  Start with index 0 as your best.
-	int bestIndex = 0;
-	GeoPoint *fastLapPoint = &(fastLap[bestIndex].point);
-	float lowestDistance = distPythag(currPoint, fastLapPoint);
-
-	for (int i = 1; i < fastLapIndex; ++i) {
-		fastLapPoint = &(fastLap[i].point);
-		float distance = distPythag(currPoint, fastLapPoint);
+	while (lap_trace_next(fastLap, &cursor)) {
+		const float distance = distSquaredToCursor(&cursor, x, y);
 
 		if (distance < lowestDistance) {
 			lowestDistance = distance;
-			bestIndex = i;
+			*closest = cursor;
 		}
 	}
 
-	DEVEL("Smallest distance is %f from point %d\n", lowestDistance, bestIndex);
-	return bestIndex;
+	DEVEL("Smallest squared distance is %f from point %d\n", lowestDistance, closest->index);
+}
+
+/**
+ * Finds the  closest point to the given position in the fast lap.  We move along the track in
+ * the same order as the fast lap was recorded, so the search walks from the last closest point
+ * to the nearest local minimum; usually a step or two.  Only when that minimum is too far away to
+ * be on the fast lap line do we fall back to checking every point.
+ * @param x, y The current position in the projection of the fast lap.
+ * @param closest Where the closest point goes.
+ * @return true if a closest point is available, false otherwise.
+ */
+static bool findClosestPt(float x, float y, LapTraceCursor *closest) {
+	if (!isPredictiveTimeAvailable())
+		return false;
+
+	LapTraceCursor best = lastClosest;
+	float lowestDistance = distSquaredToCursor(&best, x, y);
+	bool movedForward = false;
+
+	LapTraceCursor cursor = best;
+	while (lap_trace_next(fastLap, &cursor)) {
+		const float distance = distSquaredToCursor(&cursor, x, y);
+		if (distance >= lowestDistance)
+			break;
+		lowestDistance = distance;
+		best = cursor;
+		movedForward = true;
+	}
+
+	// Only walk back if we did not move forward; mostly after the start of a lap or a spin.
+	cursor = best;
+	while (!movedForward && lap_trace_prev(fastLap, &cursor)) {
+		const float distance = distSquaredToCursor(&cursor, x, y);
+		if (distance >= lowestDistance)
+			break;
+		lowestDistance = distance;
+		best = cursor;
+	}
+
+	// A point on the fast lap line is never much further from its closest point than a segment.
+	float reach = MIN_WALK_REACH * MIN_WALK_REACH;
+	cursor = best;
+	if (lap_trace_prev(fastLap, &cursor) && distSquaredBtwnCursors(&best, &cursor) > reach)
+		reach = distSquaredBtwnCursors(&best, &cursor);
+	cursor = best;
+	if (lap_trace_next(fastLap, &cursor) && distSquaredBtwnCursors(&best, &cursor) > reach)
+		reach = distSquaredBtwnCursors(&best, &cursor);
+
+	if (lowestDistance > reach) {
+		DEBUG("Closest point %d is %f m^2 away.  Searching the whole lap\n", best.index,
+				lowestDistance);
+		scanForClosestPt(x, y, &best);
+	}
+
+	*closest = lastClosest = best;
+	return true;
 }
 
 /**
- * Finds the two points closest to the given point in the fastLap buffer.  Orders the output buffer
+ * Finds the two points closest to the given position in the fast lap.  Orders the output buffer
  * such that the lower time is always first.
- * @param currPoint The current point of measurement.
+ * @param x, y The current position in the projection of the fast lap.
  * @param tlPts Output buffer where the two closest points will go.  Lower time point first.
  * Undefined values if method returns false.
- * @return true if a fast lap is set and the points are next to each other in the fastLap buffer
+ * @return true if a fast lap is set and the points are next to each other in the fast lap
  * and the given point is between the two points, false otherwise.
  */
-static bool findTwoClosestPts(GeoPoint *currPoint, struct PtTimeLoc *tlPts[]) {
-	if (!isPredictiveTimeAvailable())
-		return false;
-
-	int bestIndex = findClosestPt(currPoint);
-	if (bestIndex < 0)
+static bool findTwoClosestPts(float x, float y, LapTraceCursor tlPts[]) {
+	LapTraceCursor best;
+	if (!findClosestPt(x, y, &best))
 		return false;
 
 	/*
@@ -319,16 +431,11 @@ static bool findTwoClosestPts(GeoPoint *currPoint, struct PtTimeLoc *tlPts[]) {
 	 * know.  So how do we find this point?  Use our distPctBtwnTwoPoints method.  Values between
 	 * 0 - 1 indicate a point between the two points.
 	 */
-	GeoPoint *gpBest = &(fastLap[bestIndex].point);
-
-	int upIdx = bestIndex + 1;
-	int dnIdx = bestIndex - 1;
-
-	GeoPoint *gpUp = upIdx >= fastLapIndex ? NULL : &(fastLap[upIdx].point);
-	GeoPoint *gpDn = dnIdx < 0 ? NULL : &(fastLap[dnIdx].point);
+	LapTraceCursor up = best;
+	LapTraceCursor dn = best;
 
-	float distUp = gpUp == NULL ? -1 : distPctBtwnTwoPoints(gpBest, gpUp, currPoint);
-	float distDn = gpDn == NULL ? -1 : distPctBtwnTwoPoints(gpBest, gpDn, currPoint);
+	float distUp = !lap_trace_next(fastLap, &up) ? -1 : cursorPctBtwnTwoPoints(&best, &up, x, y);
+	float distDn = !lap_trace_prev(fastLap, &dn) ? -1 : cursorPctBtwnTwoPoints(&best, &dn, x, y);
 
 	if (!inBounds(distUp) && !inBounds(distDn)) {
 		DEBUG("Both points not in bounds (up: %f, dn: %f).  Close to Start/Finish?\n",
@@ -336,18 +443,9 @@ static bool findTwoClosestPts(GeoPoint *currPoint, struct PtTimeLoc *tlPts[]) {
 		return false;
 	}
 
-	int secondaryIndex = inBounds(distUp) ? upIdx : dnIdx;
-
-	tlPts[0] = &(fastLap[bestIndex]);
-	tlPts[1] = &(fastLap[secondaryIndex]);
-
-	// Swap the buffers so the lower time is always first.  Just use
-	if (tlPts[1]->time < tlPts[0]->time) {
-		DEVEL("Swapping buffers: %f < %f\n", tlPts[1]->time, tlPts[0]->time);
-		struct PtTimeLoc *tmp = tlPts[0];
-		tlPts[0] = tlPts[1];
-		tlPts[1] = tmp;
-	}
+	// Trace points are in time order, so the lower time is always first.
+	tlPts[0] = inBounds(distUp) ? best : dn;
+	tlPts[1] = inBounds(distUp) ? up : best;
 
 	return true;
 }
@@ -365,18 +463,23 @@ tiny_millis_t getSplitAgainstFastLap(GeoPoint point, tiny_millis_t currentTime)
 		return lastPredictedDelta;
 	}
 
+	// A reference lap may be loaded before this lap has started.
+	if (status == DISABLED)
+		return lastPredictedDelta;
+
+	float x, y;
+	lap_trace_project(fastLap, &point, &x, &y);
+
 	/*
 	 * Figure out the two closest points.  Order of closestPts is with lower time first.  If this
 	 * fails then we can't continue.
 	 */
-	struct PtTimeLoc *closestPts[2];
-	if (!findTwoClosestPts(&point, closestPts))
+	LapTraceCursor closestPts[2];
+	if (!findTwoClosestPts(x, y, closestPts))
 		// TODO: Perhaps return false here?  Make this better for the caller.
 		return lastPredictedDelta;
 
-	GeoPoint *pointA = &(closestPts[0]->point);
-	GeoPoint *pointB = &(closestPts[1]->point);
-	float percentage = distPctBtwnTwoPoints(pointA, pointB, &point);
+	float percentage = cursorPctBtwnTwoPoints(closestPts, closestPts + 1, x, y);
 	DEVEL("Percentage value is 0 < %f < 1\n", percentage);
 
 	if (!inBounds(percentage)) {
@@ -384,8 +487,8 @@ tiny_millis_t getSplitAgainstFastLap(GeoPoint point, tiny_millis_t currentTime)
 		return lastPredictedDelta;
 	}
 
-	const tiny_millis_t timeDeltaBtwnPoints = closestPts[1]->time - closestPts[0]->time;
-	const tiny_millis_t estFastTime = closestPts[0]->time + timeDeltaBtwnPoints  * percentage;
+	const tiny_millis_t timeDeltaBtwnPoints = closestPts[1].time - closestPts[0].time;
+	const tiny_millis_t estFastTime = closestPts[0].time + timeDeltaBtwnPoints  * percentage;
 	DEBUG("Estimated fast lap time at this point is %f\n", estFastTime);
 
 	lastPredictedDelta = estFastTime - getCurrentLapTime(currentTime);
@@ -403,6 +506,9 @@ tiny_millis_t getSplitAgainstFastLap(GeoPoint point, tiny_millis_t currentTime)
  * @return The predicted lap time.
  */
 tiny_millis_t getPredictedTime(GeoPoint point, tiny_millis_t time) {
+	if (time == lastPredictionFixTime)
+		return lastPredictedTime;
+	lastPredictionFixTime = time;
 
 	tiny_millis_t timeDelta = getSplitAgainstFastLap(point, time);
 	tiny_millis_t newPredictedTime = fastLapTime - timeDelta;
@@ -420,13 +526,63 @@ tiny_millis_t getPredictedTime(GeoPoint point, tiny_millis_t time) {
 void resetPredictiveTimer() {
 	DEBUG("Resetting predictive timer\n");
 	status = DISABLED;
-	buffIndex = 0;
-	fastLapIndex = 0;
+	currLap->count = 0;
+	fastLap->count = 0;
 	fastLapTime = 0;
 	lastPredictedTime = 0;
+	lastPredictionFixTime = -1;
 	lastPredictedDelta = 0;
 	currLapStartTime = 0;
-	pollInterval = INITIAL_POLL_INTERVAL;
+	sampleDistance = INITIAL_SAMPLE_DISTANCE;
+	fastLapSaved = true;
+}
+
+bool loadFastLap(const Track *track) {
+	const ReferenceLap *lap = find_reference_lap(track);
+	if (lap == NULL)
+		return false;
+
+	lap_trace_load(fastLap, getTraceBuffer(fastLap), MAX_TIMELOC_SAMPLES, &lap->origin,
+			lap->samples, lap->count);
+	fastLapTime = lap->lapTime;
+	sampleDistance = lap->sampleDistance;
+	fastLapSaved = true;
+
+	DEBUG("Loaded reference lap of %d samples, time %d\n", lap->count, fastLapTime);
+	return true;
+}
+
+int saveFastLap(const Track *track) {
+	if (!isPredictiveTimeAvailable())
+		return -1;
+
+	// Tried once per fast lap, so a failing flash is not retried on every fix.
+	fastLapSaved = true;
+
+	// Only the samples in use are flashed.
+	const size_t size = offsetof(ReferenceLap, samples) + fastLap->count * sizeof(LapTraceSample);
+	ReferenceLap *lap = (ReferenceLap *) portMalloc(size);
+	if (lap == NULL) {
+		pr_error("could not allocate buffer for reference lap\r\n");
+		return -1;
+	}
+
+	lap->magicInit = MAGIC_NUMBER_REFERENCE_LAP_INIT;
+	lap->version = REFERENCE_LAP_FORMAT_VERSION;
+	memcpy(&lap->track, track, sizeof(Track));
+	lap->lapTime = fastLapTime;
+	lap->sampleDistance = sampleDistance;
+	lap->origin = fastLap->projection.origin;
+	lap->count = fastLap->count;
+	memcpy(lap->samples, fastLap->samples, fastLap->count * sizeof(LapTraceSample));
+
+	const int result = flash_reference_lap(lap, size);
+	portFree(lap);
+	return result;
+}
+
+bool isFastLapSaved() {
+	return fastLapSaved;
 }
 
 float getPredictedTimeInMinutes() {
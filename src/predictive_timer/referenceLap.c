@@ -0,0 +1,67 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "referenceLap.h"
+#include "memory.h"
+#include "mod_string.h"
+#include "printk.h"
+#include "watchdog.h"
+
+/* fails to compile if the reference lap outgrows its flash region */
+typedef char reference_lap_fits_flash[sizeof(ReferenceLap) <= REFERENCE_LAP_FLASH_SIZE ? 1 : -1];
+
+#ifndef RCP_TESTING
+static const volatile ReferenceLap g_referenceLap __attribute__((section(".reflap\n\t#")));
+#else
+static ReferenceLap g_referenceLap;
+#endif
+
+const ReferenceLap * get_reference_lap() {
+   return (const ReferenceLap *) &g_referenceLap;
+}
+
+int flash_reference_lap(const ReferenceLap *source, size_t rawSize) {
+   pr_info("flashing reference lap...");
+   /* give the sector erase the whole watchdog period */
+   watchdog_reset();
+   int result = memory_flash_region((void *) &g_referenceLap, (void *) source, rawSize);
+   if (result == 0) pr_info("success\r\n"); else pr_info("failed\r\n");
+   return result;
+}
+
+static int areTracksEqual(const Track *a, const Track *b) {
+   if (a->track_type != b->track_type)
+      return 0;
+
+   for (size_t i = 0; i < SECTOR_COUNT; ++i)
+      if (!areGeoPointsEqual(a->allSectors[i], b->allSectors[i]))
+         return 0;
+
+   return 1;
+}
+
+const ReferenceLap * find_reference_lap(const Track *track) {
+   const ReferenceLap *lap = get_reference_lap();
+
+   if (lap->magicInit != MAGIC_NUMBER_REFERENCE_LAP_INIT ||
+       lap->version != REFERENCE_LAP_FORMAT_VERSION ||
+       lap->count == 0 || lap->count > PREDICTIVE_TIMER_SAMPLES)
+      return NULL;
+
+   return areTracksEqual(&lap->track, track) ? lap : NULL;
+}
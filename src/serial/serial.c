@@ -260,11 +260,7 @@ void put_nameEscapedString(Serial *serial, const char *s, const char *v, int len
 
 
 void put_bytes(Serial *serial, char *data, unsigned int length){
-	while (length > 0){
-    	serial->put_c(*data);
-    	data++;
-    	length--;
-	}
+	serial->put_buf(data, length);
 }
 
 void put_crlf(const Serial *serial){
@@ -0,0 +1,134 @@
+/**
+ * Race Capture Pro Firmware
+ *
+ * Copyright (C) 2014 Autosport Labs
+ *
+ * This file is part of the Race Capture Pro fimrware suite
+ *
+ * This is free software: you can redistribute it and/or modify it under the terms of the
+ * GNU General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This software is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * See the GNU General Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this code. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trackIndex.h"
+
+#include <math.h>
+
+#define METERS_PER_CELL (TRACK_INDEX_CELL_DEGREES * GP_METERS_PER_DEGREE)
+
+static int latitudeCell(const float latitude) {
+   const int cell = (int) ((latitude + 90) / TRACK_INDEX_CELL_DEGREES);
+   return cell < 0 ? 0 : cell >= TRACK_INDEX_LAT_CELLS ? TRACK_INDEX_LAT_CELLS - 1 : cell;
+}
+
+static int longitudeCell(const float longitude) {
+   const int cell = (int) ((longitude + 180) / TRACK_INDEX_CELL_DEGREES);
+   return cell < 0 ? 0 : cell >= TRACK_INDEX_LON_CELLS ? TRACK_INDEX_LON_CELLS - 1 : cell;
+}
+
+static uint32_t cellKey(const int latCell, const int lonCell) {
+   return (uint32_t) latCell * TRACK_INDEX_LON_CELLS + lonCell;
+}
+
+static int isEntryBefore(const TrackIndexEntry *a, const TrackIndexEntry *b) {
+   return a->cell < b->cell || (a->cell == b->cell && a->track < b->track);
+}
+
+void track_index_build(TrackIndex *index, const Track *tracks, size_t count,
+                       TrackIndexEntry *entries) {
+   index->tracks = tracks;
+   index->entries = entries;
+   index->count = 0;
+
+   for (size_t i = 0; i < count; ++i) {
+      const GeoPoint start = getStartPoint(tracks + i);
+      if (!isValidPoint(&start))
+         continue;
+
+      TrackIndexEntry entry;
+      entry.cell = cellKey(latitudeCell(start.latitude), longitudeCell(start.longitude));
+      entry.track = (uint16_t) i;
+
+      // Insertion sort; the tracks are few and only change when flashed.
+      size_t j = index->count++;
+      for (; j > 0 && isEntryBefore(&entry, entries + j - 1); --j)
+         entries[j] = entries[j - 1];
+      entries[j] = entry;
+   }
+}
+
+static size_t lowerBound(const TrackIndex *index, const uint32_t cell) {
+   size_t low = 0;
+   size_t high = index->count;
+   while (low < high) {
+      const size_t mid = (low + high) / 2;
+      if (index->entries[mid].cell < cell)
+         low = mid + 1;
+      else
+         high = mid;
+   }
+   return low;
+}
+
+struct ClosestTrack {
+   GeoProjection projection;
+   float distanceSquared;
+   int track;
+};
+
+static void searchCells(const TrackIndex *index, const GeoPoint *location,
+                        const uint32_t first, const uint32_t last,
+                        struct ClosestTrack *closest) {
+   for (size_t i = lowerBound(index, first); i < index->count; ++i) {
+      const TrackIndexEntry *entry = index->entries + i;
+      if (entry->cell > last)
+         break;
+
+      const GeoPoint start = getStartPoint(index->tracks + entry->track);
+      const float distance = distSquaredProjected(&closest->projection, &start, location);
+      if (distance < closest->distanceSquared ||
+          (distance == closest->distanceSquared && entry->track < closest->track)) {
+         closest->distanceSquared = distance;
+         closest->track = entry->track;
+      }
+   }
+}
+
+const Track* track_index_find_closest(const TrackIndex *index, const GeoPoint location,
+                                      const float maxDistance) {
+   struct ClosestTrack closest;
+   closest.projection = createGeoProjection(&location);
+   closest.distanceSquared = maxDistance * maxDistance;
+   closest.track = -1;
+
+   const int latSpan = (int) ceilf(maxDistance / METERS_PER_CELL);
+   const int latCell = latitudeCell(location.latitude);
+
+   /*
+    * Distances are measured in the projection around location, so the span
+    * of longitude is sized for the latitude of location itself.
+    */
+   const float lonCellMeters = TRACK_INDEX_CELL_DEGREES * closest.projection.metersPerDegreeLongitude;
+   const float lonSpanCells = lonCellMeters > 0 ? maxDistance / lonCellMeters : TRACK_INDEX_LON_CELLS;
+   const int lonSpan = lonSpanCells < TRACK_INDEX_LON_CELLS ? (int) ceilf(lonSpanCells) : TRACK_INDEX_LON_CELLS;
+   const int lonCell = longitudeCell(location.longitude);
+
+   for (int row = latCell - latSpan; row <= latCell + latSpan; ++row) {
+      if (row < 0 || row >= TRACK_INDEX_LAT_CELLS)
+         continue;
+
+      // No wrap at the antimeridian; the projection does not wrap either.
+      const int first = lonCell - lonSpan < 0 ? 0 : lonCell - lonSpan;
+      const int last = lonCell + lonSpan >= TRACK_INDEX_LON_CELLS ?
+         TRACK_INDEX_LON_CELLS - 1 : lonCell + lonSpan;
+      searchCells(index, &location, cellKey(row, first), cellKey(row, last), &closest);
+   }
+
+   return closest.track < 0 ? NULL : index->tracks + closest.track;
+}
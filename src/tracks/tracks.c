@@ -1,4 +1,5 @@
 #include "tracks.h"
+#include "trackIndex.h"
 #include "mod_string.h"
 #include "printk.h"
 #include "memory.h"
@@ -15,10 +16,21 @@ static const Tracks g_defaultTracks = DEFAULT_TRACKS;
 
 static Tracks *g_tracksBuffer = NULL;
 
+static TrackIndexEntry g_trackIndexEntries[MAX_TRACK_COUNT];
+static TrackIndex g_trackIndex;
+
+static void index_tracks(){
+	size_t count = g_tracks.count < MAX_TRACK_COUNT ? g_tracks.count : MAX_TRACK_COUNT;
+	track_index_build(&g_trackIndex, (const Track *)g_tracks.tracks, count, g_trackIndexEntries);
+}
+
 void initialize_tracks(){
 	if (g_tracks.magicInit != MAGIC_NUMBER_TRACKS_INIT){
 		flash_default_tracks();
 	}
+	else{
+		index_tracks();
+	}
 }
 
 int flash_default_tracks(void){
@@ -29,6 +41,7 @@ int flash_default_tracks(void){
 int flash_tracks(const Tracks *source, size_t rawSize){
 	int result = memory_flash_region((void *)&g_tracks, (void *)source, rawSize);
 	if (result == 0) pr_info("success\r\n"); else pr_info("failed\r\n");
+	index_tracks();
 	return result;
 }
 
@@ -36,6 +49,12 @@ const Tracks * get_tracks(){
 	return (Tracks *)&g_tracks;
 }
 
+const TrackIndex * get_track_index(){
+	//built on demand if the tracks were not initialized through here
+	if (g_trackIndex.tracks == NULL) index_tracks();
+	return &g_trackIndex;
+}
+
 
 int add_track(const Track *track, size_t index, int mode){
 	int result = TRACK_ADD_RESULT_OK;
@@ -28,6 +28,7 @@ void usb_init_serial(Serial *serial){
 	serial->get_line_wait = &usb_readLineWait;
 	serial->put_c = &usb_putchar;
 	serial->put_s = &usb_puts;
+	serial->put_buf = &usb_put_buf;
 }
 
 void startUSBCommTask(int priority){
@@ -95,3 +96,9 @@ void usb_puts(const char *s){
 void usb_putchar(char c){
 	USB_CDC_SendByte(c);
 }
+
+void usb_put_buf(const char *data, size_t length){
+	while (length--){
+		USB_CDC_SendByte(*data++);
+	}
+}
@@ -0,0 +1,21 @@
+/*
+ * crc16.c
+ *
+ * Nibble table CRC-CCITT; small enough for the MK1 while still fast.
+ */
+#include "crc16.h"
+
+//CRC-CCITT (polynomial 0x1021) of each nibble value
+static const uint16_t g_crcNibbleTable[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+	0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t *data, size_t length){
+	while (length--){
+		uint8_t b = *data++;
+		crc = (crc << 4) ^ g_crcNibbleTable[(crc >> 12) ^ (b >> 4)];
+		crc = (crc << 4) ^ g_crcNibbleTable[(crc >> 12) ^ (b & 0x0f)];
+	}
+	return crc;
+}
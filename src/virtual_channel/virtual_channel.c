@@ -5,9 +5,39 @@
 #include "loggerTaskEx.h"
 #include "capabilities.h"
 
+#if MAX_VIRTUAL_CHANNELS * 2 > VIRTUAL_CHANNEL_INDEX_SIZE
+#error "VIRTUAL_CHANNEL_INDEX_SIZE is too small for MAX_VIRTUAL_CHANNELS"
+#endif
+
 static size_t g_virtualChannelCount = 0;
 static VirtualChannel g_virtualChannels[MAX_VIRTUAL_CHANNELS];
 
+/* open addressed index of channel names; each slot holds a channel id + 1, or 0 if empty */
+static unsigned char g_channelIndex[VIRTUAL_CHANNEL_INDEX_SIZE];
+
+/* FNV-1a over the part of the name a label can hold */
+static size_t hashName(const char *name){
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < DEFAULT_LABEL_LENGTH && name[i]; i++){
+		hash ^= (unsigned char) name[i];
+		hash *= 16777619u;
+	}
+	return hash & (VIRTUAL_CHANNEL_INDEX_SIZE - 1);
+}
+
+static int isChannelNamed(size_t id, const char *name){
+	return strncmp(name, g_virtualChannels[id].config.label, DEFAULT_LABEL_LENGTH) == 0;
+}
+
+/* the slot holding the named channel, or the empty slot where it would go */
+static size_t findSlot(const char *name){
+	size_t slot = hashName(name);
+	while (g_channelIndex[slot] && !isChannelNamed(g_channelIndex[slot] - 1, name)){
+		slot = (slot + 1) & (VIRTUAL_CHANNEL_INDEX_SIZE - 1);
+	}
+	return slot;
+}
+
 VirtualChannel * get_virtual_channel(size_t id){
 	if (id < g_virtualChannelCount)
 		return g_virtualChannels + id;
@@ -16,20 +46,20 @@ VirtualChannel * get_virtual_channel(size_t id){
 }
 
 int find_virtual_channel(const char * channel_name){
-	for (size_t i = 0; i < g_virtualChannelCount; i++){
-		if (strcmp(channel_name, g_virtualChannels[i].config.label) == 0) return i;
-	}
-	return INVALID_VIRTUAL_CHANNEL;
+	const size_t slot = findSlot(channel_name);
+	return g_channelIndex[slot] ? g_channelIndex[slot] - 1 : INVALID_VIRTUAL_CHANNEL;
 }
 
 int create_virtual_channel(const ChannelConfig chCfg) {
 
-	int virtualChannelId = find_virtual_channel(chCfg.label);
+	const size_t slot = findSlot(chCfg.label);
+	int virtualChannelId = g_channelIndex[slot] ? g_channelIndex[slot] - 1 : INVALID_VIRTUAL_CHANNEL;
 
 	if (virtualChannelId == INVALID_VIRTUAL_CHANNEL){
 		if (g_virtualChannelCount < MAX_VIRTUAL_CHANNELS){
 			virtualChannelId = g_virtualChannelCount;
 			g_virtualChannelCount++;
+			g_channelIndex[slot] = virtualChannelId + 1;
 		}
 	}
 	if (virtualChannelId != INVALID_VIRTUAL_CHANNEL){
@@ -58,4 +88,5 @@ size_t get_virtual_channel_count(void){
 
 void reset_virtual_channels(void){
 	g_virtualChannelCount = 0;
+	memset(g_channelIndex, 0, sizeof(g_channelIndex));
 }
@@ -13,6 +13,15 @@
 #define MAX_SECTORS				20
 #define MAX_VIRTUAL_CHANNELS	30
 #define SCRIPT_MEMORY_LENGTH	10240
+#define PREDICTIVE_TIMER_SAMPLES	2048
+//size of the REFLAP region in f407_mem.ld
+#define REFERENCE_LAP_FLASH_SIZE	131072
+//largest Lua arena, and the heap kept back from it for buffers allocated later
+#define LUA_ARENA_SIZE			49152
+#define LUA_HEAP_RESERVE		16384
+#define SCRIPT_BYTECODE_LENGTH	32768
+//most sample buffers the logger shares with its consumers; each holds every enabled channel
+#define LOGGER_MESSAGE_BUFFER_LIMIT	32
 
 //Input / output Channels
 #define ANALOG_CHANNELS 		8
@@ -64,19 +64,27 @@ APP_SRC = 	$(APP_PATH)/main.c \
 			$(RCP_SRC)/watchdog/watchdog.c \
 			$(RCP_SRC)/launch_control.c \
 			$(RCP_SRC)/gps/gps.c \
+			$(RCP_SRC)/gps/nmea.c \
 			$(RCP_SRC)/gps/dateTime.c \
 			$(RCP_SRC)/gps/geopoint.c \
 			$(RCP_SRC)/gps/geoCircle.c \
 			$(RCP_SRC)/gps/gpsTask.c \
+			$(RCP_SRC)/predictive_timer/lapTrace.c \
 			$(RCP_SRC)/predictive_timer/predictive_timer_2.c \
+			$(RCP_SRC)/predictive_timer/referenceLap.c \
 			$(RCP_SRC)/filter/filter.c \
+			$(RCP_SRC)/lua/luaArena.c \
 			$(RCP_SRC)/lua/luaBaseBinding.c \
 			$(RCP_SRC)/lua/luaCommands.c \
+			$(RCP_SRC)/lua/luaScheduler.c \
 			$(RCP_SRC)/lua/luaScript.c \
 			$(RCP_SRC)/lua/luaTask.c \
 			$(RCP_SRC)/usb_comm/usb_comm.c \
 			$(RCP_SRC)/logger/loggerApi.c \
 			$(RCP_SRC)/logger/fileWriter.c \
+			$(RCP_SRC)/logger/binaryLogFormat.c \
+			$(RCP_SRC)/logger/telemetryFrame.c \
+			$(RCP_SRC)/logger/sampleDelta.c \
 			$(RCP_SRC)/logger/loggerCommands.c \
 			$(RCP_SRC)/logger/loggerConfig.c \
 			$(RCP_SRC)/logger/loggerData.c \
@@ -91,6 +99,7 @@ APP_SRC = 	$(APP_PATH)/main.c \
 			$(RCP_SRC)/devices/null_device.c \
 			$(RCP_SRC)/devices/sim900.c \
 			$(RCP_SRC)/tracks/tracks.c \
+			$(RCP_SRC)/tracks/trackIndex.c \
 			$(RCP_SRC)/auto_config/auto_track.c \
 			$(RCP_SRC)/messaging/messaging.c \
 			$(RCP_SRC)/LED/LED.c \
@@ -102,6 +111,7 @@ APP_SRC = 	$(APP_PATH)/main.c \
 			$(RCP_SRC)/util/linear_interpolate.c \
 			$(RCP_SRC)/util/modp_atonum.c \
 			$(RCP_SRC)/util/modp_numtoa.c \
+			$(RCP_SRC)/util/crc16.c \
 			$(RCP_SRC)/util/taskUtil.c \
 			$(RCP_SRC)/sdcard/sdcard.c \
 			$(HAL_SRC)/sim900_stm32/sim900_device_stm32.c \
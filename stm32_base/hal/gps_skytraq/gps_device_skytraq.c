@@ -1,4 +1,5 @@
 #include "gps_device.h"
+#include "loggerConfig.h"
 #include <stdint.h>
 #include <stddef.h>
 #include "printk.h"
@@ -42,6 +43,26 @@ typedef struct _BaudRateCodes{
 #define MSG_ID_POSITION_UPDATE_RATE 			0x86
 #define MSG_ID_CONFIGURE_SERIAL_PORT			0x05
 #define MSG_ID_CONFIGURE_NMEA_MESSAGE			0x08
+#define MSG_ID_CONFIGURE_MESSAGE_TYPE			0x09
+#define MSG_ID_NAVIGATION_DATA					0xA8
+
+#define MESSAGE_TYPE_NMEA						1
+#define MESSAGE_TYPE_BINARY						2
+
+/* Navigation Data Message: big endian fields at these payload offsets */
+#define NAV_DATA_LENGTH							59
+#define NAV_DATA_FIX_MODE						1
+#define NAV_DATA_SATELLITES						2
+#define NAV_DATA_GPS_WEEK						3
+#define NAV_DATA_TIME_OF_WEEK					5
+#define NAV_DATA_LATITUDE						9
+#define NAV_DATA_LONGITUDE						13
+#define NAV_DATA_ECEF_VELOCITY					47
+
+/* GPS epoch 1980-01-06 in unix seconds; GPS time is ahead of UTC by the leap seconds */
+#define GPS_EPOCH_UNIX_SECONDS					315964800LL
+#define GPS_UTC_LEAP_SECONDS					18
+#define SECONDS_PER_WEEK						604800LL
 
 #define GGA_INTERVAL							100
 #define GSA_INTERVAL							0
@@ -112,6 +133,12 @@ typedef struct _ConfigureNmeaMessage{
 	uint8_t attributes;
 } ConfigureNmeaMessage;
 
+typedef struct _ConfigureMessageType{
+	uint8_t messageId;
+	uint8_t type;
+	uint8_t attributes;
+} ConfigureMessageType;
+
 typedef struct _GpsMessage{
 	uint16_t payloadLength;
 	union{
@@ -126,6 +153,7 @@ typedef struct _GpsMessage{
 		ConfigureSerialPort configureSerialPort;
 		PositionUpdateRate positionUpdateRate;
 		ConfigureNmeaMessage configureNmeaMessage;
+		ConfigureMessageType configureMessageType;
 	};
 	uint8_t checksum;
 } GpsMessage;
@@ -180,10 +208,13 @@ static gps_msg_result_t rxGpsMessage(GpsMessage *msg, Serial *serial, uint8_t ex
 	size_t timeoutLen = msToTicks(GPS_MSG_RX_WAIT_MS);
 	size_t timeoutStart = xTaskGetTickCount();
 
+	uint8_t som1 = 0, som2 = 0;
 	while (result == GPS_MSG_NONE){
-		uint8_t som1 = 0, som2 = 0;
-		if (serial_read_byte(serial, &som1, timeoutLen) && serial_read_byte(serial, &som2, timeoutLen)){
+		//slide one byte at a time so a start of message at an odd offset is not missed
+		som1 = som2;
+		if (serial_read_byte(serial, &som2, timeoutLen)){
 			if (som1 == 0xA0 && som2 == 0xA1){
+				som2 = 0;
 				uint8_t len_h = 0, len_l = 0;
 				size_t len_hb = serial_read_byte(serial, &len_h, timeoutLen);
 				size_t len_lb = serial_read_byte(serial, &len_l, timeoutLen);
@@ -276,6 +307,15 @@ static void sendConfigureNmea(GpsMessage *gpsMsg, Serial *serial){
 	txGpsMessage(gpsMsg, serial);
 }
 
+static void sendConfigureMessageType(GpsMessage *gpsMsg, Serial *serial, uint8_t type){
+	gpsMsg->messageId = MSG_ID_CONFIGURE_MESSAGE_TYPE;
+	gpsMsg->configureMessageType.type = type;
+	gpsMsg->configureMessageType.attributes = ATTRIBUTE_UPDATE_TO_SRAM;
+	gpsMsg->payloadLength = sizeof(ConfigureMessageType);
+	gpsMsg->checksum = calculateChecksum(gpsMsg);
+	txGpsMessage(gpsMsg, serial);
+}
+
 static void sendConfigurePositionUpdateRate(GpsMessage *gpsMsg, Serial *serial, uint8_t updateRate){
 	gpsMsg->messageId = MSG_ID_CONFIGURE_POSITION_UPDATE_RATE;
 	gpsMsg->configurePositionUpdateRate.rate = updateRate;
@@ -356,6 +396,20 @@ static gps_cmd_result_t configureNmeaMessages(GpsMessage *gpsMsg, Serial *serial
 	return result;
 }
 
+static gps_cmd_result_t configureMessageType(GpsMessage *gpsMsg, Serial *serial, uint8_t type){
+	pr_info("GPS: Configuring message type ");
+	pr_info_int(type);
+	pr_info(": ");
+
+	gps_cmd_result_t result = GPS_COMMAND_FAIL;
+	sendConfigureMessageType(gpsMsg, serial, type);
+	if (rxGpsMessage(gpsMsg, serial, MSG_ID_ACK) == GPS_MSG_SUCCESS){
+		result = (gpsMsg->ackMsg.ackId == MSG_ID_CONFIGURE_MESSAGE_TYPE) ? GPS_COMMAND_SUCCESS : GPS_COMMAND_FAIL;
+	}
+	pr_info(result == GPS_COMMAND_SUCCESS ? "win\r\n" : "fail\r\n");
+	return result;
+}
+
 static uint8_t queryPositionUpdateRate(GpsMessage *gpsMsg, Serial *serial){
 	uint8_t updateRate = 0;
 	sendQueryPositionUpdateRate(gpsMsg, serial);
@@ -378,7 +432,7 @@ static gps_cmd_result_t configureUpdateRate(GpsMessage *gpsMsg, Serial *serial,
 	return result;
 }
 
-int GPS_device_provision(Serial *serial){
+int GPS_device_provision(Serial *serial, unsigned char *navFormat){
 	GpsMessage *gpsMsg = portMalloc(sizeof(GpsMessage));
 	if (gpsMsg == NULL){
 		pr_error("Could not create buffer for GPS message");
@@ -417,6 +471,17 @@ int GPS_device_provision(Serial *serial){
 					break;
 				}
 
+				if (*navFormat == GPS_NAV_FORMAT_BINARY && configureMessageType(gpsMsg, serial, MESSAGE_TYPE_BINARY) == GPS_COMMAND_FAIL){
+					pr_error("GPS: could not configure binary messages, using NMEA\r\n");
+					*navFormat = GPS_NAV_FORMAT_NMEA;
+				}
+
+				/* the module keeps its message type across a warm restart, so always select NMEA explicitly */
+				if (*navFormat == GPS_NAV_FORMAT_NMEA && configureMessageType(gpsMsg, serial, MESSAGE_TYPE_NMEA) == GPS_COMMAND_FAIL){
+					pr_error("GPS: Error provisioning - could not configure NMEA message type\r\n");
+					break;
+				}
+
 				pr_info("GPS: provisioned\r\n");
 				provisioned = 1;
 				break;
@@ -431,5 +496,35 @@ int GPS_device_provision(Serial *serial){
 		}
 	}
 	if (gpsMsg) portFree(gpsMsg);
+	if (!provisioned) *navFormat = GPS_NAV_FORMAT_NMEA;
 	return provisioned;
 }
+
+static uint16_t readUint16(const uint8_t *data){
+	return (data[0] << 8) | data[1];
+}
+
+static int32_t readInt32(const uint8_t *data){
+	return (int32_t)(((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3]);
+}
+
+int GPS_device_read_nav_data(Serial *serial, GpsNavData *nav){
+	static GpsMessage gpsMsg;
+	if (rxGpsMessage(&gpsMsg, serial, MSG_ID_NAVIGATION_DATA) != GPS_MSG_SUCCESS || gpsMsg.payloadLength < NAV_DATA_LENGTH){
+		return 0;
+	}
+	const uint8_t *payload = gpsMsg.payload;
+
+	nav->quality = payload[NAV_DATA_FIX_MODE] > 0 ? GPS_QUALITY_FIX : GPS_QUALITY_NO_FIX;
+	nav->satellites = payload[NAV_DATA_SATELLITES];
+	nav->latitude = readInt32(payload + NAV_DATA_LATITUDE);
+	nav->longitude = readInt32(payload + NAV_DATA_LONGITUDE);
+	for (size_t i = 0; i < 3; i++){
+		nav->ecefVelocity[i] = readInt32(payload + NAV_DATA_ECEF_VELOCITY + i * 4);
+	}
+
+	//time of week is in units of 0.01 seconds
+	millis_t seconds = GPS_EPOCH_UNIX_SECONDS + readUint16(payload + NAV_DATA_GPS_WEEK) * SECONDS_PER_WEEK - GPS_UTC_LEAP_SECONDS;
+	nav->utcMillis = seconds * 1000 + (millis_t)(uint32_t)readInt32(payload + NAV_DATA_TIME_OF_WEEK) * 10;
+	return 1;
+}
@@ -15,6 +15,10 @@
 #define ADDR_FLASH_SECTOR_3 ((uint32_t)0x0800C000)
 /* Base @ of Sector 4, 64 Kbytes */
 #define ADDR_FLASH_SECTOR_4 ((uint32_t)0x08010000)
+/* Base @ of Sector 8, 128 Kbytes */
+#define ADDR_FLASH_SECTOR_8 ((uint32_t)0x08080000)
+/* Base @ of Sector 9, 128 Kbytes */
+#define ADDR_FLASH_SECTOR_9 ((uint32_t)0x080A0000)
 
 static uint32_t selectFlashSector(const void *address){
 	uint32_t addr = (uint32_t)address;
@@ -28,6 +32,10 @@ static uint32_t selectFlashSector(const void *address){
 			return FLASH_Sector_3;
 		case ADDR_FLASH_SECTOR_4:
 			return FLASH_Sector_4;
+		case ADDR_FLASH_SECTOR_8:
+			return FLASH_Sector_8;
+		case ADDR_FLASH_SECTOR_9:
+			return FLASH_Sector_9;
 		default:
 			return 0;
 	}
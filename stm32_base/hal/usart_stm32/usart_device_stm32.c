@@ -2,6 +2,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "semphr.h"
 #include "stm32f4xx_usart.h"
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_misc.h"
@@ -9,10 +10,14 @@
 #include "stm32f4xx_dma.h"
 #include "printk.h"
 #include "mem_mang.h"
+#include "mod_string.h"
 #include "LED.h"
 
 #define UART_QUEUE_LENGTH 					1024
-#define GPS_BUFFER_SIZE						128
+//must be a power of 2
+#define UART_TX_BUFFER_SIZE					1024
+//must be a power of 2; about 11ms of data at 921600 baud
+#define GPS_BUFFER_SIZE						1024
 
 #define UART_WIRELESS_IRQ_PRIORITY 			7
 #define UART_AUX_IRQ_PRIORITY 				8
@@ -26,52 +31,120 @@
 
 typedef enum{
 	UART_RX_IRQ	= 1,
-	UART_TX_IRQ = 2
+	UART_TX_IRQ = 2,
+	UART_IDLE_IRQ = 4
 } uart_irq_type_t;
 
-xQueueHandle xUsart0Tx;
+/*
+ * Transmit ring drained by DMA. Tasks copy whole blocks into the ring and
+ * the DMA stream sends the longest contiguous run; the transfer complete
+ * interrupt retires it and starts the next one.
+ */
+struct usart_tx_dma {
+	USART_TypeDef *usart;
+	DMA_Stream_TypeDef *stream;
+	uint32_t channel;
+	uint32_t rcc_periph;
+	uint32_t all_flag_mask; /* required for clearing flags */
+	uint32_t tc_flag;
+	uint8_t irq_channel;
+	uint8_t irq_priority;
+	uint8_t *buffer;
+	size_t head; /* next byte written by tasks */
+	size_t tail; /* next byte handed to the DMA */
+	volatile size_t count; /* bytes in the ring, including the running transfer */
+	volatile size_t inflight;
+	xSemaphoreHandle space; /* given each time a transfer completes */
+};
+
+//the GPS port transmits rarely and its TX stream (DMA1 stream 6) is taken by I2C1; it keeps the TX interrupt
+static struct usart_tx_dma wirelessTx = {
+	.usart = USART1,
+	.stream = DMA2_Stream7,
+	.channel = DMA_Channel_4,
+	.rcc_periph = RCC_AHB1Periph_DMA2,
+	.all_flag_mask = DMA_FLAG_FEIF7 | DMA_FLAG_DMEIF7 | DMA_FLAG_TEIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TCIF7,
+	.tc_flag = DMA_IT_TCIF7,
+	.irq_channel = DMA2_Stream7_IRQn,
+	.irq_priority = UART_WIRELESS_IRQ_PRIORITY,
+};
+
+static struct usart_tx_dma auxTx = {
+	.usart = USART3,
+	.stream = DMA1_Stream3,
+	.channel = DMA_Channel_4,
+	.rcc_periph = RCC_AHB1Periph_DMA1,
+	.all_flag_mask = DMA_FLAG_FEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TCIF3,
+	.tc_flag = DMA_IT_TCIF3,
+	.irq_channel = DMA1_Stream3_IRQn,
+	.irq_priority = UART_AUX_IRQ_PRIORITY,
+};
+
+static struct usart_tx_dma telemetryTx = {
+	.usart = UART4,
+	.stream = DMA1_Stream4,
+	.channel = DMA_Channel_4,
+	.rcc_periph = RCC_AHB1Periph_DMA1,
+	.all_flag_mask = DMA_FLAG_FEIF4 | DMA_FLAG_DMEIF4 | DMA_FLAG_TEIF4 | DMA_FLAG_HTIF4 | DMA_FLAG_TCIF4,
+	.tc_flag = DMA_IT_TCIF4,
+	.irq_channel = DMA1_Stream4_IRQn,
+	.irq_priority = UART_TELEMETRY_IRQ_PRIORITY,
+};
+
+/*
+ * GPS receive ring written by a circular DMA stream. The half and full
+ * transfer interrupts and the idle line interrupt raised after each burst
+ * of sentences publish how far the DMA has written and wake the reader,
+ * which takes whole sentences straight out of the ring.
+ */
+struct usart_rx_dma {
+	uint8_t *buffer;
+	size_t dma_position; /* DMA write index as of the last interrupt */
+	volatile uint32_t received; /* running count of bytes published to the reader */
+	uint32_t consumed; /* running count of bytes taken by the reader */
+	xSemaphoreHandle data;
+};
+
+static struct usart_rx_dma gpsRx;
+
 xQueueHandle xUsart0Rx;
 
-xQueueHandle xUsart1Tx;
 xQueueHandle xUsart1Rx;
 
 xQueueHandle xUsart2Tx;
-xQueueHandle xUsart2Rx;
 
-xQueueHandle xUsart3Tx;
 xQueueHandle xUsart3Rx;
 
-static uint8_t *gpsRxBuffer;
+static int initTxBuffer(struct usart_tx_dma *tx) {
+	tx->buffer = (uint8_t *) portMalloc(UART_TX_BUFFER_SIZE);
+	vSemaphoreCreateBinary(tx->space);
+	tx->head = tx->tail = 0;
+	tx->count = tx->inflight = 0;
+	return tx->buffer != NULL && tx->space != NULL;
+}
 
 static int initQueues() {
 
-	gpsRxBuffer = (uint8_t *) portMalloc(sizeof(uint8_t) * GPS_BUFFER_SIZE);
+	gpsRx.buffer = (uint8_t *) portMalloc(sizeof(uint8_t) * GPS_BUFFER_SIZE);
+	vSemaphoreCreateBinary(gpsRx.data);
 
 	int success = 1;
 	/* Create the queues used to hold Rx and Tx characters. */
 	xUsart0Rx = xQueueCreate(UART_QUEUE_LENGTH,
 			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
-	xUsart0Tx = xQueueCreate(UART_QUEUE_LENGTH + 1,
-			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
 
 	xUsart1Rx = xQueueCreate(UART_QUEUE_LENGTH,
 			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
-	xUsart1Tx = xQueueCreate(UART_QUEUE_LENGTH + 1,
-			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
 
-	xUsart2Rx = xQueueCreate(UART_QUEUE_LENGTH,
-			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
 	xUsart2Tx = xQueueCreate(UART_QUEUE_LENGTH + 1,
 			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
 
 	xUsart3Rx = xQueueCreate(UART_QUEUE_LENGTH,
 			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
-	xUsart3Tx = xQueueCreate(UART_QUEUE_LENGTH + 1,
-			( unsigned portBASE_TYPE ) sizeof( signed portCHAR ));
 
-	if (xUsart0Rx == NULL || xUsart0Tx == NULL || xUsart1Rx == NULL
-			|| xUsart1Tx == NULL || xUsart2Rx == NULL || xUsart2Tx == NULL
-			|| xUsart3Rx == NULL || xUsart3Tx == NULL || gpsRxBuffer == NULL)
+	if (xUsart0Rx == NULL || xUsart1Rx == NULL || xUsart2Tx == NULL
+			|| xUsart3Rx == NULL || gpsRx.buffer == NULL || gpsRx.data == NULL
+			|| !initTxBuffer(&wirelessTx) || !initTxBuffer(&auxTx) || !initTxBuffer(&telemetryTx))
 		success = 0;
 	return success;
 }
@@ -171,6 +244,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id) {
 		serial->get_line_wait = &usart0_readLineWait;
 		serial->put_c = &usart0_putchar;
 		serial->put_s = &usart0_puts;
+		serial->put_buf = &usart0_put_buf;
 		break;
 
 	case UART_AUX:
@@ -182,6 +256,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id) {
 		serial->get_line_wait = &usart1_readLineWait;
 		serial->put_c = &usart1_putchar;
 		serial->put_s = &usart1_puts;
+		serial->put_buf = &usart1_put_buf;
 		break;
 
 	case UART_GPS:
@@ -193,6 +268,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id) {
 		serial->get_line_wait = &usart2_readLineWait;
 		serial->put_c = &usart2_putchar;
 		serial->put_s = &usart2_puts;
+		serial->put_buf = &usart2_put_buf;
 		break;
 
 	case UART_TELEMETRY:
@@ -204,6 +280,7 @@ int usart_device_init_serial(Serial *serial, uart_id_t id) {
 		serial->get_line_wait = &usart3_readLineWait;
 		serial->put_c = &usart3_putchar;
 		serial->put_s = &usart3_puts;
+		serial->put_buf = &usart3_put_buf;
 		break;
 
 	default:
@@ -254,7 +331,8 @@ static void enableRxDMA(uint32_t RCC_AHB1Periph, DMA_Stream_TypeDef* DMA_stream,
 	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
 	DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
 	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
-	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+	/* direct mode; the FIFO would hold back the tail of a sentence when the line goes idle */
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
 	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
 	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
 	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
@@ -284,8 +362,94 @@ static void enableRxTxIrq(USART_TypeDef* USARTx, uint8_t usartIrq, uint8_t IRQ_p
 	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
 	NVIC_Init(&NVIC_InitStructure);
 
-	if (irqType | UART_RX_IRQ) USART_ITConfig(USARTx, USART_IT_RXNE, ENABLE);
-	if (irqType | UART_TX_IRQ) USART_ITConfig(USARTx, USART_IT_TXE, ENABLE);
+	if (irqType & UART_RX_IRQ) USART_ITConfig(USARTx, USART_IT_RXNE, ENABLE);
+	if (irqType & UART_TX_IRQ) USART_ITConfig(USARTx, USART_IT_TXE, ENABLE);
+	if (irqType & UART_IDLE_IRQ) USART_ITConfig(USARTx, USART_IT_IDLE, ENABLE);
+}
+
+static void enableTxDMA(struct usart_tx_dma *tx) {
+
+	NVIC_InitTypeDef NVIC_InitStructure;
+	NVIC_InitStructure.NVIC_IRQChannel = tx->irq_channel;
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = tx->irq_priority;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_Init(&NVIC_InitStructure);
+
+	RCC_AHB1PeriphClockCmd(tx->rcc_periph, ENABLE);
+	DMA_InitTypeDef DMA_InitStructure;
+	/* re-init stops a running transfer without a transfer complete, so drop what was queued here */
+	taskENTER_CRITICAL();
+	DMA_DeInit(tx->stream);
+	tx->head = tx->tail = 0;
+	tx->count = tx->inflight = 0;
+	taskEXIT_CRITICAL();
+	/* wake a writer waiting on a full ring; it finds the ring empty and carries on */
+	xSemaphoreGive(tx->space);
+	DMA_InitStructure.DMA_Channel = tx->channel;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+	DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t) tx->buffer;
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t) & tx->usart->DR;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+	DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+	DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+	DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+	DMA_Init(tx->stream, &DMA_InitStructure);
+
+	DMA_ITConfig(tx->stream, DMA_IT_TC, ENABLE);
+	USART_DMACmd(tx->usart, USART_DMAReq_Tx, ENABLE);
+}
+
+/* Starts sending the next contiguous run of the ring; called with the DMA interrupt masked or from it */
+static void startTxDMA(struct usart_tx_dma *tx) {
+	size_t length = tx->count;
+	if (length == 0) return;
+	if (length > UART_TX_BUFFER_SIZE - tx->tail) length = UART_TX_BUFFER_SIZE - tx->tail;
+
+	DMA_ClearFlag(tx->stream, tx->all_flag_mask);
+	DMA_MemoryTargetConfig(tx->stream, (uint32_t) (tx->buffer + tx->tail), DMA_Memory_0);
+	DMA_SetCurrDataCounter(tx->stream, length);
+	tx->inflight = length;
+	DMA_Cmd(tx->stream, ENABLE);
+}
+
+static void writeTxDMA(struct usart_tx_dma *tx, const char *data, size_t length) {
+	while (length > 0) {
+		taskENTER_CRITICAL();
+		size_t count = UART_TX_BUFFER_SIZE - tx->count;
+		if (count > length) count = length;
+		if (count > UART_TX_BUFFER_SIZE - tx->head) count = UART_TX_BUFFER_SIZE - tx->head;
+		memcpy(tx->buffer + tx->head, data, count);
+		tx->head = (tx->head + count) & (UART_TX_BUFFER_SIZE - 1);
+		tx->count += count;
+		if (tx->inflight == 0) startTxDMA(tx);
+		taskEXIT_CRITICAL();
+
+		data += count;
+		length -= count;
+		/* ring is full; a transfer is running and gives the semaphore when it completes */
+		if (count == 0) xSemaphoreTake(tx->space, portMAX_DELAY);
+	}
+}
+
+static void completeTxDMA(struct usart_tx_dma *tx) {
+	portBASE_TYPE xTaskWoken = pdFALSE;
+	if (DMA_GetITStatus(tx->stream, tx->tc_flag)) {
+		DMA_ClearITPendingBit(tx->stream, tx->tc_flag);
+		tx->tail = (tx->tail + tx->inflight) & (UART_TX_BUFFER_SIZE - 1);
+		tx->count -= tx->inflight;
+		tx->inflight = 0;
+		startTxDMA(tx);
+		xSemaphoreGiveFromISR(tx->space, &xTaskWoken);
+	}
+	portEND_SWITCHING_ISR(xTaskWoken);
 }
 
 //Wireless port
@@ -298,7 +462,8 @@ void usart_device_init_0(unsigned int bits, unsigned int parity,
 	GPIO_PinAFConfig(GPIOA, GPIO_PinSource9, GPIO_AF_USART1);
 	GPIO_PinAFConfig(GPIOA, GPIO_PinSource10, GPIO_AF_USART1);
 
-	enableRxTxIrq(USART1, USART1_IRQn, UART_WIRELESS_IRQ_PRIORITY, UART_RX_IRQ | UART_TX_IRQ);
+	enableRxTxIrq(USART1, USART1_IRQn, UART_WIRELESS_IRQ_PRIORITY, UART_RX_IRQ);
+	enableTxDMA(&wirelessTx);
 
 	initUsart(USART1, bits, parity, stopBits, baud);
 }
@@ -313,7 +478,8 @@ void usart_device_init_1(unsigned int bits, unsigned int parity,
 	GPIO_PinAFConfig(GPIOD, GPIO_PinSource8, GPIO_AF_USART3);
 	GPIO_PinAFConfig(GPIOD, GPIO_PinSource9, GPIO_AF_USART3);
 
-	enableRxTxIrq(USART3, USART3_IRQn, UART_AUX_IRQ_PRIORITY, UART_RX_IRQ | UART_TX_IRQ);
+	enableRxTxIrq(USART3, USART3_IRQn, UART_AUX_IRQ_PRIORITY, UART_RX_IRQ);
+	enableTxDMA(&auxTx);
 
 	initUsart(USART3, bits, parity, stopBits, baud);
 }
@@ -330,8 +496,11 @@ void usart_device_init_2(unsigned int bits, unsigned int parity,
 
 	initUsart(USART2, bits, parity, stopBits, baud);
 
-	enableRxTxIrq(USART2, USART2_IRQn, UART_GPS_IRQ_PRIORITY, UART_TX_IRQ);
-	enableRxDMA(RCC_AHB1Periph_DMA1, DMA1_Stream5, DMA_Channel_4, gpsRxBuffer, GPS_BUFFER_SIZE, USART2, DMA1_Stream5_IRQn, UART_GPS_IRQ_PRIORITY);
+	DMA_Cmd(DMA1_Stream5, DISABLE);
+	gpsRx.dma_position = 0;
+	gpsRx.consumed = gpsRx.received;
+	enableRxDMA(RCC_AHB1Periph_DMA1, DMA1_Stream5, DMA_Channel_4, gpsRx.buffer, GPS_BUFFER_SIZE, USART2, DMA1_Stream5_IRQn, UART_GPS_IRQ_PRIORITY);
+	enableRxTxIrq(USART2, USART2_IRQn, UART_GPS_IRQ_PRIORITY, UART_TX_IRQ | UART_IDLE_IRQ);
 }
 
 //Telemetry port
@@ -344,7 +513,8 @@ void usart_device_init_3(unsigned int bits, unsigned int parity,
 	GPIO_PinAFConfig(GPIOA, GPIO_PinSource0, GPIO_AF_UART4);
 	GPIO_PinAFConfig(GPIOA, GPIO_PinSource1, GPIO_AF_UART4);
 
-	enableRxTxIrq(UART4, UART4_IRQn, UART_TELEMETRY_IRQ_PRIORITY, UART_RX_IRQ | UART_TX_IRQ);
+	enableRxTxIrq(UART4, UART4_IRQn, UART_TELEMETRY_IRQ_PRIORITY, UART_RX_IRQ);
+	enableTxDMA(&telemetryTx);
 
 	initUsart(UART4, bits, parity, stopBits, baud);
 }
@@ -366,9 +536,7 @@ void usart1_flush(void) {
 }
 
 void usart2_flush(void) {
-	char rx;
-	while (xQueueReceive(xUsart2Rx, &rx, 0))
-		;
+	gpsRx.consumed = gpsRx.received;
 }
 
 void usart3_flush(void) {
@@ -385,8 +553,30 @@ int usart1_getcharWait(char *c, size_t delay) {
 	return xQueueReceive( xUsart1Rx, c, delay ) == pdTRUE ? 1 : 0;
 }
 
+/* bytes waiting in the GPS ring; drops the backlog if the DMA lapped the reader */
+static uint32_t gpsRxAvailable() {
+	uint32_t available = gpsRx.received - gpsRx.consumed;
+	if (available > GPS_BUFFER_SIZE) {
+		gpsRx.consumed = gpsRx.received;
+		available = 0;
+	}
+	return available;
+}
+
+static uint32_t gpsRxWait(size_t delay) {
+	uint32_t available;
+	while ((available = gpsRxAvailable()) == 0) {
+		if (xSemaphoreTake(gpsRx.data, delay) != pdTRUE)
+			break;
+	}
+	return available;
+}
+
 int usart2_getcharWait(char *c, size_t delay) {
-	return xQueueReceive( xUsart2Rx, c, delay) == pdTRUE ? 1 : 0;
+	if (!gpsRxWait(delay))
+		return 0;
+	*c = gpsRx.buffer[gpsRx.consumed++ & (GPS_BUFFER_SIZE - 1)];
+	return 1;
 }
 
 int usart3_getcharWait(char *c, size_t delay) {
@@ -424,9 +614,7 @@ void usart0_putchar(char c) {
 		buf[1] = '\0';
 		pr_debug(buf);
 	}
-	xQueueSend(xUsart0Tx, &c, portMAX_DELAY);
-	//Enable transmitter interrupt
-	USART_ITConfig(USART1, USART_IT_TXE, ENABLE);
+	writeTxDMA(&wirelessTx, &c, 1);
 }
 
 void usart1_putchar(char c) {
@@ -436,9 +624,7 @@ void usart1_putchar(char c) {
 		buf[1] = '\0';
 		pr_debug(buf);
 	}
-	xQueueSend(xUsart1Tx, &c, portMAX_DELAY);
-	//Enable transmitter interrupt
-	USART_ITConfig(USART3, USART_IT_TXE, ENABLE);
+	writeTxDMA(&auxTx, &c, 1);
 }
 
 void usart2_putchar(char c) {
@@ -460,19 +646,23 @@ void usart3_putchar(char c) {
 		buf[1] = '\0';
 		pr_debug(buf);
 	}
-	xQueueSend(xUsart3Tx, &c, portMAX_DELAY);
-	//Enable transmitter interrupt
-	USART_ITConfig(UART4, USART_IT_TXE, ENABLE);
+	writeTxDMA(&telemetryTx, &c, 1);
 }
 
 void usart0_puts(const char* s) {
-	while (*s)
-		usart0_putchar(*s++);
+	writeTxDMA(&wirelessTx, s, strlen(s));
+}
+
+void usart0_put_buf(const char *data, size_t length) {
+	writeTxDMA(&wirelessTx, data, length);
 }
 
 void usart1_puts(const char* s) {
-	while (*s)
-		usart1_putchar(*s++);
+	writeTxDMA(&auxTx, s, strlen(s));
+}
+
+void usart1_put_buf(const char *data, size_t length) {
+	writeTxDMA(&auxTx, data, length);
 }
 
 void usart2_puts(const char* s) {
@@ -480,9 +670,17 @@ void usart2_puts(const char* s) {
 		usart2_putchar(*s++);
 }
 
+void usart2_put_buf(const char *data, size_t length) {
+	while (length--)
+		usart2_putchar(*data++);
+}
+
 void usart3_puts(const char* s) {
-	while (*s)
-		usart3_putchar(*s++);
+	writeTxDMA(&telemetryTx, s, strlen(s));
+}
+
+void usart3_put_buf(const char *data, size_t length) {
+	writeTxDMA(&telemetryTx, data, length);
 }
 
 int usart0_readLineWait(char *s, int len, size_t delay) {
@@ -517,14 +715,16 @@ int usart1_readLineWait(char *s, int len, size_t delay) {
 
 int usart2_readLineWait(char *s, int len, size_t delay) {
 	int count = 0;
-	while (count < len - 1) {
-		char c = 0;
-		if (!usart2_getcharWait(&c, delay))
-			break;
-		*s++ = c;
-		count++;
-		if (c == '\n')
+	char c = 0;
+	while (count < len - 1 && c != '\n') {
+		uint32_t available = gpsRxWait(delay);
+		if (!available)
 			break;
+		while (available-- && count < len - 1 && c != '\n') {
+			c = gpsRx.buffer[gpsRx.consumed++ & (GPS_BUFFER_SIZE - 1)];
+			*s++ = c;
+			count++;
+		}
 	}
 	*s = '\0';
 	return count;
@@ -565,51 +765,37 @@ int usart3_readLine(char *s, int len) {
 // Interrupt Handlers
 ////////////////////////////////////////////////////////////////////////////
 
+/* publishes what the GPS DMA stream has written since the last interrupt */
+static void publishGpsRx(portBASE_TYPE *xTaskWoken) {
+	size_t position = (GPS_BUFFER_SIZE - DMA_GetCurrDataCounter(DMA1_Stream5)) & (GPS_BUFFER_SIZE - 1);
+	gpsRx.received += (position - gpsRx.dma_position) & (GPS_BUFFER_SIZE - 1);
+	gpsRx.dma_position = position;
+	xSemaphoreGiveFromISR(gpsRx.data, xTaskWoken);
+}
+
 void DMA1_Stream5_IRQHandler(void) {
 	portBASE_TYPE xTaskWokenByPost = pdFALSE;
-	signed portCHAR cChar;
 	/* Test on DMA Stream Transfer Complete interrupt */
 	if (DMA_GetITStatus(DMA1_Stream5, DMA_IT_TCIF5)) {
 		/* Clear DMA Stream Transfer Complete interrupt pending bit */
 		DMA_ClearITPendingBit(DMA1_Stream5, DMA_IT_TCIF5);
-		for (size_t i = GPS_BUFFER_SIZE / 2; i < GPS_BUFFER_SIZE; i++) {
-			cChar = gpsRxBuffer[i];
-			xQueueSendFromISR(xUsart2Rx, &cChar, &xTaskWokenByPost);
-		}
+		publishGpsRx(&xTaskWokenByPost);
 	}
 
 	/* Test on DMA Stream Half Transfer interrupt */
 	if (DMA_GetITStatus(DMA1_Stream5, DMA_IT_HTIF5)) {
 		/* Clear DMA Stream Half Transfer interrupt pending bit */
 		DMA_ClearITPendingBit(DMA1_Stream5, DMA_IT_HTIF5);
-		for (size_t i = 0; i < GPS_BUFFER_SIZE / 2; i++) {
-			cChar = gpsRxBuffer[i];
-			xQueueSendFromISR(xUsart2Rx, &cChar, &xTaskWokenByPost);
-		}
+		publishGpsRx(&xTaskWokenByPost);
 	}
 	portEND_SWITCHING_ISR(xTaskWokenByPost);
 }
 
 void USART1_IRQHandler( void ){
 
-	portBASE_TYPE xTaskWokenByTx = pdFALSE, xTaskWokenByPost = pdFALSE;
+	portBASE_TYPE xTaskWokenByPost = pdFALSE;
 	signed portCHAR cChar;
 
-	if (USART_GetITStatus(USART1, USART_IT_TXE) != RESET)
-	{
-		/* The interrupt was caused by the TX becoming empty.  Are there any more characters to transmit? */
-		if( xQueueReceiveFromISR( xUsart0Tx, &cChar, &xTaskWokenByTx ) == pdTRUE )
-		{
-			// A character was retrieved from the queue so can be sent to the USART
-			USART_SendData(USART1, cChar);
-		}
-		else
-		{
-			/* Queue empty, nothing to send so turn off the Tx interrupt. */
-			USART_ITConfig(USART1, USART_IT_TXE, DISABLE);
-		}
-	}
-
 	if (USART_GetITStatus(USART1, USART_IT_RXNE) != RESET)
 	{
 		/* The interrupt was caused by a character being received.  Grab the
@@ -619,9 +805,8 @@ void USART1_IRQHandler( void ){
 		xQueueSendFromISR( xUsart0Rx, &cChar, &xTaskWokenByPost );
 	}
 
-	/* If a task was woken by either a character being received or a character
-	being transmitted then we may need to switch to another task. */
-	portEND_SWITCHING_ISR( xTaskWokenByPost || xTaskWokenByTx );
+	/* If a task was woken by a character being received then we may need to switch to another task. */
+	portEND_SWITCHING_ISR( xTaskWokenByPost );
 }
 
 void USART2_IRQHandler( void ){
@@ -644,16 +829,14 @@ void USART2_IRQHandler( void ){
 		}
 	}
 
-	if (USART_GetITStatus(USART2, USART_IT_RXNE) != RESET)
+	if (USART_GetITStatus(USART2, USART_IT_IDLE) != RESET)
 	{
-		/* The interrupt was caused by a character being received.  Grab the
-		character from the rx and place it in the queue or received
-		characters. */
-		cChar = USART_ReceiveData(USART2);
-		xQueueSendFromISR( xUsart2Rx, &cChar, &xTaskWokenByPost );
+		/* The line went idle after a burst of sentences; reading DR after SR clears the flag */
+		USART_ReceiveData(USART2);
+		publishGpsRx(&xTaskWokenByPost);
 	}
 
-	/* If a task was woken by either a character being received or a character
+	/* If a task was woken by either received sentences or a character
 	being transmitted then we may need to switch to another task. */
 	portEND_SWITCHING_ISR( xTaskWokenByPost || xTaskWokenByTx );
 }
@@ -661,24 +844,9 @@ void USART2_IRQHandler( void ){
 
 void USART3_IRQHandler( void ){
 
-	portBASE_TYPE xTaskWokenByTx = pdFALSE, xTaskWokenByPost = pdFALSE;
+	portBASE_TYPE xTaskWokenByPost = pdFALSE;
 	signed portCHAR cChar;
 
-	if (USART_GetITStatus(USART3, USART_IT_TXE) != RESET)
-	{
-		/* The interrupt was caused by the TX becoming empty.  Are there any more characters to transmit? */
-		if( xQueueReceiveFromISR( xUsart1Tx, &cChar, &xTaskWokenByTx ) == pdTRUE )
-		{
-			// A character was retrieved from the queue so can be sent to the USART
-			USART_SendData(USART3, cChar);
-		}
-		else
-		{
-			/* Queue empty, nothing to send so turn off the Tx interrupt. */
-			USART_ITConfig(USART3, USART_IT_TXE, DISABLE);
-		}
-	}
-
 	if (USART_GetITStatus(USART3, USART_IT_RXNE) != RESET)
 	{
 		/* The interrupt was caused by a character being received.  Grab the
@@ -688,30 +856,15 @@ void USART3_IRQHandler( void ){
 		xQueueSendFromISR( xUsart1Rx, &cChar, &xTaskWokenByPost );
 	}
 
-	/* If a task was woken by either a character being received or a character
-	being transmitted then we may need to switch to another task. */
-	portEND_SWITCHING_ISR( xTaskWokenByPost || xTaskWokenByTx );
+	/* If a task was woken by a character being received then we may need to switch to another task. */
+	portEND_SWITCHING_ISR( xTaskWokenByPost );
 }
 
 void UART4_IRQHandler( void ){
 
-	portBASE_TYPE xTaskWokenByTx = pdFALSE, xTaskWokenByPost = pdFALSE;
+	portBASE_TYPE xTaskWokenByPost = pdFALSE;
 	signed portCHAR cChar;
 
-	if (USART_GetITStatus(UART4, USART_IT_TXE) != RESET)
-	{
-		/* The interrupt was caused by the TX becoming empty.  Are there any more characters to transmit? */
-		if( xQueueReceiveFromISR( xUsart3Tx, &cChar, &xTaskWokenByTx ) == pdTRUE )
-		{
-			// A character was retrieved from the queue so can be sent to the USART
-			USART_SendData(UART4, cChar);
-		}
-		else
-		{
-			/* Queue empty, nothing to send so turn off the Tx interrupt. */
-			USART_ITConfig(UART4, USART_IT_TXE, DISABLE);
-		}
-	}
 	if (USART_GetITStatus(UART4, USART_IT_RXNE) != RESET)
 	{
 		/* The interrupt was caused by a character being received.  Grab the
@@ -721,9 +874,18 @@ void UART4_IRQHandler( void ){
 		xQueueSendFromISR( xUsart3Rx, &cChar, &xTaskWokenByPost );
 	}
 
-	/* If a task was woken by either a character being received or a character
-	being transmitted then we may need to switch to another task. */
-	portEND_SWITCHING_ISR( xTaskWokenByPost || xTaskWokenByTx );
+	/* If a task was woken by a character being received then we may need to switch to another task. */
+	portEND_SWITCHING_ISR( xTaskWokenByPost );
 }
 
+void DMA2_Stream7_IRQHandler(void) {
+	completeTxDMA(&wirelessTx);
+}
 
+void DMA1_Stream3_IRQHandler(void) {
+	completeTxDMA(&auxTx);
+}
+
+void DMA1_Stream4_IRQHandler(void) {
+	completeTxDMA(&telemetryTx);
+}
@@ -7,14 +7,17 @@
 
 #include "PredictiveTimeTest2.h"
 
+#include <math.h>
 #include <stdlib.h>
 
 #include "dateTime.h"
 #include "geopoint.h"
 #include "gps.h"
 #include "gps.testing.h"
+#include "mod_string.h"
 #include "modp_atonum.h"
 #include "predictive_timer_2.h"
+#include "referenceLap.h"
 #include "loggerConfig.h"
 #include "rcp_cpp_unit.hh"
 
@@ -35,7 +38,11 @@ void PredictiveTimeTest2::setUp() {
 	resetPredictiveTimer();
 }
 
-void PredictiveTimeTest2::tearDown() {}
+void PredictiveTimeTest2::tearDown() {
+	ReferenceLap blank;
+	memset(&blank, 0, sizeof(blank));
+	flash_reference_lap(&blank, sizeof(blank));
+}
 
 vector<string> & PredictiveTimeTest2::split(string &s, char delim, vector<string> &elems) {
     std::stringstream ss(s);
@@ -83,6 +90,90 @@ void PredictiveTimeTest2::testProjectedDistance() {
   CPPUNIT_ASSERT_CLOSE_ENOUGH(expected, actual);
 }
 
+/* a point on a 300m circle, lapFraction of the way around from the start/finish */
+static GeoPoint circuitPoint(float lapFraction) {
+	const float radius = 300;
+	const float angle = lapFraction * 2 * M_PI;
+	GeoPoint p;
+	p.latitude = 47.25f + radius * sinf(angle) / GP_METERS_PER_DEGREE;
+	p.longitude = -123.19f + radius * cosf(angle) / (GP_METERS_PER_DEGREE * cosf(47.25f * M_PI / 180));
+	return p;
+}
+
+/* drives one lap of the circuit at 10Hz, starting at lapStart */
+static void driveLap(tiny_millis_t lapStart, tiny_millis_t lapTime) {
+	for (tiny_millis_t t = 100; t < lapTime; t += 100)
+		addGpsSample(circuitPoint((float) t / lapTime), lapStart + t);
+	startFinishCrossed(circuitPoint(0), lapStart + lapTime);
+}
+
+void PredictiveTimeTest2::testSplitAlongLap() {
+	const tiny_millis_t fastLapTime = 60000;
+	const tiny_millis_t slowLapTime = 63000;
+
+	// The first lap sets the poll interval, the second fills the buffer for the fast lap.
+	startFinishCrossed(circuitPoint(0), 0);
+	driveLap(0, fastLapTime);
+	driveLap(fastLapTime, fastLapTime);
+	CPPUNIT_ASSERT(isPredictiveTimeAvailable());
+
+	const tiny_millis_t lapStart = 2 * fastLapTime;
+	for (tiny_millis_t t = 1000; t < slowLapTime - 1000; t += 100) {
+		const tiny_millis_t expected = (tiny_millis_t) ((float) t * fastLapTime / slowLapTime) - t;
+		const tiny_millis_t split = getSplitAgainstFastLap(circuitPoint((float) t / slowLapTime), lapStart + t);
+		CPPUNIT_ASSERT(abs(expected - split) < 50);
+	}
+
+	// Jumping back around the lap loses the walk; the whole lap is searched instead.
+	const tiny_millis_t t = slowLapTime / 8;
+	const tiny_millis_t expected = (tiny_millis_t) ((float) t * fastLapTime / slowLapTime) - t;
+	CPPUNIT_ASSERT(abs(expected - getSplitAgainstFastLap(circuitPoint(0.125f), lapStart + t)) < 50);
+}
+
+void PredictiveTimeTest2::testReferenceLap() {
+	const tiny_millis_t fastLapTime = 60000;
+	Track track;
+	memset(&track, 0, sizeof(track));
+	track.circuit.startFinish = circuitPoint(0);
+	Track otherTrack = track;
+	otherTrack.circuit.startFinish.latitude += 0.01f;
+
+	startFinishCrossed(circuitPoint(0), 0);
+	driveLap(0, fastLapTime);
+	driveLap(fastLapTime, fastLapTime);
+	CPPUNIT_ASSERT(!isFastLapSaved());
+	CPPUNIT_ASSERT_EQUAL(0, saveFastLap(&track));
+	CPPUNIT_ASSERT(isFastLapSaved());
+
+	// After a power cycle the first lap has a predicted time.
+	resetPredictiveTimer();
+	CPPUNIT_ASSERT(!loadFastLap(&otherTrack));
+	CPPUNIT_ASSERT(!isPredictiveTimeAvailable());
+	CPPUNIT_ASSERT(loadFastLap(&track));
+	CPPUNIT_ASSERT(isPredictiveTimeAvailable());
+	CPPUNIT_ASSERT(isFastLapSaved());
+
+	const tiny_millis_t lapStart = 300000;
+	startFinishCrossed(circuitPoint(0), lapStart);
+	for (tiny_millis_t t = 1000; t < fastLapTime - 1000; t += 1000) {
+		const tiny_millis_t split = getSplitAgainstFastLap(circuitPoint((float) t / fastLapTime), lapStart + t);
+		CPPUNIT_ASSERT(abs(split) < 50);
+	}
+	CPPUNIT_ASSERT(abs(fastLapTime - getPredictedTime(circuitPoint(0.5f), lapStart + fastLapTime / 2)) < 50);
+
+	// A slower lap does not replace the reference lap.
+	driveLap(lapStart, fastLapTime + 1000);
+	CPPUNIT_ASSERT(isFastLapSaved());
+
+	// A reference lap written in another format is ignored.
+	ReferenceLap stale = *get_reference_lap();
+	stale.version = REFERENCE_LAP_FORMAT_VERSION + 1;
+	flash_reference_lap(&stale, sizeof(stale));
+	resetPredictiveTimer();
+	CPPUNIT_ASSERT(!loadFastLap(&track));
+	CPPUNIT_ASSERT(!isPredictiveTimeAvailable());
+}
+
 void PredictiveTimeTest2::testPredictedTimeGpsFeed() {
 	string log = readFile("predictive_time_test_lap.log");
 
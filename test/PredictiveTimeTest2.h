@@ -25,6 +25,8 @@ class PredictiveTimeTest2 : public CppUnit::TestFixture {
 	CPPUNIT_TEST_SUITE( PredictiveTimeTest2 );
         //	CPPUNIT_TEST( testPredictedTimeGpsFeed );
         CPPUNIT_TEST( testProjectedDistance );
+        CPPUNIT_TEST( testSplitAlongLap );
+        CPPUNIT_TEST( testReferenceLap );
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -33,6 +35,8 @@ public:
 	void tearDown();
 	void testPredictedTimeGpsFeed();
         void testProjectedDistance();
+        void testSplitAlongLap();
+        void testReferenceLap();
 
 private:
 	string readFile(string filename);
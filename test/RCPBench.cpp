@@ -0,0 +1,17 @@
+#include <stdio.h>
+#include "benchmark.h"
+
+/*
+ * Host side micro benchmarks for firmware hot paths.
+ * usage: rcpbench
+ */
+int main(int argc, char* argv[])
+{
+	benchmarkSampleSchedule();
+	benchmarkChannelPlan();
+	benchmarkTelemetryFrame();
+	benchmarkNmea();
+	benchmarkTrackIndex();
+	benchmarkGeoPoint();
+	return 0;
+}
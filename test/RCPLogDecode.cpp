@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+#include "binaryLogDecoder.h"
+
+/*
+ * Converts a binary RaceCapture/Pro log file to the CSV log format.
+ * usage: rcplogdecode <binary log> [csv output]
+ */
+int main(int argc, char* argv[])
+{
+	if (argc < 2){
+		fprintf(stderr, "usage: %s <binary log> [csv output]\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::in | std::ios::binary);
+	if (!in.is_open()){
+		fprintf(stderr, "could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::ofstream file;
+	if (argc > 2){
+		file.open(argv[2]);
+		if (!file.is_open()){
+			fprintf(stderr, "could not open %s\n", argv[2]);
+			return 1;
+		}
+	}
+	std::ostream &out = argc > 2 ? file : std::cout;
+
+	size_t skipped = 0;
+	int records = decodeBinaryLog(in, out, &skipped);
+	if (records < 0){
+		fprintf(stderr, "%s is not a binary log file\n", argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%d records decoded, %u bytes skipped\n", records, (unsigned int)skipped);
+	return 0;
+}
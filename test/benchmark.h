@@ -0,0 +1,31 @@
+/*
+ * benchmark.h
+ *
+ * Timing helpers shared by the host side micro benchmarks run by rcpbench.
+ */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+static inline double benchmarkSeconds(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline void benchmarkReport(const char *name, size_t iterations, double seconds, const char *unit){
+	printf("%-48s %14.0f %s/sec\n", name, iterations / seconds, unit);
+}
+
+void benchmarkSampleSchedule();
+void benchmarkChannelPlan();
+void benchmarkTelemetryFrame();
+void benchmarkNmea();
+void benchmarkTrackIndex();
+void benchmarkGeoPoint();
+
+#endif /* BENCHMARK_H_ */
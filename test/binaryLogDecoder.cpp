@@ -0,0 +1,233 @@
+/*
+ * binaryLogDecoder.cpp
+ *
+ * Output formatting mirrors writeHeaders / writeChannelSamples in fileWriter.c
+ */
+#include "binaryLogDecoder.h"
+#include "binaryLogFormat.h"
+#include "crc16.h"
+#include "modp_numtoa.h"
+#include <stdint.h>
+#include <string.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+struct ChannelMeta {
+	string label;
+	string units;
+	float min;
+	float max;
+	unsigned int sampleRate;
+	int precision;
+	enum BinaryLogValueType type;
+	bool fixTimestamped;
+};
+
+static bool readBytes(std::istream &in, uint8_t *buf, size_t length){
+	in.read((char *)buf, length);
+	return (size_t)in.gcount() == length;
+}
+
+static uint64_t unpack(const uint8_t *buf, size_t length){
+	uint64_t value = 0;
+	for (size_t i = length; i > 0; i--){
+		value = (value << 8) | buf[i - 1];
+	}
+	return value;
+}
+
+static float unpackFloat(const uint8_t *buf){
+	uint32_t bits = (uint32_t)unpack(buf, 4);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static double unpackDouble(const uint8_t *buf){
+	uint64_t bits = unpack(buf, 8);
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static string fixedString(const uint8_t *buf, size_t length){
+	return string((const char *)buf, strnlen((const char *)buf, length));
+}
+
+static void writeFloat(std::ostream &out, float value, int precision){
+	char buf[30];
+	modp_ftoa(value, buf, precision);
+	out << buf;
+}
+
+/*
+ * Mirrors getFixTimeSampleRate in fileWriter.c: the GPS fix time column is
+ * written at the highest rate of the GPS channels, if there are any.
+ */
+static unsigned int getFixTimeSampleRate(const vector<ChannelMeta> &channels){
+	unsigned int rate = 0;
+	for (size_t i = 0; i < channels.size(); i++){
+		if (channels[i].fixTimestamped && channels[i].sampleRate > rate) rate = channels[i].sampleRate;
+	}
+	return rate;
+}
+
+static bool readHeader(std::istream &in, std::ostream &out, vector<ChannelMeta> &channels, uint32_t &fileId){
+	uint8_t preamble[BINARY_LOG_PREAMBLE_SIZE];
+	if (!readBytes(in, preamble, sizeof(preamble))) return false;
+	if (memcmp(preamble, BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_LENGTH) != 0) return false;
+	if (preamble[BINARY_LOG_MAGIC_LENGTH] != BINARY_LOG_VERSION) return false;
+
+	size_t channelCount = (size_t)unpack(preamble + BINARY_LOG_MAGIC_LENGTH + 1, 2);
+	fileId = (uint32_t)unpack(preamble + BINARY_LOG_MAGIC_LENGTH + 3, 4);
+	for (size_t i = 0; i < channelCount; i++){
+		uint8_t meta[BINARY_LOG_CHANNEL_META_SIZE];
+		if (!readBytes(in, meta, sizeof(meta))) return false;
+
+		const uint8_t *field = meta;
+		ChannelMeta channel;
+		channel.label = fixedString(field, DEFAULT_LABEL_LENGTH);
+		field += DEFAULT_LABEL_LENGTH;
+		channel.units = fixedString(field, DEFAULT_UNITS_LENGTH);
+		field += DEFAULT_UNITS_LENGTH;
+		channel.min = unpackFloat(field);
+		field += 4;
+		channel.max = unpackFloat(field);
+		field += 4;
+		channel.sampleRate = (unsigned int)unpack(field, 2);
+		field += 2;
+		channel.precision = *field++;
+		channel.fixTimestamped = (*field & BINARY_LOG_FIX_TIMESTAMPED) != 0;
+		channel.type = (enum BinaryLogValueType)(*field++ & ~BINARY_LOG_FIX_TIMESTAMPED);
+		channels.push_back(channel);
+	}
+
+	for (size_t i = 0; i < channels.size(); i++){
+		const ChannelMeta &channel = channels[i];
+		char buf[12];
+		if (i > 0) out << ",";
+		out << "\"" << channel.label << "\"|\"" << channel.units << "\"|";
+		writeFloat(out, channel.min, channel.precision);
+		out << "|";
+		writeFloat(out, channel.max, channel.precision);
+		out << "|";
+		modp_itoa10(channel.sampleRate, buf);
+		out << buf;
+	}
+
+	const unsigned int fixTimeRate = getFixTimeSampleRate(channels);
+	if (fixTimeRate){
+		char buf[12];
+		modp_uitoa10(fixTimeRate, buf);
+		out << ",\"" FIX_TIME_LABEL "\"|\"" FIX_TIME_UNITS "\"|0|0|" << buf;
+	}
+	out << "\n";
+	return true;
+}
+
+static bool isPopulated(const uint8_t *mask, size_t channel){
+	return (mask[channel / 8] & (1 << (channel % 8))) != 0;
+}
+
+static bool hasFixTime(const uint8_t *mask, const vector<ChannelMeta> &channels){
+	for (size_t i = 0; i < channels.size(); i++){
+		if (channels[i].fixTimestamped && isPopulated(mask, i)) return true;
+	}
+	return false;
+}
+
+/*
+ * Checks the record framed at data: its CRC has to match and its length has
+ * to agree with the channels its mask says are populated.
+ */
+static bool isValidRecord(const uint8_t *data, size_t available, const vector<ChannelMeta> &channels, uint16_t crcSeed){
+	if (available < BINARY_LOG_RECORD_HEADER_SIZE + BINARY_LOG_RECORD_CRC_SIZE) return false;
+	if (data[0] != BINARY_LOG_RECORD_SYNC0 || data[1] != BINARY_LOG_RECORD_SYNC1) return false;
+
+	const size_t length = (size_t)unpack(data + 2, 2);
+	const size_t maskSize = BINARY_LOG_MASK_SIZE(channels.size());
+	if (length < maskSize ||
+			BINARY_LOG_RECORD_HEADER_SIZE + length + BINARY_LOG_RECORD_CRC_SIZE > available) return false;
+
+	const uint8_t *mask = data + BINARY_LOG_RECORD_HEADER_SIZE;
+	size_t expected = maskSize;
+	for (size_t i = 0; i < channels.size(); i++){
+		if (isPopulated(mask, i)) expected += BINARY_LOG_VALUE_SIZE(channels[i].type);
+	}
+	if (hasFixTime(mask, channels)) expected += BINARY_LOG_FIX_TIME_SIZE;
+	if (length != expected) return false;
+
+	uint16_t crc = crc16_ccitt(crcSeed, data + 2, 2 + length);
+	return crc == (uint16_t)unpack(mask + length, 2);
+}
+
+static void writeRecord(std::ostream &out, const uint8_t *mask, const vector<ChannelMeta> &channels){
+	const uint8_t *value = mask + BINARY_LOG_MASK_SIZE(channels.size());
+
+	string line;
+	for (size_t i = 0; i < channels.size(); i++){
+		if (i > 0) line += ",";
+		if (!isPopulated(mask, i)) continue;
+
+		const ChannelMeta &channel = channels[i];
+		char buf[30];
+		switch(channel.type){
+			case BinaryLogValueType_Int64:
+				modp_ltoa10((int64_t)unpack(value, 8), buf);
+				break;
+			case BinaryLogValueType_Float32:
+				modp_ftoa(unpackFloat(value), buf, channel.precision);
+				break;
+			case BinaryLogValueType_Float64:
+				modp_dtoa(unpackDouble(value), buf, channel.precision);
+				break;
+			case BinaryLogValueType_Int32:
+			default:
+				modp_itoa10((int32_t)unpack(value, 4), buf);
+				break;
+		}
+		value += BINARY_LOG_VALUE_SIZE(channel.type);
+		line += buf;
+	}
+
+	if (getFixTimeSampleRate(channels)){
+		line += ",";
+		if (hasFixTime(mask, channels)){
+			char buf[12];
+			modp_itoa10((int32_t)unpack(value, BINARY_LOG_FIX_TIME_SIZE), buf);
+			line += buf;
+		}
+	}
+	out << line << "\n";
+}
+
+int decodeBinaryLog(std::istream &in, std::ostream &out, size_t *skippedBytes){
+	vector<ChannelMeta> channels;
+	uint32_t fileId;
+	if (!readHeader(in, out, channels, fileId)) return -1;
+
+	const vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	const uint16_t crcSeed = BINARY_LOG_CRC_SEED(fileId);
+
+	int records = 0;
+	size_t skipped = 0;
+	size_t pos = 0;
+	while (pos < data.size()){
+		if (!isValidRecord(&data[pos], data.size() - pos, channels, crcSeed)){
+			//not a record of this log; look for the next sync
+			pos++;
+			skipped++;
+			continue;
+		}
+		const uint8_t *mask = &data[pos + BINARY_LOG_RECORD_HEADER_SIZE];
+		writeRecord(out, mask, channels);
+		pos += BINARY_LOG_RECORD_HEADER_SIZE + (size_t)unpack(&data[pos + 2], 2) + BINARY_LOG_RECORD_CRC_SIZE;
+		records++;
+	}
+	if (skippedBytes) *skippedBytes = skipped;
+	return records;
+}
@@ -0,0 +1,24 @@
+/*
+ * binaryLogDecoder.h
+ *
+ * Host side decoder converting a binary log file (see binaryLogFormat.h)
+ * back into the CSV format written by fileWriter.
+ */
+
+#ifndef BINARYLOGDECODER_H_
+#define BINARYLOGDECODER_H_
+
+#include <stddef.h>
+#include <istream>
+#include <ostream>
+
+/**
+ * Decodes a binary log stream and writes the equivalent CSV log.
+ * Bytes that do not frame a valid record, such as a torn record or stale data
+ * past the end of the log, are skipped until the next record sync.
+ * @param skippedBytes if given, receives the number of bytes skipped
+ * @return the number of records decoded, or -1 if the header is invalid.
+ */
+int decodeBinaryLog(std::istream &in, std::ostream &out, size_t *skippedBytes = NULL);
+
+#endif /* BINARYLOGDECODER_H_ */
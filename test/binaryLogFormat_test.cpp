@@ -0,0 +1,192 @@
+/*
+ * binaryLogFormat_test.cpp
+ */
+#include "binaryLogFormat_test.h"
+#include "binaryLogFormat.h"
+#include "binaryLogDecoder.h"
+#include "loggerConfig.h"
+#include "sampleRecord.h"
+#include "mod_string.h"
+#include <sstream>
+#include <string>
+
+using std::string;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( BinaryLogFormatTest );
+
+#define TEST_CHANNEL_COUNT 4
+#define TEST_FILE_ID 0x12345678
+#define RECORD_FRAMING (BINARY_LOG_RECORD_HEADER_SIZE + BINARY_LOG_RECORD_CRC_SIZE)
+
+static string g_encoded;
+
+static ChannelConfig g_configs[TEST_CHANNEL_COUNT] = {
+	{"Interval", "ms", 0, 0, SAMPLE_100Hz, 0, ALWAYS_SAMPLED},
+	{"Utc", "ms", 0, 0, SAMPLE_100Hz, 0, ALWAYS_SAMPLED},
+	{"Battery", "Volts", 0, 20, SAMPLE_1Hz, 2, 0},
+	{"Latitude", "Degrees", -180, 180, SAMPLE_10Hz, 6, 0}
+};
+
+static ChannelSample g_samples[TEST_CHANNEL_COUNT];
+
+static void writeEncoded(const void *data, size_t length){
+	g_encoded.append((const char *)data, length);
+}
+
+void BinaryLogFormatTest::setUp()
+{
+	g_encoded.clear();
+	memset(g_samples, 0, sizeof(g_samples));
+	for (size_t i = 0; i < TEST_CHANNEL_COUNT; i++){
+		g_samples[i].cfg = &g_configs[i];
+		g_samples[i].populated = true;
+	}
+	g_samples[0].sampleData = SampleData_Int_Noarg;
+	g_samples[0].valueInt = 1234;
+	g_samples[1].sampleData = SampleData_LongLong_Noarg;
+	g_samples[1].valueLongLong = 1400000000123LL;
+	g_samples[2].sampleData = SampleData_Float;
+	g_samples[2].valueFloat = 12.5f;
+	g_samples[3].sampleData = SampleData_Double_Noarg;
+	g_samples[3].valueDouble = -45.123456;
+}
+
+void BinaryLogFormatTest::tearDown()
+{
+}
+
+void BinaryLogFormatTest::testHeaderLayout()
+{
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)(BINARY_LOG_PREAMBLE_SIZE + TEST_CHANNEL_COUNT * BINARY_LOG_CHANNEL_META_SIZE), g_encoded.size());
+	CPPUNIT_ASSERT_EQUAL(string(BINARY_LOG_MAGIC), g_encoded.substr(0, BINARY_LOG_MAGIC_LENGTH));
+	CPPUNIT_ASSERT_EQUAL(BINARY_LOG_VERSION, (int)g_encoded[4]);
+	CPPUNIT_ASSERT_EQUAL(TEST_CHANNEL_COUNT, (int)g_encoded[5]);
+	CPPUNIT_ASSERT_EQUAL(0, (int)g_encoded[6]);
+	CPPUNIT_ASSERT_EQUAL(string("\x78\x56\x34\x12"), g_encoded.substr(7, 4));
+	CPPUNIT_ASSERT_EQUAL(string("Interval"), string(g_encoded.c_str() + BINARY_LOG_PREAMBLE_SIZE));
+}
+
+void BinaryLogFormatTest::testRecordOnlyPacksPopulatedChannels()
+{
+	size_t written = binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	CPPUNIT_ASSERT_EQUAL((size_t)(RECORD_FRAMING + 1 + 4 + 8 + 4 + 8), written);
+	CPPUNIT_ASSERT_EQUAL(written, g_encoded.size());
+	CPPUNIT_ASSERT_EQUAL(BINARY_LOG_RECORD_SYNC0, (int)(unsigned char)g_encoded[0]);
+	CPPUNIT_ASSERT_EQUAL(BINARY_LOG_RECORD_SYNC1, (int)(unsigned char)g_encoded[1]);
+	CPPUNIT_ASSERT_EQUAL(1 + 4 + 8 + 4 + 8, (int)g_encoded[2]);
+	CPPUNIT_ASSERT_EQUAL(0x0f, (int)(unsigned char)g_encoded[4]);
+
+	g_encoded.clear();
+	g_samples[2].populated = false;
+	g_samples[3].populated = false;
+	written = binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	CPPUNIT_ASSERT_EQUAL((size_t)(RECORD_FRAMING + 1 + 4 + 8), written);
+	CPPUNIT_ASSERT_EQUAL(0x03, (int)(unsigned char)g_encoded[4]);
+}
+
+void BinaryLogFormatTest::testDecodeToCsv()
+{
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	g_samples[2].populated = false;
+	g_samples[0].valueInt = 1244;
+	g_samples[3].valueDouble = -45.5;
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+
+	std::istringstream in(g_encoded);
+	std::ostringstream out;
+	CPPUNIT_ASSERT_EQUAL(2, decodeBinaryLog(in, out));
+
+	string expected =
+			"\"Interval\"|\"ms\"|0|0|100,\"Utc\"|\"ms\"|0|0|100,"
+			"\"Battery\"|\"Volts\"|0.0|20.0|1,\"Latitude\"|\"Degrees\"|-180.0|180.0|10\n"
+			"1234,1400000000123,12.5,-45.123456\n"
+			"1244,1400000000123,,-45.5\n";
+	CPPUNIT_ASSERT_EQUAL(expected, out.str());
+}
+
+void BinaryLogFormatTest::testDecodeFixTime()
+{
+	g_samples[3].fixTimestamped = true;
+	g_samples[3].fixUptime = 5000;
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	const size_t latitudeType = BINARY_LOG_PREAMBLE_SIZE + 4 * BINARY_LOG_CHANNEL_META_SIZE - 1;
+	CPPUNIT_ASSERT_EQUAL(BinaryLogValueType_Float64 | BINARY_LOG_FIX_TIMESTAMPED, (int)(unsigned char)g_encoded[latitudeType]);
+
+	const size_t headerSize = g_encoded.size();
+	size_t written = binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	CPPUNIT_ASSERT_EQUAL((size_t)(RECORD_FRAMING + 1 + 4 + 8 + 4 + 8 + BINARY_LOG_FIX_TIME_SIZE), written);
+	CPPUNIT_ASSERT_EQUAL(string("\x88\x13\x00\x00", 4), g_encoded.substr(headerSize + written - 6, 4));
+
+	//no GPS value, so no fix time
+	g_samples[3].populated = false;
+	written = binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	CPPUNIT_ASSERT_EQUAL((size_t)(RECORD_FRAMING + 1 + 4 + 8 + 4), written);
+
+	std::istringstream in(g_encoded);
+	std::ostringstream out;
+	CPPUNIT_ASSERT_EQUAL(2, decodeBinaryLog(in, out));
+
+	string expected =
+			"\"Interval\"|\"ms\"|0|0|100,\"Utc\"|\"ms\"|0|0|100,"
+			"\"Battery\"|\"Volts\"|0.0|20.0|1,\"Latitude\"|\"Degrees\"|-180.0|180.0|10,"
+			"\"GPSFix\"|\"ms\"|0|0|10\n"
+			"1234,1400000000123,12.5,-45.123456,5000\n"
+			"1234,1400000000123,12.5,,\n";
+	CPPUNIT_ASSERT_EQUAL(expected, out.str());
+}
+
+void BinaryLogFormatTest::testDecodeTruncatedRecord()
+{
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	g_encoded.resize(g_encoded.size() - 3);
+
+	std::istringstream in(g_encoded);
+	std::ostringstream out;
+	CPPUNIT_ASSERT_EQUAL(1, decodeBinaryLog(in, out));
+}
+
+void BinaryLogFormatTest::testDecodeSkipsCorruptRecords()
+{
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	const size_t corrupt = g_encoded.size() + BINARY_LOG_RECORD_HEADER_SIZE + 2;
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	g_encoded[corrupt] ^= 0x40;
+	//garbage that looks like the start of a record
+	g_encoded += string("\xa5\x5a\x03\x00\xff", 5);
+	g_samples[0].valueInt = 1244;
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+
+	std::istringstream in(g_encoded);
+	std::ostringstream out;
+	size_t skipped = 0;
+	CPPUNIT_ASSERT_EQUAL(2, decodeBinaryLog(in, out, &skipped));
+	CPPUNIT_ASSERT_EQUAL((size_t)(RECORD_FRAMING + 25 + 5), skipped);
+	CPPUNIT_ASSERT(out.str().find("1244,1400000000123") != string::npos);
+}
+
+void BinaryLogFormatTest::testDecodeIgnoresStaleRecords()
+{
+	binary_log_write_header(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID);
+	//the tail of a pre-allocated file still holding an older log's records
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID + 1);
+	binary_log_write_record(writeEncoded, g_samples, TEST_CHANNEL_COUNT, TEST_FILE_ID + 1);
+
+	std::istringstream in(g_encoded);
+	std::ostringstream out;
+	CPPUNIT_ASSERT_EQUAL(1, decodeBinaryLog(in, out));
+}
+
+void BinaryLogFormatTest::testDecodeInvalidHeader()
+{
+	std::istringstream in(string("\"Interval\"|\"ms\"|0|0|100\n"));
+	std::ostringstream out;
+	CPPUNIT_ASSERT_EQUAL(-1, decodeBinaryLog(in, out));
+}
@@ -0,0 +1,37 @@
+/*
+ * binaryLogFormat_test.h
+ */
+
+#ifndef BINARYLOGFORMAT_TEST_H_
+#define BINARYLOGFORMAT_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class BinaryLogFormatTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( BinaryLogFormatTest );
+  CPPUNIT_TEST( testHeaderLayout );
+  CPPUNIT_TEST( testRecordOnlyPacksPopulatedChannels );
+  CPPUNIT_TEST( testDecodeToCsv );
+  CPPUNIT_TEST( testDecodeFixTime );
+  CPPUNIT_TEST( testDecodeTruncatedRecord );
+  CPPUNIT_TEST( testDecodeSkipsCorruptRecords );
+  CPPUNIT_TEST( testDecodeIgnoresStaleRecords );
+  CPPUNIT_TEST( testDecodeInvalidHeader );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testHeaderLayout();
+  void testRecordOnlyPacksPopulatedChannels();
+  void testDecodeToCsv();
+  void testDecodeFixTime();
+  void testDecodeTruncatedRecord();
+  void testDecodeSkipsCorruptRecords();
+  void testDecodeIgnoresStaleRecords();
+  void testDecodeInvalidHeader();
+};
+
+#endif /* BINARYLOGFORMAT_TEST_H_ */
@@ -11,6 +11,12 @@
 #define MAX_TRACKS				240
 #define MAX_SECTORS				20
 #define SCRIPT_MEMORY_LENGTH	10240
+#define PREDICTIVE_TIMER_SAMPLES	2048
+#define REFERENCE_LAP_FLASH_SIZE	131072
+#define LUA_ARENA_SIZE			49152
+#define LUA_HEAP_RESERVE		16384
+#define SCRIPT_BYTECODE_LENGTH	32768
+#define LOGGER_MESSAGE_BUFFER_LIMIT	32
 #define MAX_VIRTUAL_CHANNELS	10
 
 //Input / output Channels
@@ -0,0 +1,107 @@
+/*
+ * channelPlan_bench.cpp
+ *
+ * Compares sampling through the config lookup getters (get_analog_sample
+ * etc.) with the planned getters bound by init_channel_sample_buffer.
+ */
+#include "benchmark.h"
+#include "ADC.h"
+#include "gps.h"
+#include "loggerConfig.h"
+#include "loggerHardware.h"
+#include "loggerSampleData.test.h"
+#include "sampleRecord.h"
+#include <stdlib.h>
+
+#define BENCHMARK_TICKS		1000000
+#define BENCHMARK_ROUNDS	5
+
+static void configureChannels(LoggerConfig *lc){
+	const unsigned char scalingModes[] = {SCALING_MODE_RAW, SCALING_MODE_LINEAR, SCALING_MODE_MAP};
+	for (size_t i = 0; i < CONFIG_ADC_CHANNELS; i++){
+		lc->ADCConfigs[i].cfg.sampleRate = SAMPLE_100Hz;
+		lc->ADCConfigs[i].scalingMode = scalingModes[i % 3];
+	}
+	for (size_t i = 0; i < CONFIG_IMU_CHANNELS; i++){
+		lc->ImuConfigs[i].cfg.sampleRate = SAMPLE_100Hz;
+	}
+	for (size_t i = 0; i < CONFIG_TIMER_CHANNELS; i++){
+		lc->TimerConfigs[i].cfg.sampleRate = SAMPLE_100Hz;
+	}
+}
+
+/*
+ * Rebinds planned samples to the getters that look their config up on
+ * every call, reproducing the buffer as it was built before sample plans.
+ */
+static void useConfigLookupGetters(LoggerConfig *lc, ChannelSample *samples, size_t count){
+	for (size_t i = 0; i < count; i++){
+		ChannelSample *s = samples + i;
+		if (s->sampleData != SampleData_Float_Planned) continue;
+
+		const size_t index = s->channelIndex;
+		s->sampleData = SampleData_Float;
+		if (index < CONFIG_ADC_CHANNELS && s->cfg == &lc->ADCConfigs[index].cfg){
+			s->get_float_sample = get_analog_sample;
+		} else if (index < CONFIG_IMU_CHANNELS && s->cfg == &lc->ImuConfigs[index].cfg){
+			s->get_float_sample = get_imu_sample;
+		} else if (index < CONFIG_TIMER_CHANNELS && s->cfg == &lc->TimerConfigs[index].cfg){
+			s->get_float_sample = get_timer_sample;
+		} else {
+			s->get_float_sample = get_pwm_sample;
+		}
+	}
+}
+
+static double timeSampling(LoggerMessage *msg, const SampleSchedule *schedule){
+	double start = benchmarkSeconds();
+	for (size_t tick = 0; tick < BENCHMARK_TICKS; tick++){
+		populate_scheduled_sample_buffer(msg, schedule, 0);
+	}
+	return benchmarkSeconds() - start;
+}
+
+static LoggerMessage createMessage(LoggerConfig *lc, size_t channelCount){
+	LoggerMessage msg;
+	msg.channelSamples = create_channel_sample_buffer(lc, channelCount);
+	init_channel_sample_buffer(lc, msg.channelSamples, channelCount);
+	return msg;
+}
+
+void benchmarkChannelPlan(){
+	InitLoggerHardware();
+	initGPS();
+	initialize_logger_config();
+
+	LoggerConfig *lc = getWorkingLoggerConfig();
+	configureChannels(lc);
+	ADC_sample_all();
+	size_t channelCount = get_enabled_channel_count(lc);
+	printf("channel plan: %u channels sampled every tick, %u ticks\n", (unsigned int)channelCount, (unsigned int)BENCHMARK_TICKS);
+
+	LoggerMessage planned = createMessage(lc, channelCount);
+	LoggerMessage lookup = createMessage(lc, channelCount);
+	useConfigLookupGetters(lc, lookup.channelSamples, channelCount);
+	SampleSchedule schedule;
+	init_sample_schedule(&schedule, planned.channelSamples, channelCount);
+
+	//alternate the two and keep the best round of each to damp host noise
+	double plannedSeconds = 0;
+	double lookupSeconds = 0;
+	for (size_t round = 0; round < BENCHMARK_ROUNDS; round++){
+		double seconds = timeSampling(&lookup, &schedule);
+		if (round == 0 || seconds < lookupSeconds) lookupSeconds = seconds;
+		seconds = timeSampling(&planned, &schedule);
+		if (round == 0 || seconds < plannedSeconds) plannedSeconds = seconds;
+	}
+
+	benchmarkReport("config lookup getters", BENCHMARK_TICKS, lookupSeconds, "ticks");
+	benchmarkReport("planned getters", BENCHMARK_TICKS, plannedSeconds, "ticks");
+	printf("ns/tick: %.1f -> %.1f, speedup: %.2fx\n",
+			lookupSeconds * 1e9 / BENCHMARK_TICKS, plannedSeconds * 1e9 / BENCHMARK_TICKS,
+			lookupSeconds / plannedSeconds);
+
+	free_sample_schedule(&schedule);
+	free(planned.channelSamples);
+	free(lookup.channelSamples);
+}
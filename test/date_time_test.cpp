@@ -158,6 +158,32 @@ void DateTimeTest::testGetMillisSinceEpoch() {
 
 }
 
+static void assertDateTimeEquals(const DateTime exp, const DateTime act) {
+   CPPUNIT_ASSERT_EQUAL(exp.millisecond, act.millisecond);
+   CPPUNIT_ASSERT_EQUAL(exp.second, act.second);
+   CPPUNIT_ASSERT_EQUAL(exp.minute, act.minute);
+   CPPUNIT_ASSERT_EQUAL(exp.hour, act.hour);
+   CPPUNIT_ASSERT_EQUAL(exp.day, act.day);
+   CPPUNIT_ASSERT_EQUAL(exp.month, act.month);
+   CPPUNIT_ASSERT_EQUAL(exp.year, act.year);
+}
+
+void DateTimeTest::testDateTimeFromMillisSinceEpoch() {
+   const DateTime epoch = {0, 0, 0, 0, 1, 1, 1970};
+   assertDateTimeEquals(epoch, getDateTimeFromMillisecondsSinceUnixEpoch(0));
+
+   // 2016, Feb 29 @ 23:59:59.999
+   const DateTime leapDay = {999, 59, 59, 23, 29, 2, 2016};
+   assertDateTimeEquals(leapDay, getDateTimeFromMillisecondsSinceUnixEpoch(1456790399999ll));
+
+   // Round trip a spread of times through both conversions.
+   for (millis_t ms = 0; ms < 4102444800000ll; ms += 86399999ll * 7) {
+      const DateTime dt = getDateTimeFromMillisecondsSinceUnixEpoch(ms);
+      CPPUNIT_ASSERT(isValidDateTime(dt));
+      CPPUNIT_ASSERT_EQUAL(ms, getMillisecondsSinceUnixEpoch(dt));
+   }
+}
+
 void DateTimeTest::testGetDeltaInMillis() {
   const DateTime epoch = {0, 0, 0, 0, 1, 1, 1970};
   const DateTime d1000000 = {0, 40, 16, 0, 1, 1, 1970};
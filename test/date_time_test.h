@@ -30,6 +30,7 @@ class DateTimeTest : public CppUnit::TestFixture
    CPPUNIT_TEST( testDaysInMonth );
    CPPUNIT_TEST( testIsValidDateTime );
    CPPUNIT_TEST( testGetMillisSinceEpoch );
+   CPPUNIT_TEST( testDateTimeFromMillisSinceEpoch );
    CPPUNIT_TEST( testMillisToMinutes );
    CPPUNIT_TEST( testMillisToSeconds );
    CPPUNIT_TEST( testTinyMillisToMinutes );
@@ -46,6 +47,7 @@ class DateTimeTest : public CppUnit::TestFixture
    void testDaysInMonth();
    void testIsValidDateTime();
    void testGetMillisSinceEpoch();
+   void testDateTimeFromMillisSinceEpoch();
    void testGetDeltaInMillis();
    void testMillisToMinutes();
    void testMillisToSeconds();
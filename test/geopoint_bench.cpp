@@ -0,0 +1,85 @@
+/*
+ * geopoint_bench.cpp
+ *
+ * Times distance comparisons between fixes the way the lap timing code
+ * makes them: finding the closest of a lap's worth of recorded points,
+ * with distPythag and with squared distances in a GeoProjection.
+ */
+#include "benchmark.h"
+#include "geopoint.h"
+#include <math.h>
+#include <vector>
+
+using std::vector;
+
+#define LAP_POINTS			96
+#define BENCHMARK_FIXES		20000
+
+static int closestPythag(const GeoPoint *points, const GeoPoint *p){
+	int best = 0;
+	float lowest = distPythag(p, points);
+	for (int i = 1; i < LAP_POINTS; i++){
+		float distance = distPythag(p, points + i);
+		if (distance < lowest){
+			lowest = distance;
+			best = i;
+		}
+	}
+	return best;
+}
+
+static int closestProjected(const GeoProjection *proj, const GeoPoint *points, const GeoPoint *p){
+	int best = 0;
+	float lowest = distSquaredProjected(proj, p, points);
+	for (int i = 1; i < LAP_POINTS; i++){
+		float distance = distSquaredProjected(proj, p, points + i);
+		if (distance < lowest){
+			lowest = distance;
+			best = i;
+		}
+	}
+	return best;
+}
+
+void benchmarkGeoPoint(){
+	/* a 3km loop sampled evenly, and fixes taken around it */
+	GeoPoint lap[LAP_POINTS];
+	for (int i = 0; i < LAP_POINTS; i++){
+		float angle = i * 6.2831853f / LAP_POINTS;
+		lap[i].latitude = 47.8f + 0.0043f * sinf(angle);
+		lap[i].longitude = -122.34f + 0.0064f * cosf(angle);
+	}
+	vector<GeoPoint> fixes(BENCHMARK_FIXES);
+	for (int i = 0; i < BENCHMARK_FIXES; i++){
+		float angle = i * 6.2831853f / 997;
+		fixes[i].latitude = 47.8f + 0.00431f * sinf(angle);
+		fixes[i].longitude = -122.34f + 0.00638f * cosf(angle);
+	}
+	printf("geopoint: closest of %d points for %d fixes\n", LAP_POINTS, BENCHMARK_FIXES);
+
+	vector<int> closest(BENCHMARK_FIXES);
+	double start = benchmarkSeconds();
+	for (int i = 0; i < BENCHMARK_FIXES; i++){
+		closest[i] = closestPythag(lap, &fixes[i]);
+	}
+	benchmarkReport("closest point by distPythag", BENCHMARK_FIXES, benchmarkSeconds() - start, "fixes");
+
+	vector<int> closestProj(BENCHMARK_FIXES);
+	start = benchmarkSeconds();
+	const GeoProjection proj = createGeoProjection(lap);
+	for (int i = 0; i < BENCHMARK_FIXES; i++){
+		closestProj[i] = closestProjected(&proj, lap, &fixes[i]);
+	}
+	benchmarkReport("closest point by distSquaredProjected", BENCHMARK_FIXES, benchmarkSeconds() - start, "fixes");
+
+	/* where the two disagree, how much closer distPythag says its choice is */
+	int differ = 0;
+	float worst = 0;
+	for (int i = 0; i < BENCHMARK_FIXES; i++){
+		if (closestProj[i] == closest[i]) continue;
+		differ++;
+		float margin = distPythag(&fixes[i], lap + closestProj[i]) - distPythag(&fixes[i], lap + closest[i]);
+		if (margin > worst) worst = margin;
+	}
+	printf("geopoint: %d closest points differ, by at most %.3f m\n", differ, worst);
+}
@@ -19,8 +19,12 @@
  */
 
 #include "gps_test.h"
+#include "geoCircle.h"
 #include "gps.h"
+#include "nmea.h"
 #include "mod_string.h"
+#include "task.h"
+#include <math.h>
 
 // Registers the fixture into the 'registry'
 CPPUNIT_TEST_SUITE_REGISTRATION( GpsTest );
@@ -34,16 +38,24 @@ void GpsTest::setUp() {
 void GpsTest::tearDown() {}
 
 
+static int checksumValid(const char *gpsData) {
+	// the tokenizer splits the sentence in place
+	char sentence[100];
+	strcpy(sentence, gpsData);
+	NmeaSentence nmea;
+	return nmea_tokenize(sentence, strlen(sentence), &nmea);
+}
+
 void GpsTest::testChecksum() {
 	const char *goodGpsData = "$GPGLL,5300.97914,N,00259.98174,E,125926,A*28";
 	const char *goodGpsData2 = "$GPGLL,5300.97914,N,00259.98174,E,125926,A*28                  ";
 	const char *goodGpsData3 = "$GPGSA,M,3,12,17,04,25,29,10,,,,,,,2.45,1.89,1.56*03";
 	const char *badGpsData = "$GPGLL,5300.97914,N,00259.98174,E,125926,A*29"; //bad checksum
 
-	CPPUNIT_ASSERT(checksumValid(goodGpsData, strlen(goodGpsData)) == 1);
-	CPPUNIT_ASSERT(checksumValid(goodGpsData2, strlen(goodGpsData2)) == 1);
-	CPPUNIT_ASSERT(checksumValid(goodGpsData3, strlen(goodGpsData3)) == 1);
-	CPPUNIT_ASSERT(checksumValid(badGpsData, strlen(badGpsData)) == 0);
+	CPPUNIT_ASSERT(checksumValid(goodGpsData) == 1);
+	CPPUNIT_ASSERT(checksumValid(goodGpsData2) == 1);
+	CPPUNIT_ASSERT(checksumValid(goodGpsData3) == 1);
+	CPPUNIT_ASSERT(checksumValid(badGpsData) == 0);
 }
 
 void GpsTest::testGpsDistance() {
@@ -52,3 +64,122 @@ void GpsTest::testGpsDistance() {
     CPPUNIT_ASSERT_EQUAL((float) 1.0, getGpsDistanceKms());
     CPPUNIT_ASSERT_EQUAL((float) (1.0f * KMS_TO_MILES_CONSTANT), getGpsDistanceMiles());
 }
+
+void GpsTest::testNavData() {
+	// 1.5 m/s east and 2 m/s north at 45N 90W while climbing at 0.5 m/s;
+	// there east is +X, north is (0, r, r) and up is (0, -r, r)
+	const float r = 0.70710678f;
+	GpsNavData nav;
+	nav.quality = GPS_QUALITY_FIX;
+	nav.satellites = 9;
+	nav.latitude = 450000000;
+	nav.longitude = -900000000;
+	nav.ecefVelocity[0] = 150;
+	nav.ecefVelocity[1] = (int32_t) (r * 200 - r * 50);
+	nav.ecefVelocity[2] = (int32_t) (r * 200 + r * 50);
+	nav.utcMillis = 1456790399999ll;
+	processGPSNavData(&nav);
+
+	CPPUNIT_ASSERT_EQUAL(GPS_QUALITY_FIX, getGPSQuality());
+	CPPUNIT_ASSERT_EQUAL(9, getSatellitesUsedForPosition());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(45.0, getLatitude(), 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-90.0, getLongitude(), 0.000001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5 * 3.6, getGPSSpeed(), 0.05);
+	CPPUNIT_ASSERT_EQUAL(1456790399999ll, getMillisSinceEpoch());
+}
+
+void GpsTest::testExtrapolatedFix() {
+	GpsNavData nav;
+	memset(&nav, 0, sizeof(nav));
+	nav.quality = GPS_QUALITY_FIX;
+	nav.latitude = 450000000;
+	nav.longitude = -900000000;
+	nav.utcMillis = 1456790399000ll;
+
+	// a single fix is held as it is
+	resetTicks();
+	processGPSNavData(&nav);
+	incrementTick();
+	CPPUNIT_ASSERT_EQUAL(getLatitude(), getExtrapolatedLatitude());
+	CPPUNIT_ASSERT_EQUAL((tiny_millis_t) 0, getUptimeAtSample());
+
+	// fixes 100ms apart, moving north east; a float latitude is good to about 4e-6
+	for (int i = 1; i < 20; i++) incrementTick();
+	nav.latitude += 1000;
+	nav.longitude += 2000;
+	nav.utcMillis += 100;
+	processGPSNavData(&nav);
+	CPPUNIT_ASSERT_EQUAL((tiny_millis_t) 100, getUptimeAtSample());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(45.0001, getExtrapolatedLatitude(), 0.00001);
+
+	// half way to the next fix
+	for (int i = 0; i < 10; i++) incrementTick();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(45.00015, getExtrapolatedLatitude(), 0.00001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-89.9997, getExtrapolatedLongitude(), 0.00001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(45.0001, getLatitude(), 0.00001);
+
+	// no further than one interval past a late fix
+	for (int i = 0; i < 100; i++) incrementTick();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(45.0002, getExtrapolatedLatitude(), 0.00001);
+}
+
+void GpsTest::testGeoCirclePass() {
+	// Heading east along a line of latitude, fixes 0.0001 degrees apart
+	// with the center 0.3 of the way between the third and fourth.
+	const GeoPoint center = {47.80005, -122.33977};
+	const struct GeoCircle gc = gc_createGeoCircle(center, 15);
+	struct GeoCirclePass pass;
+	gc_resetPass(&pass);
+
+	float crossings[8];
+	GeoPoint from = {0, 0};
+	for (int i = 0; i < 8; i++) {
+		const GeoPoint to = {47.8, -122.3400f + 0.0001f * i};
+		crossings[i] = gc_updatePass(&pass, gc, from, to);
+		from = to;
+	}
+
+	for (int i = 0; i < 8; i++) {
+		if (i == 3)
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.3, crossings[i], 0.02);
+		else
+			CPPUNIT_ASSERT(crossings[i] < 0);
+	}
+
+	// Driving back through starts a new pass, crossing it once more.
+	int count = 0;
+	for (int i = 7; i >= 0; i--) {
+		const GeoPoint to = {47.8, -122.3400f + 0.0001f * i};
+		if (gc_updatePass(&pass, gc, from, to) >= 0)
+			count++;
+		from = to;
+	}
+	CPPUNIT_ASSERT_EQUAL(1, count);
+}
+
+void GpsTest::testGeoProjectionAccuracy() {
+	// Points up to 2km apart in all directions, from the equator to 65 degrees.
+	for (int lat = -65; lat <= 65; lat += 5) {
+		const GeoPoint a = {lat + 0.123f, -122.3f + lat};
+		const GeoProjection proj = createGeoProjection(&a);
+
+		for (int bearing = 0; bearing < 360; bearing += 15) {
+			const float meters = 50.0f + bearing * 5;
+			const float rad = bearing * 0.0174532925f;
+			const GeoPoint b = {
+				a.latitude + meters * cosf(rad) / GP_METERS_PER_DEGREE,
+				a.longitude + meters * sinf(rad) / (GP_METERS_PER_DEGREE * cosf(a.latitude * 0.0174532925f))
+			};
+
+			const float expected = distPythag(&a, &b);
+			const float actual = sqrtf(distSquaredProjected(&proj, &a, &b));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, 0.3 + expected * 0.0005);
+
+			// Distances measured away from the origin stay close too.
+			const GeoPoint c = {b.latitude + 0.001f, b.longitude};
+			const float expectedBC = distPythag(&b, &c);
+			const float actualBC = sqrtf(distSquaredProjected(&proj, &b, &c));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedBC, actualBC, 0.3 + expectedBC * 0.001);
+		}
+	}
+}
@@ -29,6 +29,10 @@ class GpsTest : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE( GpsTest );
   CPPUNIT_TEST( testChecksum );
   CPPUNIT_TEST( testGpsDistance );
+  CPPUNIT_TEST( testNavData );
+  CPPUNIT_TEST( testExtrapolatedFix );
+  CPPUNIT_TEST( testGeoCirclePass );
+  CPPUNIT_TEST( testGeoProjectionAccuracy );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +41,10 @@ public:
 
   void testChecksum();
   void testGpsDistance();
+  void testNavData();
+  void testExtrapolatedFix();
+  void testGeoCirclePass();
+  void testGeoProjectionAccuracy();
 };
 
 #endif  // NUMTOATEST_H
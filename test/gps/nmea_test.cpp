@@ -0,0 +1,93 @@
+/*
+ * nmea_test.cpp
+ */
+#include "nmea_test.h"
+#include "nmea.h"
+#include "gps.h"
+#include "mod_string.h"
+#include <string>
+
+using std::string;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( NmeaTest );
+
+#define RMC_SENTENCE "$GPRMC,053740.000,A,2503.6319,N,12136.0099,E,2.69,79.65,100106,,,A*53\r\n"
+
+void NmeaTest::setUp() {
+	initGPS();
+}
+
+void NmeaTest::tearDown() {}
+
+void NmeaTest::testTokenize() {
+	char sentence[] = RMC_SENTENCE;
+	NmeaSentence nmea;
+
+	CPPUNIT_ASSERT_EQUAL(1, nmea_tokenize(sentence, strlen(sentence), &nmea));
+	CPPUNIT_ASSERT_EQUAL('G', nmea.talker[0]);
+	CPPUNIT_ASSERT_EQUAL('P', nmea.talker[1]);
+	CPPUNIT_ASSERT_EQUAL(NMEA_TYPE('R', 'M', 'C'), nmea.type);
+	CPPUNIT_ASSERT_EQUAL((size_t)12, nmea.fieldCount);
+	CPPUNIT_ASSERT_EQUAL(string("053740.000"), string(nmea_field(&nmea, 0)));
+	CPPUNIT_ASSERT_EQUAL(string("2503.6319"), string(nmea_field(&nmea, 2)));
+	CPPUNIT_ASSERT_EQUAL(string("E"), string(nmea_field(&nmea, 5)));
+	CPPUNIT_ASSERT_EQUAL(string("100106"), string(nmea_field(&nmea, 8)));
+	CPPUNIT_ASSERT_EQUAL(string("A"), string(nmea_field(&nmea, 11)));
+	CPPUNIT_ASSERT_EQUAL(string(""), string(nmea_field(&nmea, 12)));
+}
+
+void NmeaTest::testTokenizeEmptyFields() {
+	char sentence[] = "$GPGSA,M,3,12,17,04,25,29,10,,,,,,,2.45,1.89,1.56*03";
+	NmeaSentence nmea;
+
+	CPPUNIT_ASSERT_EQUAL(1, nmea_tokenize(sentence, strlen(sentence), &nmea));
+	CPPUNIT_ASSERT_EQUAL(NMEA_TYPE('G', 'S', 'A'), nmea.type);
+	CPPUNIT_ASSERT_EQUAL((size_t)17, nmea.fieldCount);
+	CPPUNIT_ASSERT_EQUAL(string(""), string(nmea_field(&nmea, 8)));
+	CPPUNIT_ASSERT_EQUAL(string("1.56"), string(nmea_field(&nmea, 16)));
+}
+
+void NmeaTest::testRejectsCorruptSentence() {
+	NmeaSentence nmea;
+	const char *original = "$GPGLL,5300.97914,N,00259.98174,E,125926,A*29";
+	char badChecksum[64];
+	strcpy(badChecksum, original);
+	CPPUNIT_ASSERT_EQUAL(0, nmea_tokenize(badChecksum, strlen(badChecksum), &nmea));
+	//a rejected sentence is left intact for logging
+	CPPUNIT_ASSERT_EQUAL(string(original), string(badChecksum));
+
+	char truncated[] = "$GPGLL,5300.97914,N,00259.98174,E,125926,A*2";
+	CPPUNIT_ASSERT_EQUAL(0, nmea_tokenize(truncated, strlen(truncated), &nmea));
+
+	char noChecksum[] = "$GPGLL,5300.97914,N,00259.98174,E,125926,A\r\n";
+	CPPUNIT_ASSERT_EQUAL(0, nmea_tokenize(noChecksum, strlen(noChecksum), &nmea));
+
+	char badAddress[] = "$GPGL,5300.97914*2A";
+	CPPUNIT_ASSERT_EQUAL(0, nmea_tokenize(badAddress, strlen(badAddress), &nmea));
+}
+
+void NmeaTest::testParseCoordinate() {
+	CPPUNIT_ASSERT_EQUAL((int32_t)250605317, nmea_parse_coordinate("2503.6319", 2));
+	CPPUNIT_ASSERT_EQUAL((int32_t)1216001650, nmea_parse_coordinate("12136.0099", 3));
+	CPPUNIT_ASSERT_EQUAL((int32_t)1793333333, nmea_parse_coordinate("17919.9999999", 3));
+	CPPUNIT_ASSERT_EQUAL((int32_t)0, nmea_parse_coordinate("", 2));
+	CPPUNIT_ASSERT_EQUAL((int32_t)450000000, nmea_parse_coordinate("4500", 2));
+}
+
+void NmeaTest::testProcessRMC() {
+	char sentence[] = "$GPRMC,053740.000,A,2503.6319,S,12136.0099,W,2.69,79.65,100106,,,A*5C\r\n";
+	processGPSData(sentence, strlen(sentence));
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-25.0605317, getLatitude(), 0.000002);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-121.6001650, getLongitude(), 0.00001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.69 * KNOTS_TO_KPH, getGPSSpeed(), 0.0001);
+
+	DateTime dt = getLastFixDateTime();
+	CPPUNIT_ASSERT_EQUAL(5, (int)dt.hour);
+	CPPUNIT_ASSERT_EQUAL(37, (int)dt.minute);
+	CPPUNIT_ASSERT_EQUAL(40, (int)dt.second);
+	CPPUNIT_ASSERT_EQUAL(10, (int)dt.day);
+	CPPUNIT_ASSERT_EQUAL(1, (int)dt.month);
+	CPPUNIT_ASSERT_EQUAL(2006, (int)dt.year);
+}
@@ -0,0 +1,31 @@
+/*
+ * nmea_test.h
+ */
+
+#ifndef NMEA_TEST_H_
+#define NMEA_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class NmeaTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( NmeaTest );
+  CPPUNIT_TEST( testTokenize );
+  CPPUNIT_TEST( testTokenizeEmptyFields );
+  CPPUNIT_TEST( testRejectsCorruptSentence );
+  CPPUNIT_TEST( testParseCoordinate );
+  CPPUNIT_TEST( testProcessRMC );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testTokenize();
+  void testTokenizeEmptyFields();
+  void testRejectsCorruptSentence();
+  void testParseCoordinate();
+  void testProcessRMC();
+};
+
+#endif /* NMEA_TEST_H_ */
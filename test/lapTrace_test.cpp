@@ -0,0 +1,143 @@
+/*
+ * lapTrace_test.cpp
+ */
+#include "lapTrace_test.h"
+#include "lapTrace.h"
+#include "geopoint.h"
+#include <math.h>
+#include <vector>
+
+using std::vector;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LapTraceTest );
+
+static const GeoPoint origin = {47.254723f, -123.191002f};
+
+/* the point x, y meters from the origin of trace */
+static GeoPoint offsetPoint(const LapTrace *trace, float x, float y) {
+	GeoPoint p;
+	p.latitude = origin.latitude + y / GP_METERS_PER_DEGREE;
+	p.longitude = origin.longitude + x / trace->projection.metersPerDegreeLongitude;
+	return p;
+}
+
+static void assertAt(const LapTrace *trace, const LapTraceCursor *cursor, const GeoPoint *point,
+		tiny_millis_t time) {
+	float px, py, cx, cy;
+	lap_trace_project(trace, point, &px, &py);
+	lap_trace_position(cursor, &cx, &cy);
+	CPPUNIT_ASSERT(fabsf(px - cx) < 0.2f);
+	CPPUNIT_ASSERT(fabsf(py - cy) < 0.2f);
+	CPPUNIT_ASSERT_EQUAL(time, cursor->time);
+}
+
+void LapTraceTest::setUp()
+{
+}
+
+void LapTraceTest::tearDown()
+{
+}
+
+void LapTraceTest::testWalksBothWays()
+{
+	LapTraceSample samples[100];
+	LapTrace trace;
+	lap_trace_init(&trace, samples, 100, &origin);
+
+	vector<GeoPoint> points;
+	for (int i = 1; i < 100; i++){
+		points.push_back(offsetPoint(&trace, 300 * sinf(i * 0.05f), 300 - 300 * cosf(i * 0.05f)));
+		CPPUNIT_ASSERT(lap_trace_append(&trace, &points.back(), i * 333));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 100, trace.count);
+
+	LapTraceCursor cursor;
+	lap_trace_first(&trace, &cursor);
+	CPPUNIT_ASSERT(!lap_trace_prev(&trace, &cursor));
+	assertAt(&trace, &cursor, &origin, 0);
+	for (int i = 1; i < 100; i++){
+		CPPUNIT_ASSERT(lap_trace_next(&trace, &cursor));
+		assertAt(&trace, &cursor, &points[i - 1], i * 333);
+	}
+	CPPUNIT_ASSERT(!lap_trace_next(&trace, &cursor));
+
+	for (int i = 98; i > 0; i--){
+		CPPUNIT_ASSERT(lap_trace_prev(&trace, &cursor));
+		assertAt(&trace, &cursor, &points[i - 1], i * 333);
+	}
+	CPPUNIT_ASSERT(lap_trace_prev(&trace, &cursor));
+	assertAt(&trace, &cursor, &origin, 0);
+}
+
+void LapTraceTest::testSplitsLargeSteps()
+{
+	LapTraceSample samples[20];
+	LapTrace trace;
+	lap_trace_init(&trace, samples, 20, &origin);
+
+	// 100m east is four steps of 25m; a long stop is split by time.
+	GeoPoint east = offsetPoint(&trace, 100, 0);
+	CPPUNIT_ASSERT(lap_trace_append(&trace, &east, 1000));
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, trace.count);
+	CPPUNIT_ASSERT(lap_trace_append(&trace, &east, 1000 + 3 * LAP_TRACE_MAX_TIME_STEP));
+	CPPUNIT_ASSERT_EQUAL((size_t) 8, trace.count);
+	CPPUNIT_ASSERT(fabsf(lap_trace_dist_squared_to_last(&trace, &east)) < 0.01f);
+
+	// Evenly along the way to where east landed; a float longitude is only good to about 0.5m.
+	float ex, ey;
+	lap_trace_project(&trace, &east, &ex, &ey);
+	LapTraceCursor cursor;
+	lap_trace_first(&trace, &cursor);
+	for (int i = 1; i <= 4; i++){
+		CPPUNIT_ASSERT(lap_trace_next(&trace, &cursor));
+		float cx, cy;
+		lap_trace_position(&cursor, &cx, &cy);
+		CPPUNIT_ASSERT(fabsf(ex * i / 4 - cx) < 0.2f);
+		CPPUNIT_ASSERT(fabsf(ey * i / 4 - cy) < 0.2f);
+		CPPUNIT_ASSERT_EQUAL((tiny_millis_t) (250 * i), cursor.time);
+	}
+	while (lap_trace_next(&trace, &cursor));
+	assertAt(&trace, &cursor, &east, 1000 + 3 * LAP_TRACE_MAX_TIME_STEP);
+}
+
+void LapTraceTest::testFullTraceIsUnchanged()
+{
+	LapTraceSample samples[3];
+	LapTrace trace;
+	lap_trace_init(&trace, samples, 3, &origin);
+
+	GeoPoint near = offsetPoint(&trace, 10, 10);
+	GeoPoint far = offsetPoint(&trace, 100, 10);
+	CPPUNIT_ASSERT(lap_trace_append(&trace, &near, 1000));
+	CPPUNIT_ASSERT(!lap_trace_append(&trace, &far, 2000));
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, trace.count);
+	CPPUNIT_ASSERT_EQUAL((tiny_millis_t) 1000, trace.time);
+	CPPUNIT_ASSERT(lap_trace_dist_squared_to_last(&trace, &near) < 0.01f);
+
+	CPPUNIT_ASSERT(lap_trace_append(&trace, &near, 1500));
+	CPPUNIT_ASSERT(!lap_trace_append(&trace, &near, 1600));
+}
+
+void LapTraceTest::testDropLast()
+{
+	LapTraceSample samples[10];
+	LapTrace trace;
+	lap_trace_init(&trace, samples, 10, &origin);
+
+	GeoPoint a = offsetPoint(&trace, -20, 5);
+	GeoPoint b = offsetPoint(&trace, -35, 20);
+	lap_trace_append(&trace, &a, 1000);
+	lap_trace_append(&trace, &b, 2000);
+
+	lap_trace_drop_last(&trace);
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, trace.count);
+	CPPUNIT_ASSERT_EQUAL((tiny_millis_t) 1000, trace.time);
+	CPPUNIT_ASSERT(lap_trace_dist_squared_to_last(&trace, &a) < 0.1f);
+
+	lap_trace_drop_last(&trace);
+	lap_trace_drop_last(&trace);
+	CPPUNIT_ASSERT_EQUAL((size_t) 1, trace.count);
+	CPPUNIT_ASSERT_EQUAL((tiny_millis_t) 0, trace.time);
+}
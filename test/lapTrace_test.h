@@ -0,0 +1,28 @@
+/*
+ * lapTrace_test.h
+ */
+#ifndef LAPTRACE_TEST_H_
+#define LAPTRACE_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LapTraceTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LapTraceTest );
+  CPPUNIT_TEST( testWalksBothWays );
+  CPPUNIT_TEST( testSplitsLargeSteps );
+  CPPUNIT_TEST( testFullTraceIsUnchanged );
+  CPPUNIT_TEST( testDropLast );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testWalksBothWays();
+  void testSplitsLargeSteps();
+  void testFullTraceIsUnchanged();
+  void testDropLast();
+};
+
+#endif /* LAPTRACE_TEST_H_ */
@@ -13,6 +13,7 @@
 #include "imu.h"
 #include "cpu.h"
 #include "loggerConfig.h"
+#include "telemetryFrame.h"
 #include "jsmn.h"
 #include "mod_string.h"
 #include "modp_atonum.h"
@@ -23,6 +24,7 @@
 #include <streambuf>
 #include "predictive_timer_2.h"
 #include "luaScript.h"
+#include "luaScheduler.h"
 #include "rcp_cpp_unit.hh"
 
 #define JSON_TOKENS 10000
@@ -442,6 +444,7 @@ void LoggerApiTest::testSetConnectivityCfgFile(string filename){
 	CPPUNIT_ASSERT_EQUAL(string("3311"), string(connCfg->bluetoothConfig.passcode));
 
 	CPPUNIT_ASSERT_EQUAL(1, (int)connCfg->telemetryConfig.backgroundStreaming);
+	CPPUNIT_ASSERT_EQUAL(TELEMETRY_DELTA_ENABLED, (int)connCfg->telemetryConfig.deltaEncoding);
 	CPPUNIT_ASSERT_EQUAL(string("xyz123"), string(connCfg->telemetryConfig.telemetryDeviceId));
 	CPPUNIT_ASSERT_EQUAL(string("a.b.c"), string(connCfg->telemetryConfig.telemetryServerHost));
 }
@@ -477,10 +480,48 @@ void LoggerApiTest::testGetConnectivityCfg(){
 	CPPUNIT_ASSERT_EQUAL(string(connCfg->cellularConfig.apnPass), string((String)connJson["cellCfg"]["apnPass"]));
 
 	CPPUNIT_ASSERT_EQUAL((int)connCfg->telemetryConfig.backgroundStreaming, (int)(Number)connJson["telCfg"]["bgStream"]);
+	CPPUNIT_ASSERT_EQUAL((int)connCfg->telemetryConfig.deltaEncoding, (int)(Number)connJson["telCfg"]["delta"]);
 	CPPUNIT_ASSERT_EQUAL(string(connCfg->telemetryConfig.telemetryDeviceId), string((String)connJson["telCfg"]["deviceId"]));
 	CPPUNIT_ASSERT_EQUAL(string(connCfg->telemetryConfig.telemetryServerHost), string((String)connJson["telCfg"]["host"]));
 }
 
+void LoggerApiTest::testSetSdLoggingCfg(){
+	SdLoggingConfig *cfg = &getWorkingLoggerConfig()->SdLoggingConfigs;
+	CPPUNIT_ASSERT_EQUAL(SD_LOGGING_MODE_CSV, (int)cfg->loggingMode);
+	CPPUNIT_ASSERT_EQUAL(DEFAULT_SD_LOGGING_PREALLOCATION_MB, (int)cfg->preallocationMb);
+
+	processApiGeneric("setSdLogCfg1.json");
+	char *txBuffer = mock_getTxBuffer();
+	assertGenericResponse(txBuffer, "setSdLogCfg", API_SUCCESS);
+	CPPUNIT_ASSERT_EQUAL(SD_LOGGING_MODE_BINARY, (int)cfg->loggingMode);
+	CPPUNIT_ASSERT_EQUAL(64, (int)cfg->preallocationMb);
+}
+
+void LoggerApiTest::testGetSdLoggingCfg(){
+	SdLoggingConfig *cfg = &getWorkingLoggerConfig()->SdLoggingConfigs;
+	cfg->loggingMode = SD_LOGGING_MODE_BINARY;
+	cfg->preallocationMb = 128;
+
+	char *response = processApiGeneric("getSdLogCfg1.json");
+	Object json;
+	stringToJson(response, json);
+
+	CPPUNIT_ASSERT_EQUAL(SD_LOGGING_MODE_BINARY, (int)(Number)json["sdLogCfg"]["mode"]);
+	CPPUNIT_ASSERT_EQUAL(128, (int)(Number)json["sdLogCfg"]["prealloc"]);
+}
+
+void LoggerApiTest::testSetTelemetryFormat(){
+	Serial *serial = getMockSerial();
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Json, get_telemetry_format(serial));
+
+	processApiGeneric("setTelemFmt1.json");
+	char *txBuffer = mock_getTxBuffer();
+	assertGenericResponse(txBuffer, "setTelemFmt", API_SUCCESS);
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Binary, get_telemetry_format(serial));
+
+	set_telemetry_format(serial, TELEMETRY_FORMAT_DEFAULT);
+}
+
 void LoggerApiTest::testGetPwmConfigFile(string filename, int index){
 	LoggerConfig *c = getWorkingLoggerConfig();
 	PWMConfig *pwmCfg = &c->PWMConfigs[index];
@@ -747,7 +788,7 @@ void LoggerApiTest::testChannelConfig(ChannelConfig *cfg, string expNm, string e
 	CPPUNIT_ASSERT_EQUAL((int) sr, decodeSampleRate(cfg->sampleRate));
 }
 
-void LoggerApiTest::testSetGpsConfigFile(string filename, unsigned char channelsEnabled, unsigned short sampleRate){
+void LoggerApiTest::testSetGpsConfigFile(string filename, unsigned char channelsEnabled, unsigned short sampleRate, unsigned char navFormat){
 	processApiGeneric(filename);
 	char *txBuffer = mock_getTxBuffer();
 
@@ -762,13 +803,15 @@ void LoggerApiTest::testSetGpsConfigFile(string filename, unsigned char channels
         testChannelConfig(&gpsCfg->speed, string("Speed"), string("MPH"), sampleRate);
         testChannelConfig(&gpsCfg->distance, string("Distance"), string("Miles"), sampleRate);
         testChannelConfig(&gpsCfg->satellites, string("GPSSats"), string(""), sampleRate);
+        CPPUNIT_ASSERT_EQUAL((int)navFormat, (int)gpsCfg->navFormat);
+        CPPUNIT_ASSERT_EQUAL((int)channelsEnabled, (int)gpsCfg->extrapolate);
 
 	assertGenericResponse(txBuffer, "setGpsCfg", API_SUCCESS);
 }
 
 void LoggerApiTest::testSetGpsCfg(){
-	testSetGpsConfigFile("setGpsCfg1.json", 1, 100);
-	testSetGpsConfigFile("setGpsCfg2.json", 0, 50);
+	testSetGpsConfigFile("setGpsCfg1.json", 1, 100, GPS_NAV_FORMAT_BINARY);
+	testSetGpsConfigFile("setGpsCfg2.json", 0, 50, GPS_NAV_FORMAT_NMEA);
 }
 
 void LoggerApiTest::testGetGpsConfigFile(string filename){
@@ -780,6 +823,8 @@ void LoggerApiTest::testGetGpsConfigFile(string filename){
    populateChannelConfig(&gpsCfg->speed, 0, 100);
    populateChannelConfig(&gpsCfg->distance, 0, 100);
    populateChannelConfig(&gpsCfg->satellites, 0, 100);
+   gpsCfg->navFormat = GPS_NAV_FORMAT_BINARY;
+   gpsCfg->extrapolate = 1;
 
    char * response = processApiGeneric(filename);
 
@@ -794,6 +839,8 @@ void LoggerApiTest::testGetGpsConfigFile(string filename){
    CPPUNIT_ASSERT_EQUAL(1, (int)(Number)gpsCfgJson["pos"]);
    CPPUNIT_ASSERT_EQUAL(1, (int)(Number)gpsCfgJson["sats"]);
    CPPUNIT_ASSERT_EQUAL(1, (int)(Number)gpsCfgJson["speed"]);
+   CPPUNIT_ASSERT_EQUAL(GPS_NAV_FORMAT_BINARY, (int)(Number)gpsCfgJson["navFmt"]);
+   CPPUNIT_ASSERT_EQUAL(1, (int)(Number)gpsCfgJson["extrap"]);
 }
 
 void LoggerApiTest::testGetGpsCfg(){
@@ -1225,6 +1272,12 @@ void LoggerApiTest::testRunScriptFile(string filename){
 	assertGenericResponse(txBuffer, "runScript", API_SUCCESS);
 }
 
+void LoggerApiTest::testStoreScriptBytecode(){
+	processApiGeneric("storeScriptBc1.json");
+	char *txBuffer = mock_getTxBuffer();
+	assertGenericResponse(txBuffer, "storeScriptBc", API_SUCCESS);
+}
+
 void LoggerApiTest::testGetCapabilities(){
 	char * response = processApiGeneric("getCapabilities.json");
 
@@ -1244,6 +1297,8 @@ void LoggerApiTest::testGetCapabilities(){
 	CPPUNIT_ASSERT_EQUAL(MAX_TRACKS, (int)(Number)json["capabilities"]["db"]["tracks"]);
 	CPPUNIT_ASSERT_EQUAL(MAX_SECTORS, (int)(Number)json["capabilities"]["db"]["sectors"]);
 	CPPUNIT_ASSERT_EQUAL(SCRIPT_MEMORY_LENGTH, (int)(Number)json["capabilities"]["db"]["script"]);
+
+	CPPUNIT_ASSERT_EQUAL(1, (int)(Number)json["capabilities"]["telemetry"]["bin"]);
 }
 
 void LoggerApiTest::testGetVersion(){
@@ -1258,3 +1313,36 @@ void LoggerApiTest::testGetVersion(){
 	CPPUNIT_ASSERT_EQUAL(BUGFIX_REV, (int)(Number)json["ver"]["bugfix"]);
 	CPPUNIT_ASSERT_EQUAL(string(cpu_get_serialnumber()), (string)(String)json["ver"]["serial"]);
 }
+
+void LoggerApiTest::testGetLuaStats(){
+	lua_scheduler_init();
+	lua_scheduler_add(0, 10, 0, 0);
+	int id = lua_scheduler_add(1, 50, 20, 0);
+	lua_scheduler_ran(id, 50, 80);
+	lua_scheduler_gc_stepped(80, 82, 0);
+	lua_scheduler_gc_stepped(82, 83, 1);
+
+	char * response = processApiGeneric("getLuaStats.json");
+
+	Object json;
+	stringToJson(response, json);
+
+	Array &callbacks = json["luaStats"]["cb"];
+	CPPUNIT_ASSERT_EQUAL((size_t)2, callbacks.Size());
+	CPPUNIT_ASSERT_EQUAL(0, (int)(Number)callbacks[0]["id"]);
+	CPPUNIT_ASSERT_EQUAL(0, (int)(Number)callbacks[0]["runs"]);
+	CPPUNIT_ASSERT_EQUAL(id, (int)(Number)callbacks[1]["id"]);
+	CPPUNIT_ASSERT_EQUAL(20, (int)(Number)callbacks[1]["hz"]);
+	CPPUNIT_ASSERT_EQUAL(20, (int)(Number)callbacks[1]["budget"]);
+	CPPUNIT_ASSERT_EQUAL(1, (int)(Number)callbacks[1]["runs"]);
+	CPPUNIT_ASSERT_EQUAL(1, (int)(Number)callbacks[1]["over"]);
+	CPPUNIT_ASSERT_EQUAL(1, (int)(Number)callbacks[1]["skip"]);
+	CPPUNIT_ASSERT_EQUAL(30, (int)(Number)callbacks[1]["last"]);
+	CPPUNIT_ASSERT_EQUAL(30, (int)(Number)callbacks[1]["max"]);
+
+	CPPUNIT_ASSERT_EQUAL(LUA_DEFAULT_GC_STEPS, (int)(Number)json["luaStats"]["gc"]["budget"]);
+	CPPUNIT_ASSERT_EQUAL(2, (int)(Number)json["luaStats"]["gc"]["steps"]);
+	CPPUNIT_ASSERT_EQUAL(1, (int)(Number)json["luaStats"]["gc"]["cycles"]);
+	CPPUNIT_ASSERT_EQUAL(2, (int)(Number)json["luaStats"]["gc"]["max"]);
+	lua_scheduler_init();
+}
@@ -26,6 +26,9 @@ class LoggerApiTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testUnescapeTextField );
   CPPUNIT_TEST( testSetConnectivityCfg );
   CPPUNIT_TEST( testGetConnectivityCfg );
+  CPPUNIT_TEST( testSetSdLoggingCfg );
+  CPPUNIT_TEST( testGetSdLoggingCfg );
+  CPPUNIT_TEST( testSetTelemetryFormat );
   CPPUNIT_TEST( testGetAnalogCfg );
   CPPUNIT_TEST( testGetMultipleAnalogCfg );
   CPPUNIT_TEST( testSetAnalogCfg );
@@ -58,8 +61,10 @@ class LoggerApiTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testGetScript);
   CPPUNIT_TEST( testSetScript);
   CPPUNIT_TEST( testRunScript);
+  CPPUNIT_TEST( testStoreScriptBytecode);
   CPPUNIT_TEST( testGetVersion);
   CPPUNIT_TEST( testGetCapabilities);
+  CPPUNIT_TEST( testGetLuaStats);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -79,6 +84,9 @@ public:
   void testLogStartStop();
   void testSetConnectivityCfg();
   void testGetConnectivityCfg();
+  void testSetSdLoggingCfg();
+  void testGetSdLoggingCfg();
+  void testSetTelemetryFormat();
   void testGetAnalogCfg();
   void testGetMultipleAnalogCfg();
   void testSetAnalogCfg();
@@ -110,8 +118,10 @@ public:
   void testSetScript();
   void testGetScript();
   void testRunScript();
+  void testStoreScriptBytecode();
   void testGetVersion();
   void testGetCapabilities();
+  void testGetLuaStats();
 
 private:
   void testSetScriptFile(string filename);
@@ -131,7 +141,7 @@ private:
   void testGetTimerConfigFile(string filename, int index);
   void testSetTimerConfigFile(string filename);
   void testGetGpsConfigFile(string filename);
-  void testSetGpsConfigFile(string filename, unsigned char channelsEnabled, unsigned short sampleRate);
+  void testSetGpsConfigFile(string filename, unsigned char channelsEnabled, unsigned short sampleRate, unsigned char navFormat);
   void testAddTrackDbFile(string filename);
   void testGetTrackDbFile(string filename, string addedFilename);
   void testSetLapConfigFile(string filename);
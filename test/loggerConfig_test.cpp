@@ -167,6 +167,8 @@ void LoggerConfigTest::testLoggerInitGpsConfig() {
    CPPUNIT_ASSERT_EQUAL(string("GPSSats"), string(cc->label));
    CPPUNIT_ASSERT_EQUAL(string(""), string(cc->units));
    CPPUNIT_ASSERT(cc->sampleRate == MAX_GPS_SAMPLE_HZ);
+
+   CPPUNIT_ASSERT_EQUAL(DEFAULT_GPS_NAV_FORMAT, (int) lc->GPSConfigs.navFormat);
 }
 
 void LoggerConfigTest::testLoggerInitLapConfig() {
@@ -215,6 +217,7 @@ void LoggerConfigTest::testLoggerInitConnectivityConfig() {
 
    TelemetryConfig *tc = &lc->ConnectivityConfigs.telemetryConfig;
    CPPUNIT_ASSERT_EQUAL(true, (bool) tc->backgroundStreaming);
+   CPPUNIT_ASSERT_EQUAL(DEFAULT_TELEMETRY_DELTA, (int) tc->deltaEncoding);
    CPPUNIT_ASSERT_EQUAL((size_t) 0, strlen(tc->telemetryDeviceId));
    CPPUNIT_ASSERT_EQUAL(string(DEFAULT_TELEMETRY_SERVER_HOST),
                         string(tc->telemetryServerHost));
@@ -0,0 +1,9 @@
+#include "loggerTaskEx.h"
+
+int isLogging(){
+	return 0;
+}
+
+int areSampleBuffersAllocated(){
+	return 1;
+}
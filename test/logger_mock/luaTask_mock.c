@@ -1,4 +1,5 @@
 #include "luaTask.h"
+#include "mod_string.h"
 
 void lockLua(void){
 
@@ -44,9 +45,25 @@ void setShouldReloadScript(int reload){
 
 }
 
+void requestStoreScriptBytecode(void){
+
+}
+
 void set_ontick_freq(size_t freq){
 
 }
 size_t get_ontick_freq(){
 	return 1;
 }
+
+int add_tick_handler(int ref, size_t freq, size_t budgetMs){
+	return -1;
+}
+
+int remove_tick_handler(int id){
+	return -2;
+}
+
+void get_lua_arena_stats(LuaArenaStats *stats){
+	memset(stats, 0, sizeof(LuaArenaStats));
+}
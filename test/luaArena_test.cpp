@@ -0,0 +1,187 @@
+/*
+ * luaArena_test.cpp
+ */
+#include "luaArena_test.h"
+#include "luaArena.h"
+#include "mod_string.h"
+#include <stdint.h>
+#include <vector>
+
+using std::vector;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LuaArenaTest );
+
+#define ARENA_SIZE	8192
+
+static uint64_t memory[ARENA_SIZE / sizeof(uint64_t)];
+static LuaArena arena;
+
+static void * alloc(size_t size) {
+	return lua_arena_realloc(&arena, NULL, 0, size);
+}
+
+static void release(void *ptr, size_t size) {
+	lua_arena_realloc(&arena, ptr, size, 0);
+}
+
+void LuaArenaTest::setUp()
+{
+	lua_arena_init(&arena, memory, ARENA_SIZE);
+}
+
+void LuaArenaTest::tearDown()
+{
+}
+
+void LuaArenaTest::testReusesSmallBlocks()
+{
+	void *a = alloc(20);
+	void *b = alloc(20);
+	void *c = alloc(40);
+	CPPUNIT_ASSERT(a != NULL && b != NULL && c != NULL);
+	CPPUNIT_ASSERT_EQUAL((size_t) 24 + 24 + 40, arena.used);
+
+	// a block of the same size class comes back first
+	release(a, 20);
+	CPPUNIT_ASSERT(a == alloc(17));
+	release(b, 20);
+	void *d = alloc(40);
+	CPPUNIT_ASSERT(d != b);
+
+	// the newest block goes straight back to the top
+	release(d, 40);
+	CPPUNIT_ASSERT(d == alloc(64));
+
+	LuaArenaStats stats;
+	lua_arena_get_stats(&arena, &stats);
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 6, stats.allocations);
+	CPPUNIT_ASSERT_EQUAL((size_t) 24 + 40 + 64, stats.used);
+	CPPUNIT_ASSERT_EQUAL((size_t) 24 + 24 + 40 + 40, stats.highWater);
+}
+
+void LuaArenaTest::testCoalescesLargeBlocks()
+{
+	void *a = alloc(100);
+	void *b = alloc(200);
+	void *c = alloc(100);
+	alloc(8);
+
+	release(a, 100);
+	release(c, 100);
+	release(b, 200);
+
+	LuaArenaStats stats;
+	lua_arena_get_stats(&arena, &stats);
+	CPPUNIT_ASSERT_EQUAL((size_t) 8, stats.used);
+	CPPUNIT_ASSERT_EQUAL((size_t) ARENA_SIZE - 416, stats.largestFree);
+
+	// the hole fits a block the size of all three, and the rest is handed out again
+	CPPUNIT_ASSERT(a == alloc(400));
+	CPPUNIT_ASSERT((unsigned char *) a + 400 == alloc(8));
+}
+
+void LuaArenaTest::testReallocKeepsContents()
+{
+	char *a = (char *) alloc(10);
+	strcpy(a, "arena");
+	alloc(8);
+
+	// moves when it cannot grow in place
+	char *b = (char *) lua_arena_realloc(&arena, a, 10, 100);
+	CPPUNIT_ASSERT(a != b);
+	CPPUNIT_ASSERT_EQUAL(0, strcmp("arena", b));
+	CPPUNIT_ASSERT_EQUAL((size_t) 104 + 8, arena.used);
+
+	// the newest block grows in place, and shrinks in place
+	CPPUNIT_ASSERT(b == lua_arena_realloc(&arena, b, 100, 1000));
+	CPPUNIT_ASSERT(b == lua_arena_realloc(&arena, b, 1000, 30));
+	CPPUNIT_ASSERT_EQUAL(0, strcmp("arena", b));
+	CPPUNIT_ASSERT_EQUAL((size_t) 32 + 8, arena.used);
+	CPPUNIT_ASSERT_EQUAL((size_t) 1000 + 8, arena.highWater);
+}
+
+void LuaArenaTest::testCeiling()
+{
+	void *a = alloc(ARENA_SIZE / 2);
+	CPPUNIT_ASSERT(a != NULL);
+	CPPUNIT_ASSERT(alloc(ARENA_SIZE / 2 + 8) == NULL);
+	void *b = alloc(ARENA_SIZE / 4);
+	CPPUNIT_ASSERT(b != NULL);
+
+	// a failed resize leaves the block where it was
+	CPPUNIT_ASSERT(lua_arena_realloc(&arena, a, ARENA_SIZE / 2, ARENA_SIZE / 2 + 8) == NULL);
+	CPPUNIT_ASSERT_EQUAL((size_t) ARENA_SIZE / 2 + ARENA_SIZE / 4, arena.used);
+
+	LuaArenaStats stats;
+	lua_arena_get_stats(&arena, &stats);
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 2, stats.failures);
+	CPPUNIT_ASSERT_EQUAL((size_t) ARENA_SIZE / 4, stats.largestFree);
+
+	lua_arena_reset(&arena);
+	CPPUNIT_ASSERT(a == alloc(ARENA_SIZE));
+}
+
+/* fills a block with a pattern of its own, to show it is not shared */
+static void fill(unsigned char *p, size_t size, unsigned char tag) {
+	for (size_t i = 0; i < size; i++) p[i] = tag + i;
+}
+
+static bool isFilled(const unsigned char *p, size_t size, unsigned char tag) {
+	for (size_t i = 0; i < size; i++) {
+		if (p[i] != (unsigned char) (tag + i)) return false;
+	}
+	return true;
+}
+
+void LuaArenaTest::testRandomUseKeepsBlocksApart()
+{
+	struct Block {
+		unsigned char *p;
+		size_t size;
+		unsigned char tag;
+	};
+	vector<Block> blocks;
+	unsigned int seed = 4321;
+	size_t expectedUsed = 0;
+
+	for (int i = 0; i < 5000; i++) {
+		seed = seed * 1103515245 + 12345;
+		const unsigned int r = seed >> 8;
+		const size_t size = r % 4 ? 1 + r % 64 : 65 + r % 300;
+
+		if (r % 3 == 0 && !blocks.empty()) {
+			Block &b = blocks[r % blocks.size()];
+			CPPUNIT_ASSERT(isFilled(b.p, b.size, b.tag));
+			release(b.p, b.size);
+			expectedUsed -= (b.size + 7) & ~7;
+			b = blocks.back();
+			blocks.pop_back();
+		} else if (r % 3 == 1 && !blocks.empty()) {
+			Block &b = blocks[r % blocks.size()];
+			unsigned char *p = (unsigned char *) lua_arena_realloc(&arena, b.p, b.size, size);
+			if (!p) continue;
+			const size_t kept = size < b.size ? size : b.size;
+			CPPUNIT_ASSERT(isFilled(p, kept, b.tag));
+			expectedUsed += ((size + 7) & ~7) - ((b.size + 7) & ~7);
+			b.p = p;
+			b.size = size;
+			fill(b.p, b.size, b.tag);
+		} else {
+			Block b = {(unsigned char *) alloc(size), size, (unsigned char) i};
+			if (!b.p) continue;
+			fill(b.p, b.size, b.tag);
+			blocks.push_back(b);
+			expectedUsed += (size + 7) & ~7;
+		}
+		CPPUNIT_ASSERT_EQUAL(expectedUsed, arena.used);
+	}
+
+	for (size_t i = 0; i < blocks.size(); i++) {
+		CPPUNIT_ASSERT(isFilled(blocks[i].p, blocks[i].size, blocks[i].tag));
+		CPPUNIT_ASSERT(blocks[i].p >= (unsigned char *) memory);
+		CPPUNIT_ASSERT(blocks[i].p + blocks[i].size <= (unsigned char *) memory + ARENA_SIZE);
+		release(blocks[i].p, blocks[i].size);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 0, arena.used);
+}
@@ -0,0 +1,30 @@
+/*
+ * luaArena_test.h
+ */
+#ifndef LUAARENA_TEST_H_
+#define LUAARENA_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaArenaTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LuaArenaTest );
+  CPPUNIT_TEST( testReusesSmallBlocks );
+  CPPUNIT_TEST( testCoalescesLargeBlocks );
+  CPPUNIT_TEST( testReallocKeepsContents );
+  CPPUNIT_TEST( testCeiling );
+  CPPUNIT_TEST( testRandomUseKeepsBlocksApart );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testReusesSmallBlocks();
+  void testCoalescesLargeBlocks();
+  void testReallocKeepsContents();
+  void testCeiling();
+  void testRandomUseKeepsBlocksApart();
+};
+
+#endif /* LUAARENA_TEST_H_ */
@@ -0,0 +1,152 @@
+/*
+ * luaScheduler_test.cpp
+ */
+#include "luaScheduler_test.h"
+#include "luaScheduler.h"
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LuaSchedulerTest );
+
+/* runs whatever is due each tick up to end, each run taking runTicks, and counts runs by id */
+static void runUntil(size_t end, size_t runTicks, unsigned int *runs) {
+	size_t now = 0;
+	while (now < end) {
+		const int id = lua_scheduler_next_due(now);
+		if (id < 0) {
+			now += lua_scheduler_ticks_until_due(now, 1000);
+			continue;
+		}
+		runs[id]++;
+		lua_scheduler_ran(id, now, now + runTicks);
+		now += runTicks;
+	}
+}
+
+void LuaSchedulerTest::setUp()
+{
+	lua_scheduler_init();
+}
+
+void LuaSchedulerTest::tearDown()
+{
+	lua_scheduler_init();
+}
+
+void LuaSchedulerTest::testRunsAtEachRate()
+{
+	const int fast = lua_scheduler_add(0, 10, 0, 0);
+	const int slow = lua_scheduler_add(1, 100, 0, 0);
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, lua_scheduler_get(fast)->budget);
+	CPPUNIT_ASSERT_EQUAL(1, lua_scheduler_get(slow)->ref);
+
+	CPPUNIT_ASSERT_EQUAL(-1, lua_scheduler_next_due(9));
+	CPPUNIT_ASSERT_EQUAL((size_t) 1, lua_scheduler_ticks_until_due(9, 1000));
+	CPPUNIT_ASSERT_EQUAL((size_t) 0, lua_scheduler_ticks_until_due(9, 0));
+
+	unsigned int runs[LUA_MAX_CALLBACKS] = {0};
+	runUntil(1000, 1, runs);
+	CPPUNIT_ASSERT_EQUAL(99u, runs[fast]);
+	CPPUNIT_ASSERT_EQUAL(9u, runs[slow]);
+	CPPUNIT_ASSERT_EQUAL(0u, lua_scheduler_get(fast)->stats.skips);
+	CPPUNIT_ASSERT_EQUAL((size_t) 1, lua_scheduler_get(slow)->stats.maxTicks);
+}
+
+void LuaSchedulerTest::testOverrunSkipsNextRun()
+{
+	const int id = lua_scheduler_add(0, 10, 4, 0);
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(10));
+
+	lua_scheduler_ran(id, 10, 15);
+	const LuaCallback *cb = lua_scheduler_get(id);
+	CPPUNIT_ASSERT_EQUAL(1u, cb->stats.runs);
+	CPPUNIT_ASSERT_EQUAL(1u, cb->stats.overruns);
+	CPPUNIT_ASSERT_EQUAL(1u, cb->stats.skips);
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, cb->stats.lastTicks);
+	CPPUNIT_ASSERT_EQUAL(-1, lua_scheduler_next_due(20));
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(30));
+
+	lua_scheduler_ran(id, 30, 32);
+	CPPUNIT_ASSERT_EQUAL(1u, cb->stats.overruns);
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, cb->stats.lastTicks);
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, cb->stats.maxTicks);
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(40));
+}
+
+void LuaSchedulerTest::testDropsRunsWhenBehind()
+{
+	const int id = lua_scheduler_add(0, 10, 100, 0);
+	lua_scheduler_ran(id, 10, 45);
+
+	// the runs due at 20 and 30 are dropped; the one at 40 is still due
+	const LuaCallback *cb = lua_scheduler_get(id);
+	CPPUNIT_ASSERT_EQUAL(2u, cb->stats.skips);
+	CPPUNIT_ASSERT_EQUAL(0u, cb->stats.overruns);
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(45));
+
+	lua_scheduler_postpone(id, 45);
+	CPPUNIT_ASSERT_EQUAL(-1, lua_scheduler_next_due(49));
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(50));
+	CPPUNIT_ASSERT_EQUAL(1u, cb->stats.runs);
+	CPPUNIT_ASSERT_EQUAL(2u, cb->stats.skips);
+
+	// the most overdue callback goes first
+	const int other = lua_scheduler_add(1, 7, 0, 45);
+	CPPUNIT_ASSERT_EQUAL(id, lua_scheduler_next_due(53));
+	lua_scheduler_ran(id, 53, 53);
+	CPPUNIT_ASSERT_EQUAL(other, lua_scheduler_next_due(53));
+}
+
+void LuaSchedulerTest::testAddAndRemove()
+{
+	CPPUNIT_ASSERT_EQUAL(-1, lua_scheduler_add(0, 0, 0, 0));
+	for (int i = 0; i < LUA_MAX_CALLBACKS; i++) {
+		CPPUNIT_ASSERT_EQUAL(i, lua_scheduler_add(i, 10, 0, 0));
+	}
+	CPPUNIT_ASSERT_EQUAL(-1, lua_scheduler_add(9, 10, 0, 0));
+
+	lua_scheduler_remove(1);
+	CPPUNIT_ASSERT(NULL == lua_scheduler_get(1));
+	CPPUNIT_ASSERT(NULL == lua_scheduler_get(LUA_MAX_CALLBACKS));
+	CPPUNIT_ASSERT_EQUAL(1, lua_scheduler_add(9, 20, 0, 0));
+	CPPUNIT_ASSERT_EQUAL(9, lua_scheduler_get(1)->ref);
+
+	lua_scheduler_set_interval(1, 40);
+	CPPUNIT_ASSERT_EQUAL((size_t) 40, lua_scheduler_get(1)->interval);
+	CPPUNIT_ASSERT_EQUAL((size_t) 20, lua_scheduler_get(1)->budget);
+}
+
+void LuaSchedulerTest::testUnlimitedBudget()
+{
+	const int id = lua_scheduler_add(0, 10, LUA_BUDGET_NONE, 0);
+	lua_scheduler_ran(id, 10, 18);
+	const LuaCallback *cb = lua_scheduler_get(id);
+	CPPUNIT_ASSERT_EQUAL(0u, cb->stats.overruns);
+	CPPUNIT_ASSERT_EQUAL((size_t) 20, cb->nextRun);
+
+	// stays unlimited at a new rate until given a budget
+	lua_scheduler_set_interval(id, 40);
+	CPPUNIT_ASSERT_EQUAL(LUA_BUDGET_NONE, cb->budget);
+	lua_scheduler_set_budget(id, 0);
+	CPPUNIT_ASSERT_EQUAL((size_t) 20, cb->budget);
+	lua_scheduler_set_budget(id, 5);
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, cb->budget);
+}
+
+void LuaSchedulerTest::testGcStats()
+{
+	const LuaGcStats *gc = lua_scheduler_get_gc_stats();
+	CPPUNIT_ASSERT_EQUAL((unsigned int) LUA_DEFAULT_GC_STEPS, gc->stepBudget);
+
+	lua_scheduler_gc_stepped(10, 13, 0);
+	lua_scheduler_gc_stepped(13, 14, 1);
+	CPPUNIT_ASSERT_EQUAL(2u, gc->steps);
+	CPPUNIT_ASSERT_EQUAL(1u, gc->cycles);
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, gc->maxStepTicks);
+
+	// the budget outlasts a reload
+	lua_scheduler_set_gc_steps(9);
+	lua_scheduler_init();
+	CPPUNIT_ASSERT_EQUAL(9u, gc->stepBudget);
+	CPPUNIT_ASSERT_EQUAL(0u, gc->steps);
+	lua_scheduler_set_gc_steps(LUA_DEFAULT_GC_STEPS);
+}
@@ -0,0 +1,32 @@
+/*
+ * luaScheduler_test.h
+ */
+#ifndef LUASCHEDULER_TEST_H_
+#define LUASCHEDULER_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaSchedulerTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LuaSchedulerTest );
+  CPPUNIT_TEST( testRunsAtEachRate );
+  CPPUNIT_TEST( testOverrunSkipsNextRun );
+  CPPUNIT_TEST( testDropsRunsWhenBehind );
+  CPPUNIT_TEST( testAddAndRemove );
+  CPPUNIT_TEST( testUnlimitedBudget );
+  CPPUNIT_TEST( testGcStats );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testRunsAtEachRate();
+  void testOverrunSkipsNextRun();
+  void testDropsRunsWhenBehind();
+  void testAddAndRemove();
+  void testUnlimitedBudget();
+  void testGcStats();
+};
+
+#endif /* LUASCHEDULER_TEST_H_ */
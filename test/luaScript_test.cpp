@@ -0,0 +1,67 @@
+/*
+ * luaScript_test.cpp
+ */
+#include "luaScript_test.h"
+#include "luaScript.h"
+#include "mod_string.h"
+#include <string>
+
+using std::string;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LuaScriptTest );
+
+static void flashCode(const char *code) {
+	ScriptBytecode *bytecode = create_script_bytecode(strlen(code));
+	CPPUNIT_ASSERT(bytecode != NULL);
+	memcpy(bytecode->code, code, strlen(code));
+	CPPUNIT_ASSERT_EQUAL(0, flash_script_bytecode(bytecode));
+}
+
+void LuaScriptTest::setUp()
+{
+	flash_default_script();
+}
+
+void LuaScriptTest::tearDown()
+{
+	flash_default_script();
+}
+
+void LuaScriptTest::testBytecodeFollowsScript()
+{
+	size_t length = 0;
+	flashCode("\033Lua code");
+	const unsigned char *code = get_script_bytecode(&length);
+	CPPUNIT_ASSERT(code != NULL);
+	CPPUNIT_ASSERT_EQUAL((size_t) 9, length);
+	CPPUNIT_ASSERT_EQUAL(string("\033Lua code"), string((const char *) code, length));
+
+	// a new script leaves the old code behind
+	CPPUNIT_ASSERT_EQUAL(SCRIPT_ADD_RESULT_OK, flashScriptPage(0, "function onTick() end ", SCRIPT_ADD_MODE_COMPLETE));
+	CPPUNIT_ASSERT(NULL == get_script_bytecode(&length));
+
+	flashCode("\033Lua other");
+	CPPUNIT_ASSERT(NULL != get_script_bytecode(&length));
+	CPPUNIT_ASSERT_EQUAL((size_t) 10, length);
+}
+
+void LuaScriptTest::testRejectsBadBytecode()
+{
+	CPPUNIT_ASSERT(NULL == create_script_bytecode(0));
+	CPPUNIT_ASSERT(NULL == create_script_bytecode(SCRIPT_BYTECODE_LENGTH + 1));
+
+	size_t length = 0;
+	flashCode("\033Lua code");
+	ScriptBytecode *stored = (ScriptBytecode *) (get_script_bytecode(&length) - offsetof(ScriptBytecode, code));
+
+	// from other firmware
+	stored->firmware++;
+	CPPUNIT_ASSERT(NULL == get_script_bytecode(&length));
+	stored->firmware--;
+	CPPUNIT_ASSERT(NULL != get_script_bytecode(&length));
+
+	// damaged
+	stored->code[3] ^= 1;
+	CPPUNIT_ASSERT(NULL == get_script_bytecode(&length));
+}
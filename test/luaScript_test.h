@@ -0,0 +1,24 @@
+/*
+ * luaScript_test.h
+ */
+#ifndef LUASCRIPT_TEST_H_
+#define LUASCRIPT_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class LuaScriptTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( LuaScriptTest );
+  CPPUNIT_TEST( testBytecodeFollowsScript );
+  CPPUNIT_TEST( testRejectsBadBytecode );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testBytecodeFollowsScript();
+  void testRejectsBadBytecode();
+};
+
+#endif /* LUASCRIPT_TEST_H_ */
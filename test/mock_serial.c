@@ -20,6 +20,7 @@ void setupMockSerial(){
 	mockSerial.get_line_wait = &mock_get_line_wait;
 	mockSerial.put_c = &mock_put_c;
 	mockSerial.put_s = &mock_put_s;
+	mockSerial.put_buf = &mock_put_buf;
 }
 
 char * mock_getTxBuffer(){
@@ -78,6 +79,11 @@ void mock_put_s(const char* s )
 	while ( *s ) mock_put_c(*s++ );
 }
 
+void mock_put_buf(const char *data, size_t length)
+{
+	while ( length-- ) mock_put_c(*data++ );
+}
+
 int mock_get_line_wait(char *s, int len, size_t delay)
 {
 	int count = 0;
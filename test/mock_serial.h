@@ -14,6 +14,8 @@ void mock_put_c(char c);
 
 void mock_put_s(const char* s );
 
+void mock_put_buf(const char *data, size_t length);
+
 int mock_get_line_wait(char *s, int len, size_t delay);
 
 int mock_get_line(char *s, int len);
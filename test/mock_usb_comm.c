@@ -17,6 +17,7 @@ void usb_init_serial(Serial *serial){
 	serial->get_line_wait = &usb_readLineWait;
 	serial->put_c = &usb_putchar;
 	serial->put_s = &usb_puts;
+	serial->put_buf = &usb_put_buf;
 }
 
 void usb_init(unsigned int bits, unsigned int parity, unsigned int stopBits, unsigned int baud){}
@@ -50,6 +51,10 @@ void usb_putchar(char c){
 
 }
 
+void usb_put_buf(const char *data, size_t length){
+
+}
+
 void onUSBCommTask(void *pvParameters) {
 }
 
@@ -0,0 +1,109 @@
+/*
+ * nmea_bench.cpp
+ *
+ * Feeds NMEA sentences built from the start/finish points in
+ * data/start_finish_points/sf_data.csv through the tokenizer and through
+ * processGPSData. The fixes are reported without a lock so the timing
+ * covers parsing rather than lap and sector detection.
+ */
+#include "benchmark.h"
+#include "gps.h"
+#include "nmea.h"
+#include "mod_string.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+using std::string;
+using std::vector;
+
+#define BENCHMARK_PASSES	200
+#define SENTENCE_BUFFER_LEN	128
+
+static const char *g_pointFiles[] = {
+	"../data/start_finish_points/sf_data.csv",
+	"data/start_finish_points/sf_data.csv"
+};
+
+static string checksummed(const string &body){
+	unsigned char checksum = 0;
+	for (size_t i = 0; i < body.size(); i++) checksum ^= body[i];
+	char trailer[8];
+	snprintf(trailer, sizeof(trailer), "*%02X\r\n", checksum);
+	return "$" + body + trailer;
+}
+
+static string coordinate(double degrees, int degreeDigits, char positive, char negative){
+	char hemisphere = degrees < 0 ? negative : positive;
+	if (degrees < 0) degrees = -degrees;
+	int whole = (int)degrees;
+	char field[32];
+	snprintf(field, sizeof(field), "%0*d%09.6f,%c", degreeDigits, whole, (degrees - whole) * 60, hemisphere);
+	return field;
+}
+
+/* one 10Hz update burst (GGA, GSA, RMC, VTG) per start/finish point */
+static vector<string> loadSentences(){
+	vector<string> sentences;
+	std::ifstream in;
+	for (size_t i = 0; i < sizeof(g_pointFiles) / sizeof(g_pointFiles[0]) && !in.is_open(); i++){
+		in.open(g_pointFiles[i]);
+	}
+	string line;
+	getline(in, line); //header
+	size_t index = 0;
+	while (getline(in, line)){
+		std::istringstream fields(line);
+		string type;
+		double latitude, longitude;
+		if (!(fields >> type >> latitude >> longitude)) continue;
+
+		string lat = coordinate(latitude, 2, 'N', 'S');
+		string lon = coordinate(longitude, 3, 'E', 'W');
+		char time[16], speed[16];
+		snprintf(time, sizeof(time), "%02u%02u%02u.%03u", (unsigned)(index / 36000) % 24,
+				(unsigned)(index / 600) % 60, (unsigned)(index / 10) % 60, (unsigned)(index % 10) * 100);
+		snprintf(speed, sizeof(speed), "%.2f", (index % 1500) / 10.0);
+		index++;
+
+		sentences.push_back(checksummed("GPGGA," + string(time) + "," + lat + "," + lon + ",0,09,0.9,12.3,M,-20.1,M,,"));
+		sentences.push_back(checksummed("GPGSA,A,3,12,17,04,25,29,10,05,02,,,,,1.45,0.89,1.16"));
+		sentences.push_back(checksummed("GPRMC," + string(time) + ",A," + lat + "," + lon + "," + speed + ",79.65,100106,,,A"));
+		sentences.push_back(checksummed("GPVTG,79.65,T,,M," + string(speed) + ",N,12.3,K,A"));
+	}
+	return sentences;
+}
+
+void benchmarkNmea(){
+	initGPS();
+	vector<string> sentences = loadSentences();
+	if (sentences.empty()){
+		printf("nmea: sf_data.csv not found, skipped\n");
+		return;
+	}
+	printf("nmea: %u sentences from sf_data.csv, %u passes\n", (unsigned int)sentences.size(), BENCHMARK_PASSES);
+
+	char buffer[SENTENCE_BUFFER_LEN];
+	size_t valid = 0;
+	double start = benchmarkSeconds();
+	for (size_t pass = 0; pass < BENCHMARK_PASSES; pass++){
+		for (size_t i = 0; i < sentences.size(); i++){
+			NmeaSentence nmea;
+			strcpy(buffer, sentences[i].c_str());
+			valid += nmea_tokenize(buffer, sentences[i].size(), &nmea);
+		}
+	}
+	benchmarkReport("nmea_tokenize", sentences.size() * BENCHMARK_PASSES, benchmarkSeconds() - start, "sentences");
+	if (valid != sentences.size() * BENCHMARK_PASSES) printf("nmea: %u sentences rejected\n", (unsigned int)(sentences.size() * BENCHMARK_PASSES - valid));
+
+	start = benchmarkSeconds();
+	for (size_t pass = 0; pass < BENCHMARK_PASSES; pass++){
+		for (size_t i = 0; i < sentences.size(); i++){
+			strcpy(buffer, sentences[i].c_str());
+			processGPSData(buffer, sentences[i].size());
+		}
+	}
+	benchmarkReport("processGPSData", sentences.size() * BENCHMARK_PASSES, benchmarkSeconds() - start, "sentences");
+}
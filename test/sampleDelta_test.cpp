@@ -0,0 +1,122 @@
+/*
+ * sampleDelta_test.cpp
+ */
+#include "sampleDelta_test.h"
+#include "sampleDelta.h"
+#include "loggerConfig.h"
+#include "sampleRecord.h"
+#include "mod_string.h"
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( SampleDeltaTest );
+
+#define TEST_CHANNEL_COUNT 3
+
+static ChannelConfig g_configs[TEST_CHANNEL_COUNT] = {
+	{"LapCount", "", 0, 0, SAMPLE_10Hz, 0, 0},
+	{"Battery", "Volts", 0, 20, SAMPLE_10Hz, 2, 0},
+	{"Utc", "ms", 0, 0, SAMPLE_10Hz, 0, ALWAYS_SAMPLED}
+};
+
+static ChannelConfig g_otherConfig = {"Sector", "", 0, 0, SAMPLE_10Hz, 0, 0};
+
+static ChannelSample g_samples[TEST_CHANNEL_COUNT];
+static SampleDelta g_delta;
+
+static ChannelSample * filter(){
+	return sample_delta_filter(&g_delta, g_samples, TEST_CHANNEL_COUNT);
+}
+
+void SampleDeltaTest::setUp()
+{
+	sample_delta_init(&g_delta);
+	memset(g_samples, 0, sizeof(g_samples));
+	for (size_t i = 0; i < TEST_CHANNEL_COUNT; i++){
+		g_samples[i].cfg = &g_configs[i];
+		g_samples[i].populated = true;
+	}
+	g_samples[0].sampleData = SampleData_Int_Noarg;
+	g_samples[0].valueInt = 3;
+	g_samples[1].sampleData = SampleData_Float;
+	g_samples[1].valueFloat = 12.5f;
+	g_samples[2].sampleData = SampleData_LongLong_Noarg;
+	g_samples[2].valueLongLong = 1400000000000LL;
+}
+
+void SampleDeltaTest::tearDown()
+{
+	sample_delta_free(&g_delta);
+}
+
+void SampleDeltaTest::testDeadbandFollowsPrecision()
+{
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, sample_delta_deadband(&g_configs[0]), 1e-6);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.005, sample_delta_deadband(&g_configs[1]), 1e-6);
+}
+
+void SampleDeltaTest::testFirstRecordSendsAllPopulated()
+{
+	g_samples[1].populated = false;
+	ChannelSample *sent = filter();
+
+	CPPUNIT_ASSERT(sent != g_samples);
+	CPPUNIT_ASSERT_EQUAL(true, sent[0].populated);
+	CPPUNIT_ASSERT_EQUAL(false, sent[1].populated);
+	CPPUNIT_ASSERT_EQUAL(true, sent[2].populated);
+	CPPUNIT_ASSERT_EQUAL(3, sent[0].valueInt);
+}
+
+void SampleDeltaTest::testChangesWithinDeadbandAreDropped()
+{
+	filter();
+	g_samples[1].valueFloat = 12.504f;
+	g_samples[2].valueLongLong += 100;
+	ChannelSample *sent = filter();
+
+	CPPUNIT_ASSERT_EQUAL(false, sent[0].populated);
+	CPPUNIT_ASSERT_EQUAL(false, sent[1].populated);
+	CPPUNIT_ASSERT_EQUAL(true, sent[2].populated);
+	CPPUNIT_ASSERT_EQUAL(1400000000100LL, sent[2].valueLongLong);
+
+	//the shared source buffer is never modified
+	CPPUNIT_ASSERT_EQUAL(true, g_samples[0].populated);
+	CPPUNIT_ASSERT_EQUAL(true, g_samples[1].populated);
+
+	g_samples[0].valueInt = 4;
+	g_samples[1].valueFloat = 12.51f;
+	sent = filter();
+	CPPUNIT_ASSERT_EQUAL(true, sent[0].populated);
+	CPPUNIT_ASSERT_EQUAL(true, sent[1].populated);
+}
+
+void SampleDeltaTest::testDriftIsSentOnceBeyondDeadband()
+{
+	filter();
+	g_samples[1].valueFloat = 12.503f;
+	CPPUNIT_ASSERT_EQUAL(false, filter()[1].populated);
+	g_samples[1].valueFloat = 12.506f;
+	CPPUNIT_ASSERT_EQUAL(true, filter()[1].populated);
+	g_samples[1].valueFloat = 12.509f;
+	CPPUNIT_ASSERT_EQUAL(false, filter()[1].populated);
+}
+
+void SampleDeltaTest::testKeyframeResendsEveryChannel()
+{
+	filter();
+	CPPUNIT_ASSERT_EQUAL(false, filter()[0].populated);
+
+	sample_delta_keyframe(&g_delta);
+	ChannelSample *sent = filter();
+	for (size_t i = 0; i < TEST_CHANNEL_COUNT; i++){
+		CPPUNIT_ASSERT_EQUAL(true, sent[i].populated);
+	}
+}
+
+void SampleDeltaTest::testChannelConfigChangeResends()
+{
+	filter();
+	g_samples[0].cfg = &g_otherConfig;
+	ChannelSample *sent = filter();
+	CPPUNIT_ASSERT_EQUAL(true, sent[0].populated);
+	CPPUNIT_ASSERT_EQUAL(false, sent[1].populated);
+}
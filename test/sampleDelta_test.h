@@ -0,0 +1,33 @@
+/*
+ * sampleDelta_test.h
+ */
+
+#ifndef SAMPLEDELTA_TEST_H_
+#define SAMPLEDELTA_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class SampleDeltaTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( SampleDeltaTest );
+  CPPUNIT_TEST( testDeadbandFollowsPrecision );
+  CPPUNIT_TEST( testFirstRecordSendsAllPopulated );
+  CPPUNIT_TEST( testChangesWithinDeadbandAreDropped );
+  CPPUNIT_TEST( testDriftIsSentOnceBeyondDeadband );
+  CPPUNIT_TEST( testKeyframeResendsEveryChannel );
+  CPPUNIT_TEST( testChannelConfigChangeResends );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testDeadbandFollowsPrecision();
+  void testFirstRecordSendsAllPopulated();
+  void testChangesWithinDeadbandAreDropped();
+  void testDriftIsSentOnceBeyondDeadband();
+  void testKeyframeResendsEveryChannel();
+  void testChannelConfigChangeResends();
+};
+
+#endif /* SAMPLEDELTA_TEST_H_ */
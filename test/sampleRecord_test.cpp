@@ -12,6 +12,7 @@
 #include "gps.h"
 #include "task.h"
 #include "capabilities.h"
+#include "mod_string.h"
 #include <string>
 #include "include/taskUtil_mock.h"
 
@@ -162,8 +163,7 @@ void SampleRecordTest::testInitSampleRecord()
       if (ac->cfg.sampleRate != SAMPLE_DISABLED){
          CPPUNIT_ASSERT_EQUAL((size_t) i, ts->channelIndex);
          CPPUNIT_ASSERT_EQUAL((void *) &ac->cfg, (void *) ts->cfg);
-         CPPUNIT_ASSERT_EQUAL((void *) get_analog_sample, (void *)ts->get_float_sample);
-         CPPUNIT_ASSERT_EQUAL(SampleData_Float, ts->sampleData);
+         CPPUNIT_ASSERT_EQUAL(SampleData_Float_Planned, ts->sampleData);
          ts++;
       }
    }
@@ -173,8 +173,8 @@ void SampleRecordTest::testInitSampleRecord()
       if (ac->cfg.sampleRate != SAMPLE_DISABLED){
          CPPUNIT_ASSERT_EQUAL((size_t)i,ts->channelIndex);
          CPPUNIT_ASSERT_EQUAL((void *) &ac->cfg, (void *) ts->cfg);
-         CPPUNIT_ASSERT_EQUAL((void *)get_imu_sample, (void *)ts->get_float_sample);
-         CPPUNIT_ASSERT_EQUAL(SampleData_Float, ts->sampleData);
+         CPPUNIT_ASSERT_EQUAL((void *)ac, (void *)ts->plan.imuConfig);
+         CPPUNIT_ASSERT_EQUAL(SampleData_Float_Planned, ts->sampleData);
          ts++;
       }
    }
@@ -184,8 +184,8 @@ void SampleRecordTest::testInitSampleRecord()
       if (tc->cfg.sampleRate != SAMPLE_DISABLED){
          CPPUNIT_ASSERT_EQUAL((size_t)i, ts->channelIndex);
          CPPUNIT_ASSERT_EQUAL((void *) &tc->cfg, (void *) ts->cfg);
-         CPPUNIT_ASSERT_EQUAL((void *)get_timer_sample, (void *)ts->get_float_sample);
-         CPPUNIT_ASSERT_EQUAL(SampleData_Float, ts->sampleData);
+         CPPUNIT_ASSERT_EQUAL((unsigned int)tc->pulsePerRevolution, ts->plan.pulsePerRevolution);
+         CPPUNIT_ASSERT_EQUAL(SampleData_Float_Planned, ts->sampleData);
          ts++;
       }
    }
@@ -206,8 +206,7 @@ void SampleRecordTest::testInitSampleRecord()
       if (pc->cfg.sampleRate != SAMPLE_DISABLED){
          CPPUNIT_ASSERT_EQUAL((size_t)i, ts->channelIndex);
          CPPUNIT_ASSERT_EQUAL((void *) &pc->cfg, (void *) ts->cfg);
-         CPPUNIT_ASSERT_EQUAL((void *)get_pwm_sample, (void *)ts->get_int_sample);
-         CPPUNIT_ASSERT_EQUAL(SampleData_Int, ts->sampleData);
+         CPPUNIT_ASSERT_EQUAL(SampleData_Float_Planned, ts->sampleData);
          ts++;
       }
    }
@@ -337,3 +336,225 @@ void SampleRecordTest::testLoggerMessageAlwaysHasTime() {
 
     CPPUNIT_ASSERT_EQUAL(true, tick < 1000);
 }
+
+void SampleRecordTest::testLoggerMessagePoolRecycling() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    size_t channelCount = get_enabled_channel_count(lc);
+
+    LoggerMessage messages[2];
+    LoggerMessagePool pool;
+    logger_message_pool_init(&pool, messages, 2);
+
+    LoggerMessage *first = logger_message_pool_acquire(&pool, lc, channelCount);
+    LoggerMessage *second = logger_message_pool_acquire(&pool, lc, channelCount);
+    CPPUNIT_ASSERT(first != NULL && second != NULL && first != second);
+    CPPUNIT_ASSERT_EQUAL(channelCount, first->sampleCount);
+    CPPUNIT_ASSERT(first->channelSamples != NULL);
+
+    // two consumers take the first message, the logger hands it off
+    logger_message_retain(first);
+    logger_message_retain(first);
+    logger_message_release(first);
+
+    CPPUNIT_ASSERT(NULL == logger_message_pool_acquire(&pool, lc, channelCount));
+    // the logger decides whether a sample was lost
+    CPPUNIT_ASSERT_EQUAL((size_t)0, pool.dropped);
+    logger_message_pool_drop(&pool);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, pool.dropped);
+
+    // only recycled once every consumer is done
+    logger_message_release(first);
+    CPPUNIT_ASSERT(NULL == logger_message_pool_acquire(&pool, lc, channelCount));
+    logger_message_release(first);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, (size_t)first->refCount);
+    logger_message_release(first);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, (size_t)first->refCount);
+
+    ChannelSample *samples = first->channelSamples;
+    CPPUNIT_ASSERT(first == logger_message_pool_acquire(&pool, lc, channelCount));
+    CPPUNIT_ASSERT(samples == first->channelSamples);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, pool.dropped);
+}
+
+void SampleRecordTest::testLoggerMessagePoolInvalidate() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    size_t channelCount = get_enabled_channel_count(lc);
+
+    LoggerMessage messages[1];
+    LoggerMessagePool pool;
+    logger_message_pool_init(&pool, messages, 1);
+
+    LoggerMessage *msg = logger_message_pool_acquire(&pool, lc, channelCount);
+    logger_message_pool_invalidate(&pool);
+    logger_message_release(msg);
+
+    lc->ADCConfigs[0].cfg.sampleRate = SAMPLE_10Hz;
+    size_t newChannelCount = get_enabled_channel_count(lc);
+    CPPUNIT_ASSERT(newChannelCount != channelCount);
+
+    CPPUNIT_ASSERT(msg == logger_message_pool_acquire(&pool, lc, newChannelCount));
+    CPPUNIT_ASSERT_EQUAL(newChannelCount, msg->sampleCount);
+    CPPUNIT_ASSERT_EQUAL(pool.generation, msg->generation);
+}
+
+void SampleRecordTest::testLoggerMessagePoolAllocate() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    size_t channelCount = get_enabled_channel_count(lc);
+
+    LoggerMessage messages[3];
+    LoggerMessagePool pool;
+    logger_message_pool_init(&pool, messages, 3);
+
+    LoggerMessage *held = logger_message_pool_acquire(&pool, lc, channelCount);
+    logger_message_pool_invalidate(&pool);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, logger_message_pool_allocate(&pool, lc, channelCount));
+
+    // every free message is built up front and left free
+    for (size_t i = 0; i < 3; i++) {
+        LoggerMessage *msg = messages + i;
+        if (msg == held) continue;
+        CPPUNIT_ASSERT(msg->channelSamples != NULL);
+        CPPUNIT_ASSERT_EQUAL(pool.generation, msg->generation);
+        CPPUNIT_ASSERT_EQUAL((size_t)0, (size_t)msg->refCount);
+    }
+
+    // a held message keeps its buffer until it comes back
+    CPPUNIT_ASSERT(held->generation != pool.generation);
+    CPPUNIT_ASSERT_EQUAL((size_t)1, (size_t)held->refCount);
+}
+
+void SampleRecordTest::testScheduledSampleBufferMatchesScan() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    lc->ADCConfigs[0].cfg.sampleRate = SAMPLE_10Hz;
+    lc->ADCConfigs[1].cfg.sampleRate = SAMPLE_50Hz;
+    lc->ADCConfigs[2].cfg.sampleRate = SAMPLE_50Hz;
+    lc->ADCConfigs[3].cfg.sampleRate = SAMPLE_200Hz;
+    lc->GPSConfigs.latitude.sampleRate = SAMPLE_25Hz;
+    lc->GPSConfigs.longitude.sampleRate = SAMPLE_25Hz;
+
+    size_t channelCount = get_enabled_channel_count(lc);
+    LoggerMessage scanned;
+    scanned.channelSamples = create_channel_sample_buffer(lc, channelCount);
+    init_channel_sample_buffer(lc, scanned.channelSamples, channelCount);
+
+    LoggerMessage scheduled;
+    scheduled.channelSamples = create_channel_sample_buffer(lc, channelCount);
+    init_channel_sample_buffer(lc, scheduled.channelSamples, channelCount);
+
+    SampleSchedule schedule;
+    CPPUNIT_ASSERT_EQUAL(channelCount, init_sample_schedule(&schedule, scheduled.channelSamples, channelCount));
+    CPPUNIT_ASSERT_EQUAL((size_t)2, schedule.alwaysSampledCount);
+    CPPUNIT_ASSERT_EQUAL(SAMPLE_200Hz, (int)schedule.groups[0].sampleRate);
+
+    for (size_t tick = 0; tick < 2 * TICK_RATE_HZ; tick++) {
+        int scanRate = populate_sample_buffer(&scanned, channelCount, tick);
+        CPPUNIT_ASSERT_EQUAL(scanRate != SAMPLE_DISABLED, sample_schedule_is_due(&schedule, tick) != 0);
+        int scheduleRate = populate_scheduled_sample_buffer(&scheduled, &schedule, tick);
+        CPPUNIT_ASSERT_EQUAL(scanRate, scheduleRate);
+        if (scanRate == SAMPLE_DISABLED)
+            continue;
+
+        for (size_t i = 0; i < channelCount; i++) {
+            CPPUNIT_ASSERT_EQUAL(scanned.channelSamples[i].populated, scheduled.channelSamples[i].populated);
+        }
+    }
+
+    free_sample_schedule(&schedule);
+    free(scanned.channelSamples);
+    free(scheduled.channelSamples);
+}
+
+void SampleRecordTest::testPlannedSamplesMatchConfigLookup() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    const unsigned char scalingModes[] = {SCALING_MODE_RAW, SCALING_MODE_LINEAR, SCALING_MODE_MAP};
+    for (size_t i = 0; i < 3; i++) {
+        ADCConfig *ac = &lc->ADCConfigs[i];
+        ac->cfg.sampleRate = SAMPLE_10Hz;
+        ac->scalingMode = scalingModes[i];
+        ac->linearScaling = 0.5f;
+        ADC_mock_set_value(i, 100 + i);
+    }
+    const unsigned char timerModes[] = {MODE_LOGGING_TIMER_RPM, MODE_LOGGING_TIMER_PERIOD_MS};
+    for (size_t i = 0; i < 2 && i < CONFIG_TIMER_CHANNELS; i++) {
+        TimerConfig *tc = &lc->TimerConfigs[i];
+        tc->cfg.sampleRate = SAMPLE_10Hz;
+        tc->mode = timerModes[i];
+        tc->pulsePerRevolution = 2;
+    }
+    ADC_sample_all();
+
+    size_t channelCount = get_enabled_channel_count(lc);
+    LoggerMessage lm;
+    lm.channelSamples = create_channel_sample_buffer(lc, channelCount);
+    init_channel_sample_buffer(lc, lm.channelSamples, channelCount);
+    populate_sample_buffer(&lm, channelCount, 0);
+
+    size_t checked = 0;
+    for (size_t i = 0; i < channelCount; i++) {
+        ChannelSample *s = lm.channelSamples + i;
+        if (s->sampleData != SampleData_Float_Planned)
+            continue;
+
+        const ChannelConfig *cfg = s->cfg;
+        const int index = s->channelIndex;
+        if (index < CONFIG_ADC_CHANNELS && cfg == &lc->ADCConfigs[index].cfg) {
+            CPPUNIT_ASSERT_EQUAL(get_analog_sample(index), s->valueFloat);
+        } else if (index < CONFIG_TIMER_CHANNELS && cfg == &lc->TimerConfigs[index].cfg) {
+            CPPUNIT_ASSERT_EQUAL(get_timer_sample(index), s->valueFloat);
+        } else if (index < CONFIG_IMU_CHANNELS && cfg == &lc->ImuConfigs[index].cfg) {
+            CPPUNIT_ASSERT_EQUAL(get_imu_sample(index), s->valueFloat);
+        } else {
+            continue;
+        }
+        checked++;
+    }
+    CPPUNIT_ASSERT(checked >= 4);
+
+    free(lm.channelSamples);
+}
+
+void SampleRecordTest::testGpsSamplesCarryFixTime() {
+    LoggerConfig *lc = getWorkingLoggerConfig();
+    GPSConfig *gc = &lc->GPSConfigs;
+    gc->extrapolate = 1;
+
+    resetTicks();
+    for (int i = 0; i < 20; i++) incrementTick();
+    GpsNavData nav;
+    memset(&nav, 0, sizeof(nav));
+    nav.quality = GPS_QUALITY_FIX;
+    nav.utcMillis = 1456790399000ll;
+    processGPSNavData(&nav);
+
+    size_t channelCount = get_enabled_channel_count(lc);
+    LoggerMessage lm;
+    lm.channelSamples = create_channel_sample_buffer(lc, channelCount);
+    lm.sampleCount = channelCount;
+    lm.type = LoggerMessageType_Sample;
+    init_channel_sample_buffer(lc, lm.channelSamples, channelCount);
+
+    for (int i = 0; i < 5; i++) incrementTick();
+    populate_sample_buffer(&lm, channelCount, 0);
+
+    size_t timestamped = 0;
+    for (size_t i = 0; i < channelCount; i++) {
+        const ChannelSample *s = lm.channelSamples + i;
+        const bool gpsChannel = s->cfg == &gc->latitude || s->cfg == &gc->longitude ||
+            s->cfg == &gc->speed || s->cfg == &gc->distance || s->cfg == &gc->satellites;
+        CPPUNIT_ASSERT_EQUAL(gpsChannel, s->fixTimestamped);
+        if (!s->fixTimestamped)
+            continue;
+
+        CPPUNIT_ASSERT_EQUAL((tiny_millis_t) (20 * MS_PER_TICK), s->fixUptime);
+        timestamped++;
+    }
+    CPPUNIT_ASSERT_EQUAL((size_t) 5, timestamped);
+
+    for (size_t i = 0; i < channelCount; i++) {
+        const ChannelSample *s = lm.channelSamples + i;
+        if (s->cfg == &gc->latitude)
+            CPPUNIT_ASSERT(s->get_float_sample_noarg == getExtrapolatedLatitude);
+    }
+
+    free(lm.channelSamples);
+}
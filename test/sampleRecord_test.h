@@ -11,6 +11,12 @@ class SampleRecordTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testPopulateSampleRecord );
   CPPUNIT_TEST( testIsValidLoggerMessageAge );
   CPPUNIT_TEST( testLoggerMessageAlwaysHasTime );
+  CPPUNIT_TEST( testLoggerMessagePoolRecycling );
+  CPPUNIT_TEST( testLoggerMessagePoolInvalidate );
+  CPPUNIT_TEST( testLoggerMessagePoolAllocate );
+  CPPUNIT_TEST( testScheduledSampleBufferMatchesScan );
+  CPPUNIT_TEST( testPlannedSamplesMatchConfigLookup );
+  CPPUNIT_TEST( testGpsSamplesCarryFixTime );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -21,6 +27,12 @@ public:
   void testPopulateSampleRecord();
   void testIsValidLoggerMessageAge();
   void testLoggerMessageAlwaysHasTime();
+  void testLoggerMessagePoolRecycling();
+  void testLoggerMessagePoolInvalidate();
+  void testLoggerMessagePoolAllocate();
+  void testScheduledSampleBufferMatchesScan();
+  void testPlannedSamplesMatchConfigLookup();
+  void testGpsSamplesCarryFixTime();
 
 private:
 
@@ -0,0 +1,75 @@
+/*
+ * sampleSchedule_bench.cpp
+ *
+ * Compares the per-channel modulo scan in populate_sample_buffer with the
+ * precomputed schedule used by the logger task.
+ */
+#include "benchmark.h"
+#include "loggerConfig.h"
+#include "loggerHardware.h"
+#include "loggerSampleData.h"
+#include "sampleRecord.h"
+#include "gps.h"
+#include <stdlib.h>
+
+#define BENCHMARK_TICKS		(TICK_RATE_HZ * 600)
+
+static void configureChannels(LoggerConfig *lc){
+	const unsigned short rates[] = {SAMPLE_10Hz, SAMPLE_50Hz, SAMPLE_100Hz, SAMPLE_25Hz};
+	for (size_t i = 0; i < CONFIG_ADC_CHANNELS; i++){
+		lc->ADCConfigs[i].cfg.sampleRate = rates[i % 4];
+	}
+	for (size_t i = 0; i < CONFIG_IMU_CHANNELS; i++){
+		lc->ImuConfigs[i].cfg.sampleRate = SAMPLE_100Hz;
+	}
+	for (size_t i = 0; i < CONFIG_TIMER_CHANNELS; i++){
+		lc->TimerConfigs[i].cfg.sampleRate = SAMPLE_50Hz;
+	}
+	lc->GPSConfigs.latitude.sampleRate = SAMPLE_25Hz;
+	lc->GPSConfigs.longitude.sampleRate = SAMPLE_25Hz;
+	lc->GPSConfigs.speed.sampleRate = SAMPLE_25Hz;
+}
+
+static LoggerMessage createMessage(LoggerConfig *lc, size_t channelCount){
+	LoggerMessage msg;
+	msg.type = LoggerMessageType_Sample;
+	msg.sampleCount = channelCount;
+	msg.channelSamples = create_channel_sample_buffer(lc, channelCount);
+	init_channel_sample_buffer(lc, msg.channelSamples, channelCount);
+	return msg;
+}
+
+void benchmarkSampleSchedule(){
+	InitLoggerHardware();
+	initGPS();
+	initialize_logger_config();
+
+	LoggerConfig *lc = getWorkingLoggerConfig();
+	configureChannels(lc);
+	size_t channelCount = get_enabled_channel_count(lc);
+	printf("sample schedule: %u channels, %u ticks\n", (unsigned int)channelCount, (unsigned int)BENCHMARK_TICKS);
+
+	LoggerMessage scanned = createMessage(lc, channelCount);
+	volatile int sink = 0;
+	double start = benchmarkSeconds();
+	for (size_t tick = 0; tick < BENCHMARK_TICKS; tick++){
+		sink += populate_sample_buffer(&scanned, channelCount, tick);
+	}
+	double scanSeconds = benchmarkSeconds() - start;
+	benchmarkReport("populate_sample_buffer (modulo scan)", BENCHMARK_TICKS, scanSeconds, "ticks");
+
+	LoggerMessage scheduled = createMessage(lc, channelCount);
+	SampleSchedule schedule;
+	init_sample_schedule(&schedule, scheduled.channelSamples, channelCount);
+	start = benchmarkSeconds();
+	for (size_t tick = 0; tick < BENCHMARK_TICKS; tick++){
+		sink += populate_scheduled_sample_buffer(&scheduled, &schedule, tick);
+	}
+	double scheduleSeconds = benchmarkSeconds() - start;
+	benchmarkReport("populate_scheduled_sample_buffer", BENCHMARK_TICKS, scheduleSeconds, "ticks");
+	printf("speedup: %.2fx\n", scanSeconds / scheduleSeconds);
+
+	free_sample_schedule(&schedule);
+	free(scanned.channelSamples);
+	free(scheduled.channelSamples);
+}
@@ -32,4 +32,7 @@ void incrementTick( void );
 
 void vTaskDelay(portTickType xTicksToDelay);
 
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
 #endif /* _TASK_H_ */
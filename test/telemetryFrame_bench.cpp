@@ -0,0 +1,102 @@
+/*
+ * telemetryFrame_bench.cpp
+ *
+ * Compares the JSON sample record sent by api_sendSampleRecord with the
+ * binary telemetry frame for the same sample buffer: bytes on the wire,
+ * encode time and the sample rate either leaves room for on a 115200 baud link.
+ */
+#include "benchmark.h"
+#include "ADC.h"
+#include "gps.h"
+#include "loggerApi.h"
+#include "loggerConfig.h"
+#include "loggerHardware.h"
+#include "loggerSampleData.h"
+#include "sampleRecord.h"
+#include "telemetryFrame.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCHMARK_SAMPLES	200000
+#define LINK_BAUD			115200
+//start, 8 data and stop bits
+#define LINK_BYTES_PER_SEC	(LINK_BAUD / 10)
+
+static size_t g_bytesSent;
+
+static void countByte(char c){
+	g_bytesSent++;
+}
+
+static void countString(const char *s){
+	g_bytesSent += strlen(s);
+}
+
+static void countBuffer(const char *data, size_t length){
+	g_bytesSent += length;
+}
+
+static void report(const char *name, size_t bytes, double seconds){
+	printf("%-48s %8u bytes/sample %8.0f ns/sample %6u Hz max @%u baud\n", name,
+			(unsigned int)bytes, seconds * 1e9 / BENCHMARK_SAMPLES,
+			(unsigned int)(LINK_BYTES_PER_SEC / bytes), (unsigned int)LINK_BAUD);
+}
+
+void benchmarkTelemetryFrame(){
+	InitLoggerHardware();
+	initGPS();
+	initialize_logger_config();
+
+	LoggerConfig *lc = getWorkingLoggerConfig();
+	for (size_t i = 0; i < CONFIG_ADC_CHANNELS; i++){
+		lc->ADCConfigs[i].cfg.sampleRate = SAMPLE_50Hz;
+	}
+	for (size_t i = 0; i < CONFIG_IMU_CHANNELS; i++){
+		lc->ImuConfigs[i].cfg.sampleRate = SAMPLE_50Hz;
+	}
+	ADC_sample_all();
+
+	size_t channelCount = get_enabled_channel_count(lc);
+	LoggerMessage msg;
+	msg.channelSamples = create_channel_sample_buffer(lc, channelCount);
+	msg.sampleCount = channelCount;
+	init_channel_sample_buffer(lc, msg.channelSamples, channelCount);
+	populate_sample_buffer(&msg, channelCount, 0);
+	//the mocked hardware reads zero; give floats realistic digits so the JSON is not flattered
+	for (size_t i = 0; i < channelCount; i++){
+		ChannelSample *sample = msg.channelSamples + i;
+		if (sample->sampleData == SampleData_Float || sample->sampleData == SampleData_Float_Noarg ||
+				sample->sampleData == SampleData_Float_Planned){
+			sample->valueFloat = 12.345678f * (i + 1);
+		}
+	}
+	printf("telemetry frame: %u channels, %u samples\n", (unsigned int)channelCount, (unsigned int)BENCHMARK_SAMPLES);
+
+	Serial serial;
+	memset(&serial, 0, sizeof(serial));
+	serial.put_c = countByte;
+	serial.put_s = countString;
+	serial.put_buf = countBuffer;
+
+	g_bytesSent = 0;
+	double start = benchmarkSeconds();
+	for (size_t i = 0; i < BENCHMARK_SAMPLES; i++){
+		api_sendSampleRecord(&serial, msg.channelSamples, channelCount, i, 0);
+		put_crlf(&serial);
+	}
+	double jsonSeconds = benchmarkSeconds() - start;
+	size_t jsonBytes = g_bytesSent / BENCHMARK_SAMPLES;
+
+	g_bytesSent = 0;
+	start = benchmarkSeconds();
+	for (size_t i = 0; i < BENCHMARK_SAMPLES; i++){
+		telemetry_send_sample_frame(&serial, msg.channelSamples, channelCount, i);
+	}
+	double binarySeconds = benchmarkSeconds() - start;
+	size_t binaryBytes = g_bytesSent / BENCHMARK_SAMPLES;
+
+	report("json sample record", jsonBytes, jsonSeconds);
+	report("binary sample frame", binaryBytes, binarySeconds);
+
+	free(msg.channelSamples);
+}
@@ -0,0 +1,172 @@
+/*
+ * telemetryFrame_test.cpp
+ */
+#include "telemetryFrame_test.h"
+#include "telemetryFrame.h"
+#include "binaryLogFormat.h"
+#include "crc16.h"
+#include "loggerConfig.h"
+#include "sampleRecord.h"
+#include "mod_string.h"
+#include <string>
+
+using std::string;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( TelemetryFrameTest );
+
+#define TEST_CHANNEL_COUNT 4
+#define LONG_CHANNEL_COUNT 20
+
+static string g_sent;
+static string g_record;
+
+static void captureByte(char c){
+	g_sent += c;
+}
+
+static void captureBuffer(const char *data, size_t length){
+	g_sent.append(data, length);
+}
+
+static void captureRecord(const void *data, size_t length){
+	g_record.append((const char *)data, length);
+}
+
+static Serial g_captureSerial;
+static Serial g_otherSerial;
+
+static ChannelConfig g_configs[TEST_CHANNEL_COUNT] = {
+	{"Interval", "ms", 0, 0, SAMPLE_100Hz, 0, ALWAYS_SAMPLED},
+	{"Utc", "ms", 0, 0, SAMPLE_100Hz, 0, ALWAYS_SAMPLED},
+	{"Battery", "Volts", 0, 20, SAMPLE_1Hz, 2, 0},
+	{"Latitude", "Degrees", -180, 180, SAMPLE_10Hz, 6, 0}
+};
+
+static ChannelSample g_samples[LONG_CHANNEL_COUNT];
+
+/* reverses the COBS encoding of a single delimited frame */
+static string decodeFrame(const string &frame){
+	CPPUNIT_ASSERT(frame.size() >= 2);
+	CPPUNIT_ASSERT_EQUAL((char)TELEMETRY_FRAME_DELIMITER, frame[0]);
+	CPPUNIT_ASSERT_EQUAL((char)TELEMETRY_FRAME_DELIMITER, frame[frame.size() - 1]);
+
+	string body = frame.substr(1, frame.size() - 2);
+	CPPUNIT_ASSERT_EQUAL(string::npos, body.find('\0'));
+
+	string decoded;
+	size_t i = 0;
+	while (i < body.size()){
+		uint8_t code = (uint8_t)body[i++];
+		CPPUNIT_ASSERT(i + code - 1 <= body.size());
+		decoded.append(body, i, code - 1);
+		i += code - 1;
+		if (code != 0xff && i < body.size()) decoded += '\0';
+	}
+	return decoded;
+}
+
+/* checks and strips the trailing crc */
+static string framePayload(const string &frame){
+	string decoded = decodeFrame(frame);
+	CPPUNIT_ASSERT(decoded.size() >= 3);
+	size_t length = decoded.size() - 2;
+	uint16_t crc = crc16_ccitt(TELEMETRY_FRAME_CRC_INIT, (const uint8_t *)decoded.data(), length);
+	CPPUNIT_ASSERT_EQUAL((int)(crc & 0xff), (int)(uint8_t)decoded[length]);
+	CPPUNIT_ASSERT_EQUAL((int)(crc >> 8), (int)(uint8_t)decoded[length + 1]);
+	return decoded.substr(0, length);
+}
+
+void TelemetryFrameTest::setUp()
+{
+	g_sent.clear();
+	g_record.clear();
+	memset(&g_captureSerial, 0, sizeof(g_captureSerial));
+	g_captureSerial.put_c = captureByte;
+	g_captureSerial.put_buf = captureBuffer;
+
+	memset(g_samples, 0, sizeof(g_samples));
+	for (size_t i = 0; i < LONG_CHANNEL_COUNT; i++){
+		g_samples[i].cfg = &g_configs[i % TEST_CHANNEL_COUNT];
+		g_samples[i].populated = true;
+		g_samples[i].sampleData = SampleData_Float;
+		g_samples[i].valueFloat = 1.5f * i;
+	}
+	g_samples[0].sampleData = SampleData_Int_Noarg;
+	g_samples[0].valueInt = 0;
+	g_samples[1].sampleData = SampleData_LongLong_Noarg;
+	g_samples[1].valueLongLong = 1400000000123LL;
+	g_samples[2].populated = false;
+	g_samples[3].sampleData = SampleData_Double_Noarg;
+	g_samples[3].valueDouble = -45.123456;
+}
+
+void TelemetryFrameTest::tearDown()
+{
+	set_telemetry_format(&g_captureSerial, TELEMETRY_FORMAT_DEFAULT);
+	set_telemetry_format(&g_otherSerial, TELEMETRY_FORMAT_DEFAULT);
+}
+
+void TelemetryFrameTest::testCrcCheckValue()
+{
+	const char *check = "123456789";
+	CPPUNIT_ASSERT_EQUAL(0x29b1, (int)crc16_ccitt(TELEMETRY_FRAME_CRC_INIT, (const uint8_t *)check, 9));
+}
+
+void TelemetryFrameTest::testSampleFrameCarriesBinaryRecord()
+{
+	telemetry_send_sample_frame(&g_captureSerial, g_samples, TEST_CHANNEL_COUNT, 0x01020304);
+	string payload = framePayload(g_sent);
+
+	binary_log_write_record(captureRecord, g_samples, TEST_CHANNEL_COUNT, 0);
+	string expected;
+	expected += (char)TelemetryFrameType_Sample;
+	expected += string("\x04\x03\x02\x01", 4);
+	//the frame has its own CRC, so only the mask and values of the record are sent
+	expected += g_record.substr(BINARY_LOG_RECORD_HEADER_SIZE,
+			g_record.size() - BINARY_LOG_RECORD_HEADER_SIZE - BINARY_LOG_RECORD_CRC_SIZE);
+	CPPUNIT_ASSERT(expected == payload);
+}
+
+void TelemetryFrameTest::testLongFrameSpansCobsBlocks()
+{
+	telemetry_send_meta_frame(&g_captureSerial, g_samples, LONG_CHANNEL_COUNT);
+	string payload = framePayload(g_sent);
+
+	CPPUNIT_ASSERT(payload.size() > TELEMETRY_FRAME_COBS_BLOCK);
+	CPPUNIT_ASSERT_EQUAL((size_t)(3 + LONG_CHANNEL_COUNT * BINARY_LOG_CHANNEL_META_SIZE), payload.size());
+	CPPUNIT_ASSERT_EQUAL((int)TelemetryFrameType_Meta, (int)payload[0]);
+	CPPUNIT_ASSERT_EQUAL(LONG_CHANNEL_COUNT, (int)(uint8_t)payload[1]);
+	CPPUNIT_ASSERT_EQUAL(0, (int)payload[2]);
+
+	for (size_t i = 0; i < LONG_CHANNEL_COUNT; i++){
+		uint8_t meta[BINARY_LOG_CHANNEL_META_SIZE];
+		binary_log_encode_channel_meta(meta, &g_samples[i]);
+		CPPUNIT_ASSERT(string((const char *)meta, sizeof(meta)) ==
+				payload.substr(3 + i * BINARY_LOG_CHANNEL_META_SIZE, BINARY_LOG_CHANNEL_META_SIZE));
+	}
+}
+
+void TelemetryFrameTest::testEventFrame()
+{
+	telemetry_send_event_frame(&g_captureSerial, TelemetryFrameType_Start);
+	string payload = framePayload(g_sent);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, payload.size());
+	CPPUNIT_ASSERT_EQUAL((int)TelemetryFrameType_Start, (int)payload[0]);
+}
+
+void TelemetryFrameTest::testFormatIsPerSerial()
+{
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Json, get_telemetry_format(&g_captureSerial));
+
+	set_telemetry_format(&g_captureSerial, TelemetryFormat_Binary);
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Binary, get_telemetry_format(&g_captureSerial));
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Json, get_telemetry_format(&g_otherSerial));
+
+	set_telemetry_format(&g_captureSerial, TelemetryFormat_Binary);
+	set_telemetry_format(&g_captureSerial, TelemetryFormat_Json);
+	CPPUNIT_ASSERT_EQUAL(TelemetryFormat_Json, get_telemetry_format(&g_captureSerial));
+
+	CPPUNIT_ASSERT_EQUAL((int)TELEMETRY_FORMAT_DEFAULT, filterTelemetryFormat(7));
+	CPPUNIT_ASSERT_EQUAL((int)TelemetryFormat_Binary, filterTelemetryFormat(TelemetryFormat_Binary));
+}
@@ -0,0 +1,31 @@
+/*
+ * telemetryFrame_test.h
+ */
+
+#ifndef TELEMETRYFRAME_TEST_H_
+#define TELEMETRYFRAME_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TelemetryFrameTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( TelemetryFrameTest );
+  CPPUNIT_TEST( testCrcCheckValue );
+  CPPUNIT_TEST( testSampleFrameCarriesBinaryRecord );
+  CPPUNIT_TEST( testLongFrameSpansCobsBlocks );
+  CPPUNIT_TEST( testEventFrame );
+  CPPUNIT_TEST( testFormatIsPerSerial );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testCrcCheckValue();
+  void testSampleFrameCarriesBinaryRecord();
+  void testLongFrameSpansCobsBlocks();
+  void testEventFrame();
+  void testFormatIsPerSerial();
+};
+
+#endif /* TELEMETRYFRAME_TEST_H_ */
@@ -0,0 +1,72 @@
+/*
+ * trackIndex_bench.cpp
+ *
+ * Times track auto detection lookups over the start/finish points in
+ * data/start_finish_points, through the track index and through a linear
+ * scan of every track as findClosestTrack does. Lookups are made next to
+ * each track and at a spread of points away from any track.
+ */
+#include "benchmark.h"
+#include "trackPoints.h"
+#include "auto_track.h"
+#include "geopoint.h"
+#include "trackIndex.h"
+#include <vector>
+
+using std::vector;
+
+#define BENCHMARK_PASSES	20
+
+void benchmarkTrackIndex(){
+	vector<Track> tracks = loadTrackPoints();
+	if (tracks.empty()){
+		printf("trackIndex: start/finish points not found, skipped\n");
+		return;
+	}
+
+	vector<GeoPoint> points;
+	for (size_t i = 0; i < tracks.size(); i++){
+		GeoPoint start = getStartPoint(&tracks[i]);
+		GeoPoint near = {start.latitude + 0.002f, start.longitude - 0.003f};
+		GeoPoint away = {start.latitude * 0.5f + 10, start.longitude * 0.5f - 20};
+		points.push_back(near);
+		points.push_back(away);
+	}
+	printf("trackIndex: %u tracks, %u lookups, %u passes\n", (unsigned int)tracks.size(),
+			(unsigned int)points.size(), BENCHMARK_PASSES);
+
+	vector<TrackIndexEntry> entries(tracks.size());
+	TrackIndex index;
+	double start = benchmarkSeconds();
+	track_index_build(&index, &tracks[0], tracks.size(), &entries[0]);
+	printf("trackIndex: built in %.1f us\n", (benchmarkSeconds() - start) * 1e6);
+
+	size_t found = 0;
+	start = benchmarkSeconds();
+	for (size_t pass = 0; pass < BENCHMARK_PASSES; pass++){
+		for (size_t i = 0; i < points.size(); i++){
+			const GeoProjection proj = createGeoProjection(&points[i]);
+			float dist = MAX_DIST_FROM_SF * MAX_DIST_FROM_SF;
+			const Track *best = NULL;
+			for (size_t t = 0; t < tracks.size(); t++){
+				GeoPoint startPoint = getStartPoint(&tracks[t]);
+				float trackDistance = distSquaredProjected(&proj, &startPoint, &points[i]);
+				if (trackDistance >= dist) continue;
+				dist = trackDistance;
+				best = &tracks[t];
+			}
+			found += best != NULL;
+		}
+	}
+	benchmarkReport("linear scan", points.size() * BENCHMARK_PASSES, benchmarkSeconds() - start, "lookups");
+
+	size_t indexFound = 0;
+	start = benchmarkSeconds();
+	for (size_t pass = 0; pass < BENCHMARK_PASSES; pass++){
+		for (size_t i = 0; i < points.size(); i++){
+			indexFound += track_index_find_closest(&index, points[i], MAX_DIST_FROM_SF) != NULL;
+		}
+	}
+	benchmarkReport("track_index_find_closest", points.size() * BENCHMARK_PASSES, benchmarkSeconds() - start, "lookups");
+	if (found != indexFound) printf("trackIndex: %u lookups disagree\n", (unsigned int)(found > indexFound ? found - indexFound : indexFound - found));
+}
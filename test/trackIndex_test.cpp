@@ -0,0 +1,146 @@
+/*
+ * trackIndex_test.cpp
+ */
+#include "trackIndex_test.h"
+#include "trackPoints.h"
+#include "auto_track.h"
+#include "geopoint.h"
+#include "trackIndex.h"
+#include "tracks.h"
+#include "mod_string.h"
+#include <vector>
+
+using std::vector;
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( TrackIndexTest );
+
+/* the same scan as findClosestTrack, over any number of tracks */
+static const Track * linearScan(const vector<Track> &tracks, const GeoPoint location){
+	const GeoProjection proj = createGeoProjection(&location);
+	float dist = MAX_DIST_FROM_SF * MAX_DIST_FROM_SF;
+	const Track *best = NULL;
+	for (size_t i = 0; i < tracks.size(); i++){
+		GeoPoint startPoint = getStartPoint(&tracks[i]);
+		float trackDistance = distSquaredProjected(&proj, &startPoint, &location);
+		if (trackDistance >= dist) continue;
+		dist = trackDistance;
+		best = &tracks[i];
+	}
+	return best;
+}
+
+/* start points nudged around up to about 1.5km, plus points spread over the globe */
+static vector<GeoPoint> queryPoints(const vector<Track> &tracks){
+	vector<GeoPoint> points;
+	const float offsets[] = {0, 0.0004f, -0.0031f, 0.0089f, -0.0092f, 0.013f};
+	for (size_t i = 0; i < tracks.size(); i++){
+		const GeoPoint start = getStartPoint(&tracks[i]);
+		for (size_t a = 0; a < sizeof(offsets) / sizeof(offsets[0]); a++){
+			for (size_t b = 0; b < sizeof(offsets) / sizeof(offsets[0]); b += 2){
+				GeoPoint p = {start.latitude + offsets[a], start.longitude + offsets[b] * 1.7f};
+				points.push_back(p);
+			}
+		}
+	}
+	unsigned int seed = 12345;
+	for (size_t i = 0; i < 2000; i++){
+		seed = seed * 1103515245 + 12345;
+		float latitude = (seed >> 8) % 17000 / 100.0f - 85;
+		seed = seed * 1103515245 + 12345;
+		float longitude = (seed >> 8) % 36000 / 100.0f - 180;
+		GeoPoint p = {latitude, longitude};
+		points.push_back(p);
+	}
+	return points;
+}
+
+void TrackIndexTest::setUp()
+{
+}
+
+void TrackIndexTest::tearDown()
+{
+	flash_default_tracks();
+}
+
+void TrackIndexTest::testSkipsInvalidStartPoints()
+{
+	Track tracks[3];
+	memset(tracks, 0, sizeof(tracks));
+	tracks[0].circuit.startFinish.latitude = 47.254723f;
+	tracks[0].circuit.startFinish.longitude = -123.191002f;
+	tracks[2].circuit.startFinish.latitude = 47.255f;
+	tracks[2].circuit.startFinish.longitude = -123.191f;
+
+	TrackIndexEntry entries[3];
+	TrackIndex index;
+	track_index_build(&index, tracks, 3, entries);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, index.count);
+
+	GeoPoint near = {47.2551f, -123.1911f};
+	CPPUNIT_ASSERT(tracks + 2 == track_index_find_closest(&index, near, MAX_DIST_FROM_SF));
+
+	GeoPoint far = {47.3f, -123.191f};
+	CPPUNIT_ASSERT(NULL == track_index_find_closest(&index, far, MAX_DIST_FROM_SF));
+}
+
+void TrackIndexTest::testMatchesLinearScanOverTrackData()
+{
+	vector<Track> tracks = loadTrackPoints();
+	CPPUNIT_ASSERT(tracks.size() > 600);
+
+	vector<TrackIndexEntry> entries(tracks.size());
+	TrackIndex index;
+	track_index_build(&index, &tracks[0], tracks.size(), &entries[0]);
+
+	vector<GeoPoint> points = queryPoints(tracks);
+	size_t found = 0;
+	for (size_t i = 0; i < points.size(); i++){
+		const Track *expected = linearScan(tracks, points[i]);
+		CPPUNIT_ASSERT(expected == track_index_find_closest(&index, points[i], MAX_DIST_FROM_SF));
+		if (expected) found++;
+	}
+	// both near and far lookups are covered
+	CPPUNIT_ASSERT(found > points.size() / 4);
+	CPPUNIT_ASSERT(found < points.size());
+}
+
+void TrackIndexTest::testMatchesFindClosestTrack()
+{
+	vector<Track> all = loadTrackPoints();
+	Tracks tracks;
+	memset(&tracks, 0, sizeof(tracks));
+	tracks.count = MAX_TRACK_COUNT;
+	for (size_t i = 0; i < MAX_TRACK_COUNT; i++){
+		tracks.tracks[i] = all[i * all.size() / MAX_TRACK_COUNT];
+	}
+
+	TrackIndexEntry entries[MAX_TRACK_COUNT];
+	TrackIndex index;
+	track_index_build(&index, tracks.tracks, tracks.count, entries);
+
+	vector<Track> subset(tracks.tracks, tracks.tracks + MAX_TRACK_COUNT);
+	vector<GeoPoint> points = queryPoints(subset);
+	for (size_t i = 0; i < points.size(); i++){
+		CPPUNIT_ASSERT(findClosestTrack(&tracks, points[i]) ==
+				track_index_find_closest(&index, points[i], MAX_DIST_FROM_SF));
+	}
+}
+
+void TrackIndexTest::testFlashedTracksAreIndexed()
+{
+	Tracks tracks;
+	memset(&tracks, 0, sizeof(tracks));
+	tracks.magicInit = MAGIC_NUMBER_TRACKS_INIT;
+	tracks.count = 1;
+	tracks.tracks[0].circuit.startFinish.latitude = -34.930361f;
+	tracks.tracks[0].circuit.startFinish.longitude = 138.6205f;
+	flash_tracks(&tracks, sizeof(tracks));
+
+	GeoPoint adelaide = {-34.9305f, 138.6206f};
+	CPPUNIT_ASSERT(get_tracks()->tracks == track_index_find_closest(get_track_index(), adelaide, MAX_DIST_FROM_SF));
+
+	flash_default_tracks();
+	CPPUNIT_ASSERT(NULL == track_index_find_closest(get_track_index(), adelaide, MAX_DIST_FROM_SF));
+}
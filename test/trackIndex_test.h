@@ -0,0 +1,29 @@
+/*
+ * trackIndex_test.h
+ */
+
+#ifndef TRACKINDEX_TEST_H_
+#define TRACKINDEX_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class TrackIndexTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE( TrackIndexTest );
+  CPPUNIT_TEST( testSkipsInvalidStartPoints );
+  CPPUNIT_TEST( testMatchesLinearScanOverTrackData );
+  CPPUNIT_TEST( testMatchesFindClosestTrack );
+  CPPUNIT_TEST( testFlashedTracksAreIndexed );
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+  void testSkipsInvalidStartPoints();
+  void testMatchesLinearScanOverTrackData();
+  void testMatchesFindClosestTrack();
+  void testFlashedTracksAreIndexed();
+};
+
+#endif /* TRACKINDEX_TEST_H_ */
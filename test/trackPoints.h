@@ -0,0 +1,49 @@
+/*
+ * trackPoints.h
+ *
+ * Loads the start/finish points in data/start_finish_points as circuit
+ * tracks, for checking and timing track lookup against a realistic set.
+ */
+
+#ifndef TRACKPOINTS_H_
+#define TRACKPOINTS_H_
+
+#include "tracks.h"
+#include "mod_string.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static inline void loadTrackPointFile(const char *name, std::vector<Track> &tracks){
+	const std::string dirs[] = {"../data/start_finish_points/", "data/start_finish_points/"};
+	std::ifstream in;
+	for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]) && !in.is_open(); i++){
+		in.open((dirs[i] + name).c_str());
+	}
+	std::string line;
+	getline(in, line); //header
+	while (getline(in, line)){
+		std::istringstream fields(line);
+		std::string type;
+		double latitude, longitude;
+		if (!(fields >> type >> latitude >> longitude)) continue;
+
+		Track track;
+		memset(&track, 0, sizeof(track));
+		track.track_type = TRACK_TYPE_CIRCUIT;
+		track.circuit.startFinish.latitude = (float)latitude;
+		track.circuit.startFinish.longitude = (float)longitude;
+		tracks.push_back(track);
+	}
+}
+
+/* every track in the circuit and kart track data sets */
+static inline std::vector<Track> loadTrackPoints(){
+	std::vector<Track> tracks;
+	loadTrackPointFile("sf_data.csv", tracks);
+	loadTrackPointFile("sf_big_track_data.csv", tracks);
+	return tracks;
+}
+
+#endif /* TRACKPOINTS_H_ */
@@ -69,3 +69,29 @@ void VirtualChannelTest::testSetChannelValue(void){
 	float value = get_virtual_channel_value(id);
 	CPPUNIT_ASSERT_EQUAL((float)1234.56, (float)value);
 }
+
+void VirtualChannelTest::testFindChannel(void){
+	char label[10];
+
+	for (size_t i = 0; i < MAX_VIRTUAL_CHANNELS; i++){
+		ChannelConfig cc = {"","Units", 1.0f, 10.0f, SAMPLE_10Hz, 3};
+		strcpy(cc.label, "CH_");
+		modp_itoa10(i, cc.label + 3);
+		create_virtual_channel(cc);
+	}
+
+	for (size_t i = 0; i < MAX_VIRTUAL_CHANNELS; i++){
+		strcpy(label, "CH_");
+		modp_itoa10(i, label + 3);
+		CPPUNIT_ASSERT_EQUAL((int)i, find_virtual_channel(label));
+	}
+	CPPUNIT_ASSERT_EQUAL(INVALID_VIRTUAL_CHANNEL, find_virtual_channel("Missing"));
+	CPPUNIT_ASSERT_EQUAL(INVALID_VIRTUAL_CHANNEL, find_virtual_channel(""));
+
+	//names are forgotten along with the channels
+	reset_virtual_channels();
+	CPPUNIT_ASSERT_EQUAL(INVALID_VIRTUAL_CHANNEL, find_virtual_channel("CH_0"));
+	ChannelConfig cc = {"CH_5","Units", 1.0f, 10.0f, SAMPLE_10Hz, 3};
+	CPPUNIT_ASSERT_EQUAL(0, create_virtual_channel(cc));
+	CPPUNIT_ASSERT_EQUAL(0, find_virtual_channel("CH_5"));
+}
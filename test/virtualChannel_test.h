@@ -17,6 +17,7 @@ class VirtualChannelTest : public CppUnit::TestFixture
   CPPUNIT_TEST( testAddDuplicateChannel );
   CPPUNIT_TEST( testAddChannelOverflow );
   CPPUNIT_TEST( testSetChannelValue );
+  CPPUNIT_TEST( testFindChannel );
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -27,6 +28,7 @@ public:
   void testAddDuplicateChannel(void);
   void testAddChannelOverflow(void);
   void testSetChannelValue(void);
+  void testFindChannel(void);
 
 };
 
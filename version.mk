@@ -1,4 +1,4 @@
 MAJOR=2
-MINOR=7
-BUGFIX=9
+MINOR=8
+BUGFIX=0
 